@@ -0,0 +1,265 @@
+#include "checksumcopy.hpp"
+#include "memkernel.hpp"
+#include "mymemcpy.hpp"
+
+#include <array>
+#include <string.h>
+
+namespace {
+
+// ---------------- CRC32C ----------------
+
+constexpr uint32_t kCrc32cPoly = 0x82F63B78; // 反射形式的 Castagnoli 多项式
+
+constexpr auto makeCrc32cTable() -> std::array<uint32_t, 256>
+{
+    std::array<uint32_t, 256> table{};
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t c = i;
+        for (int bit = 0; bit < 8; ++bit) {
+            c = (c & 1) ? (c >> 1) ^ kCrc32cPoly : c >> 1;
+        }
+        table[i] = c;
+    }
+    return table;
+}
+
+constexpr auto kCrc32cTable = makeCrc32cTable();
+
+uint32_t crc32cSoftware(const unsigned char *p, size_t n, uint32_t crc)
+{
+    while (n-- > 0) {
+        crc = kCrc32cTable[(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+// 查表版本没有寄存器级融合的余地：按块拷贝后立即从仍在 L1 中的目标计算，
+// 源数据同样只从内存读一遍
+constexpr size_t kFuseChunk = 4096;
+
+uint32_t copyCrc32cSoftware(unsigned char *d, const unsigned char *s, size_t n, uint32_t crc)
+{
+    while (n > 0) {
+        const size_t chunk = n < kFuseChunk ? n : kFuseChunk;
+        my_memcpy(d, s, chunk);
+        crc = crc32cSoftware(d, chunk, crc);
+        d += chunk;
+        s += chunk;
+        n -= chunk;
+    }
+    return crc;
+}
+
+bool hardwareCrc32c()
+{
+#ifdef MYMEMCPY_X86_SIMD
+    static const bool supported = cpuFeatures().sse42;
+    return supported;
+#else
+    return false;
+#endif
+}
+
+// 由 my_memcpy_crc32c_impl/my_crc32c_impl 返回，负责空指针检查与首尾取反
+void *memcpyCrc32cSoftware(void *dest, const void *src, size_t n, uint32_t *crc)
+{
+    if (dest != NULL && src != NULL && crc != NULL) {
+        *crc = ~copyCrc32cSoftware(static_cast<unsigned char *>(dest),
+                                   static_cast<const unsigned char *>(src),
+                                   n,
+                                   ~*crc);
+    }
+    return dest;
+}
+
+uint32_t checksumCrc32cSoftware(const void *data, size_t n, uint32_t crc)
+{
+    return data != NULL ? ~crc32cSoftware(static_cast<const unsigned char *>(data), n, ~crc) : crc;
+}
+
+#ifdef MYMEMCPY_X86_SIMD
+void *memcpyCrc32cHardware(void *dest, const void *src, size_t n, uint32_t *crc)
+{
+    if (dest != NULL && src != NULL && crc != NULL) {
+        *crc = ~MemKernel::copyCrc32cSse42(dest, src, n, ~*crc);
+    }
+    return dest;
+}
+
+uint32_t checksumCrc32cHardware(const void *data, size_t n, uint32_t crc)
+{
+    return data != NULL ? ~MemKernel::crc32cSse42(data, n, ~crc) : crc;
+}
+#endif
+
+// ---------------- XXH64 ----------------
+
+constexpr uint64_t kPrime1 = 0x9E3779B185EBCA87ULL;
+constexpr uint64_t kPrime2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr uint64_t kPrime3 = 0x165667B19E3779F9ULL;
+constexpr uint64_t kPrime4 = 0x85EBCA77C2B2AE63ULL;
+constexpr uint64_t kPrime5 = 0x27D4EB2F165667C5ULL;
+
+inline uint64_t rotl(uint64_t x, int r)
+{
+    return (x << r) | (x >> (64 - r));
+}
+
+inline uint64_t read64(const unsigned char *p)
+{
+    uint64_t v;
+    memcpy(&v, p, 8);
+    return v; // x86/ARM 均为小端序，与 XXH64 的定义一致
+}
+
+inline uint32_t read32(const unsigned char *p)
+{
+    uint32_t v;
+    memcpy(&v, p, 4);
+    return v;
+}
+
+inline uint64_t round(uint64_t acc, uint64_t input)
+{
+    acc += input * kPrime2;
+    acc = rotl(acc, 31);
+    return acc * kPrime1;
+}
+
+inline uint64_t mergeRound(uint64_t acc, uint64_t value)
+{
+    acc ^= round(0, value);
+    return acc * kPrime1 + kPrime4;
+}
+
+// 主循环每次读入 32 字节到四个寄存器，Copy 为 true 时同时写入目标
+template<bool Copy>
+uint64_t hash64Kernel(unsigned char *d, const unsigned char *s, size_t n, uint64_t seed)
+{
+    const size_t length = n;
+    uint64_t h;
+
+    if (n >= 32) {
+        uint64_t v1 = seed + kPrime1 + kPrime2;
+        uint64_t v2 = seed + kPrime2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - kPrime1;
+        do {
+            const uint64_t w0 = read64(s);
+            const uint64_t w1 = read64(s + 8);
+            const uint64_t w2 = read64(s + 16);
+            const uint64_t w3 = read64(s + 24);
+            if constexpr (Copy) {
+                memcpy(d, &w0, 8);
+                memcpy(d + 8, &w1, 8);
+                memcpy(d + 16, &w2, 8);
+                memcpy(d + 24, &w3, 8);
+                d += 32;
+            }
+            v1 = round(v1, w0);
+            v2 = round(v2, w1);
+            v3 = round(v3, w2);
+            v4 = round(v4, w3);
+            s += 32;
+            n -= 32;
+        } while (n >= 32);
+
+        h = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+        h = mergeRound(h, v1);
+        h = mergeRound(h, v2);
+        h = mergeRound(h, v3);
+        h = mergeRound(h, v4);
+    } else {
+        h = seed + kPrime5;
+    }
+
+    h += length;
+    if constexpr (Copy) {
+        my_memcpy(d, s, n);
+    }
+    while (n >= 8) {
+        h ^= round(0, read64(s));
+        h = rotl(h, 27) * kPrime1 + kPrime4;
+        s += 8;
+        n -= 8;
+    }
+    if (n >= 4) {
+        h ^= static_cast<uint64_t>(read32(s)) * kPrime1;
+        h = rotl(h, 23) * kPrime2 + kPrime3;
+        s += 4;
+        n -= 4;
+    }
+    while (n-- > 0) {
+        h ^= *s++ * kPrime5;
+        h = rotl(h, 11) * kPrime1;
+    }
+
+    // 雪崩混合
+    h ^= h >> 33;
+    h *= kPrime2;
+    h ^= h >> 29;
+    h *= kPrime3;
+    h ^= h >> 32;
+    return h;
+}
+
+} // namespace
+
+void *my_memcpy_crc32c(void *dest, const void *src, size_t n, uint32_t *crc)
+{
+    static const Crc32cCopyFunc impl = my_memcpy_crc32c_impl(hardwareCrc32c());
+    return impl(dest, src, n, crc);
+}
+
+uint32_t my_crc32c(const void *data, size_t n, uint32_t crc)
+{
+    static const Crc32cFunc impl = my_crc32c_impl(hardwareCrc32c());
+    return impl(data, n, crc);
+}
+
+Crc32cCopyFunc my_memcpy_crc32c_impl(bool hardware)
+{
+    if (!hardware) {
+        return memcpyCrc32cSoftware;
+    }
+#ifdef MYMEMCPY_X86_SIMD
+    return hardwareCrc32c() ? memcpyCrc32cHardware : NULL;
+#else
+    return NULL;
+#endif
+}
+
+Crc32cFunc my_crc32c_impl(bool hardware)
+{
+    if (!hardware) {
+        return checksumCrc32cSoftware;
+    }
+#ifdef MYMEMCPY_X86_SIMD
+    return hardwareCrc32c() ? checksumCrc32cHardware : NULL;
+#else
+    return NULL;
+#endif
+}
+
+void *my_memcpy_hash64(void *dest, const void *src, size_t n, uint64_t *hash, uint64_t seed)
+{
+    if (dest == NULL || src == NULL || hash == NULL) {
+        return dest;
+    }
+
+    *hash = hash64Kernel<true>(static_cast<unsigned char *>(dest),
+                               static_cast<const unsigned char *>(src),
+                               n,
+                               seed);
+    return dest;
+}
+
+uint64_t my_hash64(const void *data, size_t n, uint64_t seed)
+{
+    if (data == NULL) {
+        n = 0;
+        data = "";
+    }
+    return hash64Kernel<false>(nullptr, static_cast<const unsigned char *>(data), n, seed);
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// 拷贝的同时计算校验和，源数据只读一遍，避免先拷贝再校验造成的双倍内存流量。
+// 源和目标不能重叠
+
+// CRC32C（Castagnoli）。*crc 传入之前各段的结果（首段为 0），返回时更新为包含本段的值，
+// 因此可以分段累加；CPU 支持 SSE4.2 时使用 crc32 指令，否则查表
+void *my_memcpy_crc32c(void *dest, const void *src, size_t n, uint32_t *crc);
+
+// 64 位非加密哈希（XXH64 算法，结果与 xxHash 的 XXH64 一致），写入 *hash
+void *my_memcpy_hash64(void *dest, const void *src, size_t n, uint64_t *hash, uint64_t seed = 0);
+
+// 只计算不拷贝的版本，用于校验接收到的数据
+uint32_t my_crc32c(const void *data, size_t n, uint32_t crc = 0);
+uint64_t my_hash64(const void *data, size_t n, uint64_t seed = 0);
+
+using Crc32cCopyFunc = void *(*) (void *dest, const void *src, size_t n, uint32_t *crc);
+using Crc32cFunc = uint32_t (*)(const void *data, size_t n, uint32_t crc);
+
+// 获取指定的 CRC32C 实现，参数与上面的入口函数相同：hardware 为 false 时为查表实现，
+// 为 true 时为 SSE4.2 crc32 指令实现，构建或 CPU 不支持时返回 NULL
+Crc32cCopyFunc my_memcpy_crc32c_impl(bool hardware);
+Crc32cFunc my_crc32c_impl(bool hardware);
@@ -0,0 +1,80 @@
+#include "memkernel.hpp"
+
+#include <nmmintrin.h>
+#include <string.h>
+
+namespace {
+
+// 每次读入 8 字节：同一个寄存器值送入 crc32 指令，Copy 为 true 时同时写入目标
+template<bool Copy>
+uint32_t crc32cKernel(unsigned char *d, const unsigned char *s, size_t n, uint32_t crc)
+{
+#if defined(__x86_64__) || defined(_M_X64)
+    uint64_t c = crc;
+    while (n >= 32) {
+        uint64_t w0, w1, w2, w3;
+        memcpy(&w0, s, 8);
+        memcpy(&w1, s + 8, 8);
+        memcpy(&w2, s + 16, 8);
+        memcpy(&w3, s + 24, 8);
+        if constexpr (Copy) {
+            memcpy(d, &w0, 8);
+            memcpy(d + 8, &w1, 8);
+            memcpy(d + 16, &w2, 8);
+            memcpy(d + 24, &w3, 8);
+            d += 32;
+        }
+        c = _mm_crc32_u64(c, w0);
+        c = _mm_crc32_u64(c, w1);
+        c = _mm_crc32_u64(c, w2);
+        c = _mm_crc32_u64(c, w3);
+        s += 32;
+        n -= 32;
+    }
+    while (n >= 8) {
+        uint64_t w;
+        memcpy(&w, s, 8);
+        if constexpr (Copy) {
+            memcpy(d, &w, 8);
+            d += 8;
+        }
+        c = _mm_crc32_u64(c, w);
+        s += 8;
+        n -= 8;
+    }
+    crc = static_cast<uint32_t>(c);
+#endif
+    while (n >= 4) {
+        uint32_t w;
+        memcpy(&w, s, 4);
+        if constexpr (Copy) {
+            memcpy(d, &w, 4);
+            d += 4;
+        }
+        crc = _mm_crc32_u32(crc, w);
+        s += 4;
+        n -= 4;
+    }
+    while (n-- > 0) {
+        if constexpr (Copy) {
+            *d++ = *s;
+        }
+        crc = _mm_crc32_u8(crc, *s++);
+    }
+    return crc;
+}
+
+} // namespace
+
+uint32_t MemKernel::copyCrc32cSse42(void *dest, const void *src, size_t n, uint32_t crc)
+{
+    return crc32cKernel<true>(static_cast<unsigned char *>(dest),
+                              static_cast<const unsigned char *>(src),
+                              n,
+                              crc);
+}
+
+uint32_t MemKernel::crc32cSse42(const void *data, size_t n, uint32_t crc)
+{
+    return crc32cKernel<false>(nullptr, static_cast<const unsigned char *>(data), n, crc);
+}
@@ -0,0 +1,178 @@
+#include "cpufeatures.hpp"
+
+#include <initializer_list>
+#include <stdint.h>
+#include <string.h>
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define CPUFEATURES_X86 1
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace {
+
+#ifdef CPUFEATURES_X86
+
+void cpuid(unsigned leaf, unsigned subleaf, unsigned regs[4])
+{
+#ifdef _MSC_VER
+    int result[4];
+    __cpuidex(result, static_cast<int>(leaf), static_cast<int>(subleaf));
+    for (int i = 0; i < 4; ++i) {
+        regs[i] = static_cast<unsigned>(result[i]);
+    }
+#else
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+uint64_t xgetbv0()
+{
+#ifdef _MSC_VER
+    return _xgetbv(0);
+#else
+    uint32_t eax = 0;
+    uint32_t edx = 0;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (static_cast<uint64_t>(edx) << 32) | eax;
+#endif
+}
+
+// 通过确定性缓存参数叶（Intel 为 4，AMD 为 0x8000001D）找到 L3 缓存
+void detectL3Cache(CpuFeatures &features, unsigned leaf)
+{
+    unsigned regs[4] = {0};
+    for (unsigned index = 0; index < 16; ++index) {
+        cpuid(leaf, index, regs);
+        const unsigned type = regs[0] & 0x1F;
+        if (type == 0) {
+            break;
+        }
+        const unsigned level = (regs[0] >> 5) & 0x7;
+        if (level != 3 || (type != 1 && type != 3)) {
+            continue; // 只需要 L3 数据缓存或统一缓存
+        }
+
+        const size_t ways = ((regs[1] >> 22) & 0x3FF) + 1;
+        const size_t partitions = ((regs[1] >> 12) & 0x3FF) + 1;
+        const size_t lineSize = (regs[1] & 0xFFF) + 1;
+        const size_t sets = static_cast<size_t>(regs[2]) + 1;
+        features.l3CacheSize = ways * partitions * lineSize * sets;
+        return;
+    }
+}
+
+#endif
+
+CpuFeatures detect()
+{
+    CpuFeatures features;
+
+#ifdef CPUFEATURES_X86
+    unsigned regs[4] = {0};
+    cpuid(0, 0, regs);
+    const unsigned maxLeaf = regs[0];
+    char vendor[13] = {0};
+    memcpy(vendor, &regs[1], 4);
+    memcpy(vendor + 4, &regs[3], 4);
+    memcpy(vendor + 8, &regs[2], 4);
+    if (maxLeaf < 1) {
+        return features;
+    }
+
+    cpuid(1, 0, regs);
+    features.sse2 = (regs[3] >> 26) & 1;
+    features.sse42 = (regs[2] >> 20) & 1;
+    const bool osxsave = (regs[2] >> 27) & 1;
+    const bool avx = (regs[2] >> 28) & 1;
+
+    // 仅 CPU 支持还不够，操作系统必须在 XCR0 中开启对应寄存器状态的保存
+    bool ymmEnabled = false;
+    bool zmmEnabled = false;
+    if (osxsave) {
+        const uint64_t xcr0 = xgetbv0();
+        ymmEnabled = (xcr0 & 0x6) == 0x6;
+        zmmEnabled = (xcr0 & 0xE6) == 0xE6;
+    }
+
+    if (maxLeaf >= 7) {
+        cpuid(7, 0, regs);
+        features.avx2 = avx && ymmEnabled && ((regs[1] >> 5) & 1);
+        features.avx512f = zmmEnabled && ((regs[1] >> 16) & 1);
+        features.avx512bw = features.avx512f && ((regs[1] >> 30) & 1);
+    }
+
+    if (strcmp(vendor, "GenuineIntel") == 0 && maxLeaf >= 4) {
+        detectL3Cache(features, 4);
+    } else {
+        cpuid(0x80000000, 0, regs);
+        if (regs[0] >= 0x8000001D) {
+            detectL3Cache(features, 0x8000001D);
+        }
+    }
+#endif
+
+#if defined(__linux__) && defined(_SC_LEVEL3_CACHE_SIZE)
+    // cpuid 无法提供时退回 glibc 从 sysfs 读取的结果
+    if (features.l3CacheSize == 0) {
+        const long value = sysconf(_SC_LEVEL3_CACHE_SIZE);
+        features.l3CacheSize = value > 0 ? static_cast<size_t>(value) : 0;
+    }
+#endif
+
+    return features;
+}
+
+} // namespace
+
+const CpuFeatures &cpuFeatures()
+{
+    static const CpuFeatures features = detect();
+    return features;
+}
+
+bool cpuSupports(SimdLevel level)
+{
+#ifdef MYMEMCPY_X86_SIMD
+    const auto &features = cpuFeatures();
+    switch (level) {
+    case SimdLevel::Scalar: return true;
+    case SimdLevel::SSE2: return features.sse2;
+    case SimdLevel::AVX2: return features.avx2;
+    case SimdLevel::AVX512: return features.avx512f && features.avx512bw;
+    }
+    return false;
+#else
+    // 未编译 SIMD 内核时只有标量实现可用
+    return level == SimdLevel::Scalar;
+#endif
+}
+
+SimdLevel bestSimdLevel()
+{
+    for (auto level : {SimdLevel::AVX512, SimdLevel::AVX2, SimdLevel::SSE2}) {
+        if (cpuSupports(level)) {
+            return level;
+        }
+    }
+    return SimdLevel::Scalar;
+}
+
+const char *simdLevelName(SimdLevel level)
+{
+    switch (level) {
+    case SimdLevel::Scalar: return "scalar";
+    case SimdLevel::SSE2: return "sse2";
+    case SimdLevel::AVX2: return "avx2";
+    case SimdLevel::AVX512: return "avx512";
+    }
+    return "unknown";
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <stddef.h>
+
+// 按指令集从低到高排列，Scalar 为不依赖 SIMD 的可移植实现
+enum class SimdLevel { Scalar, SSE2, AVX2, AVX512 };
+
+struct CpuFeatures
+{
+    bool sse2 = false;
+    bool sse42 = false;
+    bool avx2 = false;     // 同时要求操作系统开启 YMM 状态保存
+    bool avx512f = false;  // 同时要求操作系统开启 ZMM 状态保存
+    bool avx512bw = false;
+
+    // 末级（L3）缓存大小（字节），无法检测时为 0
+    size_t l3CacheSize = 0;
+};
+
+// 首次调用时通过 cpuid/xgetbv 检测，之后返回缓存结果
+const CpuFeatures &cpuFeatures();
+
+// 当前 CPU 是否支持指定指令集级别
+bool cpuSupports(SimdLevel level);
+
+// 当前 CPU 支持的最高级别（同时受构建配置限制）
+SimdLevel bestSimdLevel();
+
+const char *simdLevelName(SimdLevel level);
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "mymemcpy.hpp"
+
+#include <array>
+#include <bit>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+// 长度在编译期已知的拷贝：按定长 memcpy 展开，编译器生成固定的寄存器读写序列，
+// 没有循环、没有空指针检查，也没有分派跳转。调用方保证指针有效
+
+// 不超过该长度时完全展开，更长的退回运行时分派的 my_memcpy
+constexpr size_t kFixedCopyMax = 256;
+
+// my_memcpy_small 跳转表覆盖的最大长度
+constexpr size_t kSmallCopyMax = 128;
+
+namespace MemFixed {
+
+template<size_t N>
+struct Block
+{
+    unsigned char bytes[N];
+};
+
+} // namespace MemFixed
+
+template<size_t N>
+inline void *my_memcpy(void *dest, const void *src) noexcept
+{
+    if constexpr (N == 0) {
+        return dest;
+    } else if constexpr (N > kFixedCopyMax) {
+        return my_memcpy(dest, src, N);
+    } else if constexpr (std::has_single_bit(N)) {
+        // 先整体读入再写出，源和目标重叠时结果同 memmove
+        MemFixed::Block<N> block;
+        std::memcpy(&block, src, N);
+        std::memcpy(dest, &block, N);
+        return dest;
+    } else {
+        // 其它长度拆成首尾两段重叠的 2 的幂长度拷贝，避免编译器借助栈拼接零散字节
+        constexpr size_t P = std::bit_floor(N);
+        auto *d = static_cast<unsigned char *>(dest);
+        const auto *s = static_cast<const unsigned char *>(src);
+        MemFixed::Block<P> head;
+        MemFixed::Block<P> tail;
+        std::memcpy(&head, s, P);
+        std::memcpy(&tail, s + N - P, P);
+        std::memcpy(d, &head, P);
+        std::memcpy(d + N - P, &tail, P);
+        return dest;
+    }
+}
+
+// 按元素个数拷贝可平凡复制的对象，返回目标末尾，与 std::copy_n 一致
+template<typename T>
+    requires std::is_trivially_copyable_v<T>
+inline T *my_copy_n(const T *src, size_t count, T *dest) noexcept
+{
+    my_memcpy(dest, src, count * sizeof(T));
+    return dest + count;
+}
+
+// 元素个数在编译期已知时展开为定长拷贝
+template<size_t Count, typename T>
+    requires std::is_trivially_copyable_v<T>
+inline T *my_copy_n(const T *src, T *dest) noexcept
+{
+    my_memcpy<Count * sizeof(T)>(dest, src);
+    return dest + Count;
+}
+
+namespace MemFixed {
+
+using SmallCopyFunc = void *(*) (void *dest, const void *src);
+
+template<size_t... N>
+constexpr auto makeSmallCopyTable(std::index_sequence<N...>) -> std::array<SmallCopyFunc, sizeof...(N)>
+{
+    return {&my_memcpy<N>...};
+}
+
+// 下标为长度，每一项都是完全展开的定长拷贝
+inline constexpr auto kSmallCopyTable = makeSmallCopyTable(
+    std::make_index_sequence<kSmallCopyMax + 1>{});
+
+} // namespace MemFixed
+
+// 运行时长度的小块拷贝：一次间接跳转进入对应长度的定长拷贝，n 不能超过 kSmallCopyMax。
+// 长度稳定的调用点比 my_memcpy 更快；长度随机变化时间接跳转预测失败，
+// 反而不如 SIMD 内核的分支加掩码读写，因此 my_memcpy 只在标量内核中使用它
+inline void *my_memcpy_small(void *dest, const void *src, size_t n) noexcept
+{
+    return MemFixed::kSmallCopyTable[n](dest, src);
+}
@@ -0,0 +1,387 @@
+#include "checksumcopy.hpp"
+#include "movepages.hpp"
+#include "mymemcpy.hpp"
+#include "parallelmemcpy.hpp"
+
+#include <Thread/threadpool.hpp>
+
+#include <utils/benchmarkmain.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define MEMCPY_BENCH_RDTSC 1
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#endif
+
+// 运行方式：
+//   memcpy_bench                                       # 默认输出 JSON 到 memcpy_bench.json
+//   memcpy_bench --benchmark_out=result.csv            # 以 CSV 格式输出，便于绘图
+//   memcpy_bench --benchmark_filter=Large              # 只运行大块拷贝用例
+//   memcpy_bench --benchmark_filter='Sweep/libc_memcpy/.*/hot'   # 只扫描 libc 的热缓存数据
+//   memcpy_bench --benchmark_perf_counters=CACHE-MISSES  # benchmark 启用 libpfm 时统计缓存未命中
+//
+// Sweep 用例命名为 BM_Memcpy_Sweep/<实现>/<长度>/src:<偏移>/dst:<偏移>/<hot|cold>，
+// 输出 GBps 与 cycles_per_byte（x86 上按 TSC 计数）
+
+namespace {
+
+// 流式写入开关：0 为普通存储，1 为非临时存储
+void applyStoreMode(benchmark::State &state, int64_t mode)
+{
+    my_memcpy_set_nontemporal_threshold(mode != 0 ? 1 : SIZE_MAX);
+    state.SetLabel(mode != 0 ? "nontemporal" : "temporal");
+}
+
+// 读者线程的热数据集：取 L3 的 1/4，限制在 1~64 MiB 之间
+auto hotSetSize() -> size_t
+{
+    const size_t l3 = cpuFeatures().l3CacheSize;
+    return std::clamp<size_t>(l3 / 4, 1 << 20, 64 << 20);
+}
+
+struct CopyImpl
+{
+    std::string name;
+    MemcpyFunc func;
+};
+
+void *libcMemcpy(void *dest, const void *src, size_t n)
+{
+    return memcpy(dest, src, n);
+}
+
+#if defined(__GNUC__) || defined(__clang__)
+// 长度在运行时才确定时编译器通常也会调用 libc，这里用于确认两者没有差异
+void *builtinMemcpy(void *dest, const void *src, size_t n)
+{
+    return __builtin_memcpy(dest, src, n);
+}
+#endif
+
+// 参与对比的实现：各指令集内核、分派后的 my_memcpy、libc memcpy 与 __builtin_memcpy
+auto copyImpls() -> std::vector<CopyImpl>
+{
+    std::vector<CopyImpl> impls;
+    for (auto level : {SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2, SimdLevel::AVX512}) {
+        if (MemcpyFunc func = my_memcpy_impl(level)) {
+            impls.push_back({std::string("my_memcpy_") + simdLevelName(level), func});
+        }
+    }
+    impls.push_back({"my_memcpy", &my_memcpy});
+    impls.push_back({"libc_memcpy", &libcMemcpy});
+#if defined(__GNUC__) || defined(__clang__)
+    impls.push_back({"builtin_memcpy", &builtinMemcpy});
+#endif
+    return impls;
+}
+
+// 1 B ~ 256 MiB：2 的幂，以及夹在相邻两个幂之间的奇数长度 1.5 * 2^k + 1
+auto sweepSizes() -> std::vector<size_t>
+{
+    std::vector<size_t> sizes;
+    for (size_t k = 0; k <= 28; ++k) {
+        sizes.push_back(size_t{1} << k);
+        if (k >= 1 && k <= 27) {
+            sizes.push_back((size_t{3} << (k - 1)) | 1);
+        }
+    }
+    std::sort(sizes.begin(), sizes.end());
+    sizes.erase(std::unique(sizes.begin(), sizes.end()), sizes.end());
+    return sizes;
+}
+
+auto readCycles() -> uint64_t
+{
+#ifdef MEMCPY_BENCH_RDTSC
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+// 冷缓存时轮换使用的缓冲区总大小：至少两倍 L3，保证每次拷贝的数据都已被挤出缓存
+auto coldArenaSize() -> size_t
+{
+    const size_t l3 = cpuFeatures().l3CacheSize;
+    return std::clamp<size_t>(l3 * 2, 64 << 20, 512 << 20);
+}
+
+// 所有扫描用例共用的源/目标缓冲区，首次使用时分配并写满，避免每次运行重复分配和缺页
+struct SweepArena
+{
+    static auto instance() -> SweepArena &
+    {
+        static SweepArena arena(std::max<size_t>(coldArenaSize(), (256 << 20) + 2 * 4096));
+        return arena;
+    }
+
+    explicit SweepArena(size_t size)
+        : srcBuffer(size + 64, 0x5A)
+        , destBuffer(size + 64, 0)
+        , capacity(size)
+    {}
+
+    // 64 字节对齐的基址
+    static auto aligned(std::vector<unsigned char> &buffer) -> unsigned char *
+    {
+        auto *p = buffer.data();
+        return p + ((64 - reinterpret_cast<uintptr_t>(p) % 64) % 64);
+    }
+
+    std::vector<unsigned char> srcBuffer;
+    std::vector<unsigned char> destBuffer;
+    size_t capacity;
+};
+
+// 源和目标各自从 64 字节对齐的基址偏移 srcOffset/destOffset 字节。
+// 热缓存时反复拷贝同一块数据；冷缓存时在多组缓冲区之间轮换
+void sweepCopy(benchmark::State &state,
+               MemcpyFunc func,
+               size_t size,
+               size_t srcOffset,
+               size_t destOffset,
+               bool cold)
+{
+    auto &arena = SweepArena::instance();
+    const size_t slotSize = (size + 2 * 64 + 4095) / 4096 * 4096;
+    const size_t slots = cold ? std::max<size_t>(1, coldArenaSize() / slotSize) : 1;
+    unsigned char *src = SweepArena::aligned(arena.srcBuffer) + srcOffset;
+    unsigned char *dest = SweepArena::aligned(arena.destBuffer) + destOffset;
+
+    size_t slot = 0;
+    const uint64_t startCycles = readCycles();
+    for (auto _ : state) {
+        func(dest + slot * slotSize, src + slot * slotSize, size);
+        benchmark::ClobberMemory();
+        if (++slot == slots) {
+            slot = 0;
+        }
+    }
+    const uint64_t cycles = readCycles() - startCycles;
+
+    const auto bytes = static_cast<double>(state.iterations()) * static_cast<double>(size);
+    state.SetBytesProcessed(static_cast<int64_t>(bytes));
+    state.counters["GBps"] = benchmark::Counter(bytes / 1e9, benchmark::Counter::kIsRate);
+#ifdef MEMCPY_BENCH_RDTSC
+    state.counters["cycles_per_byte"] = static_cast<double>(cycles) / bytes;
+#else
+    (void) cycles;
+#endif
+    state.counters["size"] = static_cast<double>(size);
+}
+
+// 运行时注册扫描用例：实现 x 长度 x 错位 x 冷热缓存
+void registerSweep()
+{
+    const std::pair<size_t, size_t> offsets[] = {{0, 0}, {1, 0}, {0, 1}, {7, 13}};
+    for (const auto &impl : copyImpls()) {
+        for (size_t size : sweepSizes()) {
+            for (auto [srcOffset, destOffset] : offsets) {
+                for (bool cold : {false, true}) {
+                    const std::string name = "BM_Memcpy_Sweep/" + impl.name + "/"
+                                             + std::to_string(size) + "/src:"
+                                             + std::to_string(srcOffset) + "/dst:"
+                                             + std::to_string(destOffset)
+                                             + (cold ? "/cold" : "/hot");
+                    benchmark::RegisterBenchmark(name.c_str(),
+                                                 sweepCopy,
+                                                 impl.func,
+                                                 size,
+                                                 srcOffset,
+                                                 destOffset,
+                                                 cold)
+                        ->MinTime(0.05);
+                }
+            }
+        }
+    }
+}
+
+} // namespace
+
+// 1 MiB ~ 1 GiB 大块拷贝的带宽，对比普通存储与非临时存储
+static void BM_Memcpy_Large(benchmark::State &state)
+{
+    const auto size = static_cast<size_t>(state.range(0));
+    std::vector<unsigned char> src(size, 0x5A);
+    std::vector<unsigned char> dest(size, 0);
+    applyStoreMode(state, state.range(1));
+
+    for (auto _ : state) {
+        my_memcpy(dest.data(), src.data(), size);
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+    my_memcpy_set_nontemporal_threshold(0);
+}
+BENCHMARK(BM_Memcpy_Large)
+    ->ArgsProduct({benchmark::CreateRange(1 << 20, 1 << 30, 4), {0, 1}})
+    ->Unit(benchmark::kMicrosecond);
+
+// 大块拷贝对并发读者的影响：读者线程反复扫描一块热数据，
+// 普通存储会把拷贝目标写进 L3、挤出读者的数据，reader_GBps 随之下降
+static void BM_Memcpy_ConcurrentReader(benchmark::State &state)
+{
+    const auto size = static_cast<size_t>(state.range(0));
+    std::vector<unsigned char> src(size, 0x5A);
+    std::vector<unsigned char> dest(size, 0);
+    std::vector<uint64_t> hot(hotSetSize() / sizeof(uint64_t), 1);
+    applyStoreMode(state, state.range(1));
+
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> bytesRead{0};
+    std::thread reader([&] {
+        uint64_t sum = 0;
+        while (!stop.load(std::memory_order_relaxed)) {
+            // 每个缓存行读一次
+            for (size_t i = 0; i < hot.size(); i += 64 / sizeof(uint64_t)) {
+                sum += hot[i];
+            }
+            bytesRead.fetch_add(hot.size() * sizeof(uint64_t), std::memory_order_relaxed);
+        }
+        benchmark::DoNotOptimize(sum);
+    });
+
+    const auto start = std::chrono::steady_clock::now();
+    for (auto _ : state) {
+        my_memcpy(dest.data(), src.data(), size);
+        benchmark::ClobberMemory();
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    stop = true;
+    reader.join();
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+    state.counters["reader_GBps"] = static_cast<double>(bytesRead.load()) / elapsed.count() / 1e9;
+    my_memcpy_set_nontemporal_threshold(0);
+}
+BENCHMARK(BM_Memcpy_ConcurrentReader)
+    ->ArgsProduct({benchmark::CreateRange(16 << 20, 1 << 30, 4), {0, 1}})
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
+
+// 多线程拷贝的带宽随参与线程数的变化，range(1) 为线程数（含调用线程）
+static void BM_ParallelMemcpy(benchmark::State &state)
+{
+    const auto size = static_cast<size_t>(state.range(0));
+    const auto threads = static_cast<size_t>(state.range(1));
+    std::vector<unsigned char> src(size, 0x5A);
+    std::vector<unsigned char> dest(size, 0);
+    ThreadPool pool(std::max<size_t>(threads - 1, 1));
+
+    for (auto _ : state) {
+        if (threads == 1) {
+            my_memcpy(dest.data(), src.data(), size);
+        } else {
+            parallel_memcpy(dest.data(), src.data(), size, pool);
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+    state.counters["threads"] = static_cast<double>(threads);
+}
+BENCHMARK(BM_ParallelMemcpy)
+    ->ArgsProduct({{64 << 20, 512 << 20}, {1, 2, 4, 8, 16}})
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
+
+// 边拷贝边校验与先拷贝、再从目标计算校验和的对比。
+// range(1)：0 = CRC32C 分两遍，1 = CRC32C 融合，2 = hash64 分两遍，3 = hash64 融合
+static void BM_ChecksumCopy(benchmark::State &state)
+{
+    const auto size = static_cast<size_t>(state.range(0));
+    const auto mode = state.range(1);
+    std::vector<unsigned char> src(size, 0x5A);
+    std::vector<unsigned char> dest(size, 0);
+
+    for (auto _ : state) {
+        if (mode < 2) {
+            uint32_t crc = 0;
+            if (mode == 0) {
+                my_memcpy(dest.data(), src.data(), size);
+                crc = my_crc32c(dest.data(), size);
+            } else {
+                my_memcpy_crc32c(dest.data(), src.data(), size, &crc);
+            }
+            benchmark::DoNotOptimize(crc);
+        } else {
+            uint64_t hash = 0;
+            if (mode == 2) {
+                my_memcpy(dest.data(), src.data(), size);
+                hash = my_hash64(dest.data(), size);
+            } else {
+                my_memcpy_hash64(dest.data(), src.data(), size, &hash);
+            }
+            benchmark::DoNotOptimize(hash);
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+    static const char *const labels[] = {"crc32c_two_pass",
+                                         "crc32c_fused",
+                                         "hash64_two_pass",
+                                         "hash64_fused"};
+    state.SetLabel(labels[mode]);
+}
+BENCHMARK(BM_ChecksumCopy)
+    ->ArgsProduct({benchmark::CreateRange(4 << 10, 64 << 20, 16), {0, 1, 2, 3}})
+    ->Unit(benchmark::kMicrosecond);
+
+#ifdef __linux__
+// 页面移动与逐字节拷贝的对比，range(1) 为 0 时使用 my_memcpy。
+// 每轮开始前重新写满 src（不计时），模拟每次都要交出一块新写入的缓冲区
+static void BM_MovePages(benchmark::State &state)
+{
+    const auto size = static_cast<size_t>(state.range(0));
+    const bool remap = state.range(1) != 0;
+    void *src = move_pages_alloc(size);
+    void *dest = move_pages_alloc(size);
+    if (src == NULL || dest == NULL) {
+        move_pages_free(src, size);
+        move_pages_free(dest, size);
+        state.SkipWithError("move_pages_alloc failed");
+        return;
+    }
+    memset(dest, 0, size);
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        memset(src, 0x5A, size);
+        state.ResumeTiming();
+
+        if (remap) {
+            move_pages_into(dest, src, size);
+        } else {
+            my_memcpy(dest, src, size);
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+    state.SetLabel(remap ? (move_pages_eligible(dest, src, size) ? "mremap" : "fallback")
+                         : "my_memcpy");
+    move_pages_free(src, size);
+    move_pages_free(dest, size);
+}
+BENCHMARK(BM_MovePages)
+    ->ArgsProduct({{64 << 20, 256 << 20, 1 << 30}, {0, 1}})
+    ->Unit(benchmark::kMicrosecond)
+    ->UseRealTime();
+#endif
+
+int main(int argc, char **argv)
+{
+    registerSweep();
+    return Utils::runBenchmarks(argc, argv, "memcpy_bench.json");
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+// 各指令集版本的内核，SIMD 版本分别在 memkernel_<isa>.cc 中以对应的编译选项构建。
+// 内核不检查空指针，由 my_memcpy 等入口函数负责参数检查
+namespace MemKernel {
+
+// 同一指令集级别的一组内核，入口函数按 CPU 特性选择其中一张表
+struct Table
+{
+    void *(*copy)(void *dest, const void *src, size_t n);
+    void *(*move)(void *dest, const void *src, size_t n);
+    void *(*set)(void *dest, int c, size_t n);
+    int (*compare)(const void *lhs, const void *rhs, size_t n);
+};
+
+extern const Table scalarTable;
+
+#ifdef MYMEMCPY_X86_SIMD
+extern const Table sse2Table;
+extern const Table avx2Table;
+extern const Table avx512Table;
+
+// 累加 CRC32C（SSE4.2 crc32 指令），crc 为未取反的中间状态
+uint32_t copyCrc32cSse42(void *dest, const void *src, size_t n, uint32_t crc);
+uint32_t crc32cSse42(const void *data, size_t n, uint32_t crc);
+#endif
+
+// 不小于该长度的拷贝/填充改用非临时存储，绕过缓存直接写内存。
+// 由 mymemcpy.cc 动态初始化，初始化之前为 0，表示不启用
+extern std::atomic<size_t> nontemporalThreshold;
+
+} // namespace MemKernel
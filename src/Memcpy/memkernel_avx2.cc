@@ -0,0 +1,33 @@
+#include "memkernel_simd.hpp"
+
+namespace {
+
+struct Avx2
+{
+    using Reg = __m256i;
+    static constexpr size_t kWidth = 32;
+
+    static Reg loadu(const void *p)
+    {
+        return _mm256_loadu_si256(static_cast<const __m256i *>(p));
+    }
+    static void storeu(void *p, Reg v) { _mm256_storeu_si256(static_cast<__m256i *>(p), v); }
+    static void store(void *p, Reg v) { _mm256_store_si256(static_cast<__m256i *>(p), v); }
+    static void stream(void *p, Reg v) { _mm256_stream_si256(static_cast<__m256i *>(p), v); }
+    static Reg set1(unsigned char c) { return _mm256_set1_epi8(static_cast<char>(c)); }
+    static uint64_t diffMask(Reg a, Reg b)
+    {
+        return static_cast<uint32_t>(~_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b)));
+    }
+
+    static void copyShort(unsigned char *d, const unsigned char *s, size_t n) { copySmall(d, s, n); }
+    static void setShort(unsigned char *d, unsigned char c, size_t n) { setSmall(d, c, n); }
+    static int compareShort(const unsigned char *a, const unsigned char *b, size_t n)
+    {
+        return compareSmall(a, b, n);
+    }
+};
+
+} // namespace
+
+const MemKernel::Table MemKernel::avx2Table = makeTable<Avx2>();
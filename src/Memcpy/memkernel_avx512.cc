@@ -0,0 +1,40 @@
+#include "memkernel_simd.hpp"
+
+namespace {
+
+struct Avx512
+{
+    using Reg = __m512i;
+    static constexpr size_t kWidth = 64;
+
+    static Reg loadu(const void *p) { return _mm512_loadu_si512(p); }
+    static void storeu(void *p, Reg v) { _mm512_storeu_si512(p, v); }
+    static void store(void *p, Reg v) { _mm512_store_si512(p, v); }
+    static void stream(void *p, Reg v) { _mm512_stream_si512(static_cast<__m512i *>(p), v); }
+    static Reg set1(unsigned char c) { return _mm512_set1_epi8(static_cast<char>(c)); }
+    static uint64_t diffMask(Reg a, Reg b) { return _mm512_cmpneq_epi8_mask(a, b); }
+
+    // 不足一个向量时用字节掩码读写，被屏蔽的字节不会访问内存
+    static __mmask64 tailMask(size_t n) { return static_cast<__mmask64>((1ULL << n) - 1); }
+    static void copyShort(unsigned char *d, const unsigned char *s, size_t n)
+    {
+        const __mmask64 mask = tailMask(n);
+        _mm512_mask_storeu_epi8(d, mask, _mm512_maskz_loadu_epi8(mask, s));
+    }
+    static void setShort(unsigned char *d, unsigned char c, size_t n)
+    {
+        _mm512_mask_storeu_epi8(d, tailMask(n), set1(c));
+    }
+    static int compareShort(const unsigned char *a, const unsigned char *b, size_t n)
+    {
+        const __mmask64 mask = tailMask(n);
+        const uint64_t diff = _mm512_mask_cmpneq_epi8_mask(mask,
+                                                           _mm512_maskz_loadu_epi8(mask, a),
+                                                           _mm512_maskz_loadu_epi8(mask, b));
+        return diff != 0 ? byteDiff(a, b, firstSetBit(diff)) : 0;
+    }
+};
+
+} // namespace
+
+const MemKernel::Table MemKernel::avx512Table = makeTable<Avx512>();
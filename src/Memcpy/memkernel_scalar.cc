@@ -0,0 +1,110 @@
+#include "fixedmemcpy.hpp"
+#include "memkernel.hpp"
+
+#include <stdint.h>
+#include <string.h>
+
+// 不依赖任何 SIMD 指令的可移植实现，按机器字处理，剩余不足一个字的部分逐字节处理
+
+namespace {
+
+constexpr size_t kWord = sizeof(uintptr_t);
+
+void *copyForward(void *dest, const void *src, size_t n)
+{
+    // 小块拷贝经跳转表进入完全展开的定长版本，不走循环
+    if (n <= kSmallCopyMax) {
+        return my_memcpy_small(dest, src, n);
+    }
+
+    auto *d = static_cast<unsigned char *>(dest);
+    const auto *s = static_cast<const unsigned char *>(src);
+
+    while (n >= kWord) {
+        uintptr_t word;
+        memcpy(&word, s, kWord);
+        memcpy(d, &word, kWord);
+        d += kWord;
+        s += kWord;
+        n -= kWord;
+    }
+    while (n-- > 0) {
+        *d++ = *s++;
+    }
+    return dest;
+}
+
+void *copyBackward(void *dest, const void *src, size_t n)
+{
+    auto *d = static_cast<unsigned char *>(dest) + n;
+    const auto *s = static_cast<const unsigned char *>(src) + n;
+
+    while (n >= kWord) {
+        d -= kWord;
+        s -= kWord;
+        n -= kWord;
+        uintptr_t word;
+        memcpy(&word, s, kWord);
+        memcpy(d, &word, kWord);
+    }
+    while (n-- > 0) {
+        *--d = *--s;
+    }
+    return dest;
+}
+
+void *moveBytes(void *dest, const void *src, size_t n)
+{
+    const auto d = reinterpret_cast<uintptr_t>(dest);
+    const auto s = reinterpret_cast<uintptr_t>(src);
+    if (d > s && d - s < n) {
+        return copyBackward(dest, src, n);
+    }
+    return copyForward(dest, src, n);
+}
+
+void *fill(void *dest, int c, size_t n)
+{
+    auto *d = static_cast<unsigned char *>(dest);
+    const auto byte = static_cast<unsigned char>(c);
+    const uintptr_t word = static_cast<uintptr_t>(-1) / 0xFF * byte;
+
+    while (n >= kWord) {
+        memcpy(d, &word, kWord);
+        d += kWord;
+        n -= kWord;
+    }
+    while (n-- > 0) {
+        *d++ = byte;
+    }
+    return dest;
+}
+
+int compare(const void *lhs, const void *rhs, size_t n)
+{
+    const auto *a = static_cast<const unsigned char *>(lhs);
+    const auto *b = static_cast<const unsigned char *>(rhs);
+
+    // 整字相等时直接跳过，不同时再逐字节定位，不依赖字节序
+    while (n >= kWord) {
+        uintptr_t x, y;
+        memcpy(&x, a, kWord);
+        memcpy(&y, b, kWord);
+        if (x != y) {
+            break;
+        }
+        a += kWord;
+        b += kWord;
+        n -= kWord;
+    }
+    for (size_t i = 0; i < n; i++) {
+        if (a[i] != b[i]) {
+            return static_cast<int>(a[i]) - static_cast<int>(b[i]);
+        }
+    }
+    return 0;
+}
+
+} // namespace
+
+const MemKernel::Table MemKernel::scalarTable = {&copyForward, &moveBytes, &fill, &compare};
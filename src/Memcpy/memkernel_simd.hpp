@@ -0,0 +1,385 @@
+#pragma once
+
+// 与向量宽度无关的内核模板，只能被 memkernel_<isa>.cc 包含。
+// 各翻译单元使用不同的 -m 选项编译，因此全部放在匿名命名空间中，
+// 避免链接器把不同指令集的同名实例合并成一个
+
+#include "memkernel.hpp"
+
+#include <immintrin.h>
+#include <initializer_list>
+#include <stdint.h>
+#include <string.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace {
+
+// 流式拷贝时提前预取的距离，覆盖内存延迟且不超出硬件预取器的跟踪范围
+constexpr size_t kPrefetchDistance = 512;
+
+// 最低位的 1 所在的位置，mask 不能为 0
+inline unsigned firstSetBit(uint64_t mask)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index = 0;
+#ifdef _WIN64
+    _BitScanForward64(&index, mask);
+#else
+    if (_BitScanForward(&index, static_cast<unsigned long>(mask)) == 0) {
+        _BitScanForward(&index, static_cast<unsigned long>(mask >> 32));
+        index += 32;
+    }
+#endif
+    return index;
+#else
+    return static_cast<unsigned>(__builtin_ctzll(mask));
+#endif
+}
+
+inline int byteDiff(const unsigned char *a, const unsigned char *b, size_t index)
+{
+    return static_cast<int>(a[index]) - static_cast<int>(b[index]);
+}
+
+inline bool streaming(size_t n)
+{
+    const size_t threshold = MemKernel::nontemporalThreshold.load(std::memory_order_relaxed);
+    return threshold != 0 && n >= threshold;
+}
+
+// n <= 32 的拷贝：先读出首尾两段可能重叠的定长数据再写入，
+// 既避免逐字节循环，也使源和目标重叠时同样正确
+inline void copySmall(unsigned char *d, const unsigned char *s, size_t n)
+{
+    if (n >= 16) {
+        __m128i head = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s));
+        __m128i tail = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + n - 16));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(d), head);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(d + n - 16), tail);
+    } else if (n >= 8) {
+        uint64_t head, tail;
+        memcpy(&head, s, 8);
+        memcpy(&tail, s + n - 8, 8);
+        memcpy(d, &head, 8);
+        memcpy(d + n - 8, &tail, 8);
+    } else if (n >= 4) {
+        uint32_t head, tail;
+        memcpy(&head, s, 4);
+        memcpy(&tail, s + n - 4, 4);
+        memcpy(d, &head, 4);
+        memcpy(d + n - 4, &tail, 4);
+    } else if (n >= 2) {
+        uint16_t head, tail;
+        memcpy(&head, s, 2);
+        memcpy(&tail, s + n - 2, 2);
+        memcpy(d, &head, 2);
+        memcpy(d + n - 2, &tail, 2);
+    } else if (n == 1) {
+        *d = *s;
+    }
+}
+
+// n <= 32 的填充，同样使用首尾重叠写入
+inline void setSmall(unsigned char *d, unsigned char c, size_t n)
+{
+    if (n >= 16) {
+        __m128i v = _mm_set1_epi8(static_cast<char>(c));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(d), v);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(d + n - 16), v);
+    } else if (n >= 8) {
+        const uint64_t v = 0x0101010101010101ULL * c;
+        memcpy(d, &v, 8);
+        memcpy(d + n - 8, &v, 8);
+    } else if (n >= 4) {
+        const uint32_t v = 0x01010101U * c;
+        memcpy(d, &v, 4);
+        memcpy(d + n - 4, &v, 4);
+    } else if (n >= 2) {
+        const uint16_t v = static_cast<uint16_t>(0x0101U * c);
+        memcpy(d, &v, 2);
+        memcpy(d + n - 2, &v, 2);
+    } else if (n == 1) {
+        *d = c;
+    }
+}
+
+// n <= 32 的比较，x86 为小端序，异或结果最低的非零字节就是第一个不同的字节
+inline int compareSmall(const unsigned char *a, const unsigned char *b, size_t n)
+{
+    if (n >= 16) {
+        for (size_t offset : {size_t{0}, n - 16}) {
+            __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + offset));
+            __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + offset));
+            const auto mask = static_cast<uint32_t>(~_mm_movemask_epi8(_mm_cmpeq_epi8(va, vb)))
+                              & 0xFFFF;
+            if (mask != 0) {
+                return byteDiff(a, b, offset + firstSetBit(mask));
+            }
+        }
+        return 0;
+    }
+    if (n >= 8) {
+        for (size_t offset : {size_t{0}, n - 8}) {
+            uint64_t x, y;
+            memcpy(&x, a + offset, 8);
+            memcpy(&y, b + offset, 8);
+            if (x != y) {
+                return byteDiff(a, b, offset + firstSetBit(x ^ y) / 8);
+            }
+        }
+        return 0;
+    }
+    for (size_t i = 0; i < n; i++) {
+        if (a[i] != b[i]) {
+            return byteDiff(a, b, i);
+        }
+    }
+    return 0;
+}
+
+// V 为向量特征类型，需提供：
+//   Reg、kWidth、loadu/storeu/store/stream、set1、diffMask（不相等字节的位掩码），
+//   以及处理 n < kWidth 的 copyShort/setShort/compareShort
+
+// 正向拷贝。每次写入的位置都不超过已读取的源数据，因此 dest < src 的重叠也是安全的
+template<typename V>
+void *copyForward(void *dest, const void *src, size_t n)
+{
+    constexpr size_t W = V::kWidth;
+    auto *d = static_cast<unsigned char *>(dest);
+    const auto *s = static_cast<const unsigned char *>(src);
+
+    if (n < W) {
+        V::copyShort(d, s, n);
+        return dest;
+    }
+    if (n <= 2 * W) {
+        auto a = V::loadu(s);
+        auto b = V::loadu(s + n - W);
+        V::storeu(d, a);
+        V::storeu(d + n - W, b);
+        return dest;
+    }
+    if (n <= 4 * W) {
+        auto a = V::loadu(s);
+        auto b = V::loadu(s + W);
+        auto c = V::loadu(s + n - 2 * W);
+        auto e = V::loadu(s + n - W);
+        V::storeu(d, a);
+        V::storeu(d + W, b);
+        V::storeu(d + n - 2 * W, c);
+        V::storeu(d + n - W, e);
+        return dest;
+    }
+
+    // 先记下首尾各一个向量，中间部分按目标地址对齐后使用对齐写入；
+    // 对齐前的头部和不足一个向量的尾部最后由 head/tail 覆盖
+    auto head = V::loadu(s);
+    auto tail = V::loadu(s + n - W);
+    const size_t skew = (W - (reinterpret_cast<uintptr_t>(d) & (W - 1))) & (W - 1);
+    unsigned char *dp = d + skew;
+    const unsigned char *sp = s + skew;
+    unsigned char *const end = d + n;
+
+    // 超过阈值（默认由 L3 大小推算）的大块拷贝使用非临时存储，
+    // 避免把即将不再访问的目标数据写进缓存、挤掉其它热数据
+    if (streaming(n)) {
+        while (static_cast<size_t>(end - dp) >= 4 * W) {
+            for (size_t line = 0; line < 4 * W; line += 64) {
+                _mm_prefetch(reinterpret_cast<const char *>(sp + kPrefetchDistance + line),
+                             _MM_HINT_NTA);
+            }
+            auto r0 = V::loadu(sp);
+            auto r1 = V::loadu(sp + W);
+            auto r2 = V::loadu(sp + 2 * W);
+            auto r3 = V::loadu(sp + 3 * W);
+            V::stream(dp, r0);
+            V::stream(dp + W, r1);
+            V::stream(dp + 2 * W, r2);
+            V::stream(dp + 3 * W, r3);
+            dp += 4 * W;
+            sp += 4 * W;
+        }
+        // 非临时存储是弱序的，返回前必须用 sfence 保证对其它线程可见的顺序
+        _mm_sfence();
+    }
+
+    while (static_cast<size_t>(end - dp) >= 4 * W) {
+        auto r0 = V::loadu(sp);
+        auto r1 = V::loadu(sp + W);
+        auto r2 = V::loadu(sp + 2 * W);
+        auto r3 = V::loadu(sp + 3 * W);
+        V::store(dp, r0);
+        V::store(dp + W, r1);
+        V::store(dp + 2 * W, r2);
+        V::store(dp + 3 * W, r3);
+        dp += 4 * W;
+        sp += 4 * W;
+    }
+    while (static_cast<size_t>(end - dp) >= W) {
+        V::store(dp, V::loadu(sp));
+        dp += W;
+        sp += W;
+    }
+
+    V::storeu(d, head);
+    V::storeu(end - W, tail);
+    return dest;
+}
+
+// 反向拷贝，用于 dest 落在 [src, src + n) 内的重叠情况：
+// 从尾部开始，每次写入的位置都不低于尚未读取的源数据
+template<typename V>
+void *copyBackward(void *dest, const void *src, size_t n)
+{
+    constexpr size_t W = V::kWidth;
+    if (n <= 4 * W) {
+        return copyForward<V>(dest, src, n); // 小块先全部读出再写入，与方向无关
+    }
+
+    auto *d = static_cast<unsigned char *>(dest);
+    const auto *s = static_cast<const unsigned char *>(src);
+    unsigned char *const end = d + n;
+
+    auto head = V::loadu(s);
+    auto tail = V::loadu(s + n - W);
+    unsigned char *dp = end - (reinterpret_cast<uintptr_t>(end) & (W - 1));
+    const unsigned char *sp = s + (dp - d);
+
+    while (static_cast<size_t>(dp - d) >= 4 * W) {
+        dp -= 4 * W;
+        sp -= 4 * W;
+        auto r3 = V::loadu(sp + 3 * W);
+        auto r2 = V::loadu(sp + 2 * W);
+        auto r1 = V::loadu(sp + W);
+        auto r0 = V::loadu(sp);
+        V::store(dp + 3 * W, r3);
+        V::store(dp + 2 * W, r2);
+        V::store(dp + W, r1);
+        V::store(dp, r0);
+    }
+    while (static_cast<size_t>(dp - d) >= W) {
+        dp -= W;
+        sp -= W;
+        V::store(dp, V::loadu(sp));
+    }
+
+    V::storeu(end - W, tail);
+    V::storeu(d, head);
+    return dest;
+}
+
+template<typename V>
+void *moveBytes(void *dest, const void *src, size_t n)
+{
+    const auto d = reinterpret_cast<uintptr_t>(dest);
+    const auto s = reinterpret_cast<uintptr_t>(src);
+    // 只有目标落在源区间之后且有重叠时才需要反向拷贝
+    if (d > s && d - s < n) {
+        return copyBackward<V>(dest, src, n);
+    }
+    return copyForward<V>(dest, src, n);
+}
+
+template<typename V>
+void *fill(void *dest, int c, size_t n)
+{
+    constexpr size_t W = V::kWidth;
+    auto *d = static_cast<unsigned char *>(dest);
+    const auto byte = static_cast<unsigned char>(c);
+
+    if (n < W) {
+        V::setShort(d, byte, n);
+        return dest;
+    }
+
+    // 广播到整个向量寄存器，首尾用非对齐写入，中间按目标地址对齐
+    const auto v = V::set1(byte);
+    unsigned char *const end = d + n;
+    V::storeu(d, v);
+    V::storeu(end - W, v);
+    if (n <= 2 * W) {
+        return dest;
+    }
+
+    unsigned char *dp = d + ((W - (reinterpret_cast<uintptr_t>(d) & (W - 1))) & (W - 1));
+    if (streaming(n)) {
+        while (static_cast<size_t>(end - dp) >= 4 * W) {
+            V::stream(dp, v);
+            V::stream(dp + W, v);
+            V::stream(dp + 2 * W, v);
+            V::stream(dp + 3 * W, v);
+            dp += 4 * W;
+        }
+        _mm_sfence();
+    }
+    while (static_cast<size_t>(end - dp) >= 4 * W) {
+        V::store(dp, v);
+        V::store(dp + W, v);
+        V::store(dp + 2 * W, v);
+        V::store(dp + 3 * W, v);
+        dp += 4 * W;
+    }
+    while (static_cast<size_t>(end - dp) >= W) {
+        V::store(dp, v);
+        dp += W;
+    }
+    return dest;
+}
+
+// 逐向量比较，发现不同立即返回，返回值为第一个不同字节之差（按 unsigned char 比较）
+template<typename V>
+int compare(const void *lhs, const void *rhs, size_t n)
+{
+    constexpr size_t W = V::kWidth;
+    const auto *a = static_cast<const unsigned char *>(lhs);
+    const auto *b = static_cast<const unsigned char *>(rhs);
+
+    if (n < W) {
+        return V::compareShort(a, b, n);
+    }
+
+    size_t offset = 0;
+    while (n - offset >= 4 * W) {
+        const uint64_t m0 = V::diffMask(V::loadu(a + offset), V::loadu(b + offset));
+        const uint64_t m1 = V::diffMask(V::loadu(a + offset + W), V::loadu(b + offset + W));
+        const uint64_t m2 = V::diffMask(V::loadu(a + offset + 2 * W), V::loadu(b + offset + 2 * W));
+        const uint64_t m3 = V::diffMask(V::loadu(a + offset + 3 * W), V::loadu(b + offset + 3 * W));
+        if ((m0 | m1 | m2 | m3) != 0) {
+            const uint64_t masks[] = {m0, m1, m2, m3};
+            for (size_t i = 0; i < 4; i++) {
+                if (masks[i] != 0) {
+                    return byteDiff(a, b, offset + i * W + firstSetBit(masks[i]));
+                }
+            }
+        }
+        offset += 4 * W;
+    }
+    while (n - offset >= W) {
+        const uint64_t mask = V::diffMask(V::loadu(a + offset), V::loadu(b + offset));
+        if (mask != 0) {
+            return byteDiff(a, b, offset + firstSetBit(mask));
+        }
+        offset += W;
+    }
+    if (offset < n) {
+        // 最后一个向量与已比较部分重叠，重叠部分必然相等，不影响第一个不同字节的位置
+        offset = n - W;
+        const uint64_t mask = V::diffMask(V::loadu(a + offset), V::loadu(b + offset));
+        if (mask != 0) {
+            return byteDiff(a, b, offset + firstSetBit(mask));
+        }
+    }
+    return 0;
+}
+
+template<typename V>
+constexpr MemKernel::Table makeTable()
+{
+    return {&copyForward<V>, &moveBytes<V>, &fill<V>, &compare<V>};
+}
+
+} // namespace
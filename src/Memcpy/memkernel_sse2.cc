@@ -0,0 +1,30 @@
+#include "memkernel_simd.hpp"
+
+namespace {
+
+struct Sse2
+{
+    using Reg = __m128i;
+    static constexpr size_t kWidth = 16;
+
+    static Reg loadu(const void *p) { return _mm_loadu_si128(static_cast<const __m128i *>(p)); }
+    static void storeu(void *p, Reg v) { _mm_storeu_si128(static_cast<__m128i *>(p), v); }
+    static void store(void *p, Reg v) { _mm_store_si128(static_cast<__m128i *>(p), v); }
+    static void stream(void *p, Reg v) { _mm_stream_si128(static_cast<__m128i *>(p), v); }
+    static Reg set1(unsigned char c) { return _mm_set1_epi8(static_cast<char>(c)); }
+    static uint64_t diffMask(Reg a, Reg b)
+    {
+        return static_cast<uint32_t>(~_mm_movemask_epi8(_mm_cmpeq_epi8(a, b))) & 0xFFFF;
+    }
+
+    static void copyShort(unsigned char *d, const unsigned char *s, size_t n) { copySmall(d, s, n); }
+    static void setShort(unsigned char *d, unsigned char c, size_t n) { setSmall(d, c, n); }
+    static int compareShort(const unsigned char *a, const unsigned char *b, size_t n)
+    {
+        return compareSmall(a, b, n);
+    }
+};
+
+} // namespace
+
+const MemKernel::Table MemKernel::sse2Table = makeTable<Sse2>();
@@ -0,0 +1,151 @@
+#include "movepages.hpp"
+#include "mymemcpy.hpp"
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <map>
+#include <mutex>
+
+#ifndef MREMAP_DONTUNMAP
+#define MREMAP_DONTUNMAP 4 // Linux 5.7+
+#endif
+#endif
+
+namespace {
+
+#ifdef __linux__
+
+size_t pageSize()
+{
+    static const auto size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    return size;
+}
+
+// move_pages_alloc 分配的映射：起始地址 -> 长度。
+// 文件映射和共享映射不能移动（移动后 dest 会与文件或其它进程共享数据），
+// 只登记自己创建的私有匿名映射，判断时查表即可，不必每次读取 /proc/self/maps
+class Regions
+{
+public:
+    static Regions &instance()
+    {
+        static Regions regions;
+        return regions;
+    }
+
+    void add(uintptr_t begin, size_t size)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_regions[begin] = size;
+    }
+
+    void remove(uintptr_t begin)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_regions.erase(begin);
+    }
+
+    // [begin, end) 是否完整落在某一块登记的映射中
+    bool contains(uintptr_t begin, uintptr_t end) const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_regions.upper_bound(begin);
+        if (it == m_regions.begin()) {
+            return false;
+        }
+        --it;
+        return end <= it->first + it->second;
+    }
+
+private:
+    mutable std::mutex m_mutex;
+    std::map<uintptr_t, size_t> m_regions;
+};
+
+size_t roundUpToPage(size_t n)
+{
+    const size_t page = pageSize();
+    return (n + page - 1) / page * page;
+}
+
+#endif
+
+bool rangesOverlap(uintptr_t a, uintptr_t b, size_t n)
+{
+    return a < b + n && b < a + n;
+}
+
+} // namespace
+
+void *move_pages_alloc(size_t n)
+{
+#ifdef __linux__
+    if (n == 0) {
+        return NULL;
+    }
+    const size_t size = roundUpToPage(n);
+    void *p = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) {
+        return NULL;
+    }
+    Regions::instance().add(reinterpret_cast<uintptr_t>(p), size);
+    return p;
+#else
+    return malloc(n);
+#endif
+}
+
+void move_pages_free(void *p, size_t n)
+{
+    if (p == NULL) {
+        return;
+    }
+#ifdef __linux__
+    Regions::instance().remove(reinterpret_cast<uintptr_t>(p));
+    munmap(p, roundUpToPage(n));
+#else
+    (void) n;
+    free(p);
+#endif
+}
+
+bool move_pages_eligible(const void *dest, const void *src, size_t n)
+{
+#ifdef __linux__
+    const auto d = reinterpret_cast<uintptr_t>(dest);
+    const auto s = reinterpret_cast<uintptr_t>(src);
+    const size_t page = pageSize();
+    if (dest == NULL || src == NULL || n < kMovePagesMinSize || n % page != 0 || d % page != 0
+        || s % page != 0 || rangesOverlap(d, s, n)) {
+        return false;
+    }
+    const Regions &regions = Regions::instance();
+    return regions.contains(s, s + n) && regions.contains(d, d + n);
+#else
+    (void) dest;
+    (void) src;
+    (void) n;
+    return false;
+#endif
+}
+
+void *move_pages_into(void *dest, void *src, size_t n)
+{
+#ifdef __linux__
+    if (move_pages_eligible(dest, src, n)) {
+        // MREMAP_FIXED 会先解除 dest 原有的映射；MREMAP_DONTUNMAP 保留 src 的映射，
+        // 其页表被清空，之后访问得到新的零页。src 被 mprotect 拆成多个 VMA 或内核过旧时失败，
+        // 退回普通拷贝
+        void *result = mremap(src, n, n, MREMAP_MAYMOVE | MREMAP_FIXED | MREMAP_DONTUNMAP, dest);
+        if (result != MAP_FAILED) {
+            return dest;
+        }
+    }
+#endif
+    return my_memcpy(dest, src, n);
+}
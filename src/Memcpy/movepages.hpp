@@ -0,0 +1,22 @@
+#pragma once
+
+#include <stddef.h>
+
+// 小于该长度时查找登记表和修改页表的开销超过直接拷贝
+constexpr size_t kMovePagesMinSize = 2 * 1024 * 1024;
+
+// 分配可以参与页面移动的缓冲区：页对齐的私有匿名映射，长度向上取整到整页，失败返回 NULL。
+// 只有这样分配的内存才会走 mremap，移动后两块内存仍然是私有匿名映射，可以反复使用。
+// 必须用 move_pages_free 释放，n 与分配时相同
+void *move_pages_alloc(size_t n);
+void move_pages_free(void *p, size_t n);
+
+// 大块数据的移动（不是拷贝）：调用后 dest 为 src 原来的内容，src 仍可读写但内容不确定，
+// 调用方把 src 交出去之后不应再依赖其中的数据。
+// dest、src 都按页对齐、长度是页大小的整数倍，并且都位于 move_pages_alloc 分配的缓冲区中时，
+// 用 mremap 把 src 的物理页直接挂到 dest，耗时与页数成正比而与字节数无关；
+// 不满足条件（或非 Linux 平台）时退回 my_memcpy，开销与普通拷贝相同。源和目标不能重叠
+void *move_pages_into(void *dest, void *src, size_t n);
+
+// 当前参数是否满足页面重映射的条件
+bool move_pages_eligible(const void *dest, const void *src, size_t n);
@@ -1,4 +1,122 @@
 #include "mymemcpy.hpp"
+#include "memkernel.hpp"
+
+#include <atomic>
+
+namespace {
+
+const MemKernel::Table *kernelTable(SimdLevel level)
+{
+    if (!cpuSupports(level)) {
+        return NULL;
+    }
+
+    switch (level) {
+    case SimdLevel::Scalar: return &MemKernel::scalarTable;
+#ifdef MYMEMCPY_X86_SIMD
+    case SimdLevel::SSE2: return &MemKernel::sse2Table;
+    case SimdLevel::AVX2: return &MemKernel::avx2Table;
+    case SimdLevel::AVX512: return &MemKernel::avx512Table;
+#endif
+    default: return NULL;
+    }
+}
+
+const MemKernel::Table &bestTable()
+{
+    static const MemKernel::Table *table = kernelTable(bestSimdLevel());
+    return *table;
+}
+
+// 类似 ifunc：每个入口初始指向解析函数，第一次调用后替换为选中的内核。
+// 多个线程同时解析只会写入相同的值，relaxed 即可
+void *resolveCopy(void *dest, const void *src, size_t n);
+void *resolveMove(void *dest, const void *src, size_t n);
+void *resolveSet(void *dest, int c, size_t n);
+int resolveCompare(const void *lhs, const void *rhs, size_t n);
+
+std::atomic<MemcpyFunc> g_memcpy{&resolveCopy};
+std::atomic<MemmoveFunc> g_memmove{&resolveMove};
+std::atomic<MemsetFunc> g_memset{&resolveSet};
+std::atomic<MemcmpFunc> g_memcmp{&resolveCompare};
+
+void *resolveCopy(void *dest, const void *src, size_t n)
+{
+    g_memcpy.store(bestTable().copy, std::memory_order_relaxed);
+    return bestTable().copy(dest, src, n);
+}
+
+void *resolveMove(void *dest, const void *src, size_t n)
+{
+    g_memmove.store(bestTable().move, std::memory_order_relaxed);
+    return bestTable().move(dest, src, n);
+}
+
+void *resolveSet(void *dest, int c, size_t n)
+{
+    g_memset.store(bestTable().set, std::memory_order_relaxed);
+    return bestTable().set(dest, c, n);
+}
+
+int resolveCompare(const void *lhs, const void *rhs, size_t n)
+{
+    g_memcmp.store(bestTable().compare, std::memory_order_relaxed);
+    return bestTable().compare(lhs, rhs, n);
+}
+
+} // namespace
+
+std::atomic<size_t> MemKernel::nontemporalThreshold{my_memcpy_default_nontemporal_threshold()};
+
+MemcpyFunc my_memcpy_impl(SimdLevel level)
+{
+    const auto *table = kernelTable(level);
+    return table != NULL ? table->copy : NULL;
+}
+
+MemmoveFunc my_memmove_impl(SimdLevel level)
+{
+    const auto *table = kernelTable(level);
+    return table != NULL ? table->move : NULL;
+}
+
+MemsetFunc my_memset_impl(SimdLevel level)
+{
+    const auto *table = kernelTable(level);
+    return table != NULL ? table->set : NULL;
+}
+
+MemcmpFunc my_memcmp_impl(SimdLevel level)
+{
+    const auto *table = kernelTable(level);
+    return table != NULL ? table->compare : NULL;
+}
+
+SimdLevel my_memcpy_level()
+{
+    return bestSimdLevel();
+}
+
+size_t my_memcpy_default_nontemporal_threshold()
+{
+    // 与 glibc 的做法一致：超过 L3 的 3/4 后，普通存储带来的缓存污染开始大于收益。
+    // 检测不到 L3 时按 8 MiB 的常见大小估算
+    const size_t l3 = cpuFeatures().l3CacheSize;
+    return (l3 != 0 ? l3 : 8 * 1024 * 1024) / 4 * 3;
+}
+
+void my_memcpy_set_nontemporal_threshold(size_t bytes)
+{
+    if (bytes == 0) {
+        bytes = my_memcpy_default_nontemporal_threshold();
+    }
+    MemKernel::nontemporalThreshold.store(bytes, std::memory_order_relaxed);
+}
+
+size_t my_memcpy_nontemporal_threshold()
+{
+    return MemKernel::nontemporalThreshold.load(std::memory_order_relaxed);
+}
 
 void *my_memcpy(void *dest, const void *src, size_t n)
 {
@@ -7,14 +125,36 @@ void *my_memcpy(void *dest, const void *src, size_t n)
         return dest;
     }
 
-    // 类型转换用于逐字节操作
-    char *dest_ptr = (char *) dest;
-    const char *src_ptr = (const char *) src;
+    return g_memcpy.load(std::memory_order_relaxed)(dest, src, n);
+}
+
+void *my_memmove(void *dest, const void *src, size_t n)
+{
+    if (dest == NULL || src == NULL || n == 0 || dest == src) {
+        return dest;
+    }
+
+    return g_memmove.load(std::memory_order_relaxed)(dest, src, n);
+}
+
+void *my_memset(void *dest, int c, size_t n)
+{
+    if (dest == NULL || n == 0) {
+        return dest;
+    }
+
+    return g_memset.load(std::memory_order_relaxed)(dest, c, n);
+}
 
-    // 逐字节复制
-    for (size_t i = 0; i < n; i++) {
-        dest_ptr[i] = src_ptr[i];
+int my_memcmp(const void *lhs, const void *rhs, size_t n)
+{
+    if (n == 0 || lhs == rhs) {
+        return 0;
+    }
+    // 空指针视为小于任何有效地址
+    if (lhs == NULL || rhs == NULL) {
+        return lhs == NULL ? -1 : 1;
     }
 
-    return dest;
+    return g_memcmp.load(std::memory_order_relaxed)(lhs, rhs, n);
 }
@@ -1,5 +1,37 @@
 #pragma once
 
+#include "cpufeatures.hpp"
+
 #include <stddef.h>
 
+// my_memcpy / my_memmove / my_memset / my_memcmp 共用一套按 CPU 特性分派的内核：
+// 首次调用时选择最快的实现，之后直接跳转，不再检测
 void *my_memcpy(void *dest, const void *src, size_t n);
+
+// 源和目标可以重叠，目标落在源之后时从尾部反向拷贝
+void *my_memmove(void *dest, const void *src, size_t n);
+
+void *my_memset(void *dest, int c, size_t n);
+
+// 返回第一个不同字节（按 unsigned char 比较）之差，相等返回 0
+int my_memcmp(const void *lhs, const void *rhs, size_t n);
+
+using MemcpyFunc = void *(*) (void *dest, const void *src, size_t n);
+using MemmoveFunc = void *(*) (void *dest, const void *src, size_t n);
+using MemsetFunc = void *(*) (void *dest, int c, size_t n);
+using MemcmpFunc = int (*)(const void *lhs, const void *rhs, size_t n);
+
+// 获取指定指令集级别的实现（不检查空指针），构建或 CPU 不支持时返回 NULL
+MemcpyFunc my_memcpy_impl(SimdLevel level);
+MemmoveFunc my_memmove_impl(SimdLevel level);
+MemsetFunc my_memset_impl(SimdLevel level);
+MemcmpFunc my_memcmp_impl(SimdLevel level);
+
+// 入口函数实际使用的指令集级别
+SimdLevel my_memcpy_level();
+
+// 非临时存储（流式写入）的长度阈值，不小于该值的拷贝和填充绕过缓存。
+// 默认取 L3 缓存的 3/4；传入 0 恢复默认值，传入 SIZE_MAX 关闭流式写入
+void my_memcpy_set_nontemporal_threshold(size_t bytes);
+size_t my_memcpy_nontemporal_threshold();
+size_t my_memcpy_default_nontemporal_threshold();
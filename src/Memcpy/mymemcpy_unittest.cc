@@ -1,8 +1,21 @@
+#include "checksumcopy.hpp"
+#include "fixedmemcpy.hpp"
+#include "movepages.hpp"
 #include "mymemcpy.hpp"
+#include "parallelmemcpy.hpp"
+
+#include <Thread/threadpool.hpp>
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <cstring>
+#include <initializer_list>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
 
 class MyMemcpyTest : public ::testing::Test
 {
@@ -22,6 +35,94 @@ protected:
     {
         return memcmp(ptr1, ptr2, n) == 0;
     }
+
+    // 当前 CPU 可用的所有实现，不支持的指令集直接跳过
+    static std::vector<SimdLevel> availableLevels()
+    {
+        std::vector<SimdLevel> levels;
+        for (auto level : {SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2, SimdLevel::AVX512}) {
+            if (my_memcpy_impl(level) != NULL) {
+                levels.push_back(level);
+            }
+        }
+        return levels;
+    }
+
+    // 在带哨兵的缓冲区中用 func 复制 n 字节，与 memcpy 的结果逐字节比较；
+    // 前后各 kGuard 字节的哨兵用于检查越界写
+    static bool copyMatches(MemcpyFunc func, size_t n, size_t srcOffset, size_t destOffset)
+    {
+        const size_t size = n + kMaxOffset + 2 * kGuard;
+        std::vector<unsigned char> src(size);
+        for (size_t i = 0; i < size; i++) {
+            src[i] = static_cast<unsigned char>(i * 131 + 7);
+        }
+        std::vector<unsigned char> dest(size, 0xA5);
+        std::vector<unsigned char> expected(size, 0xA5);
+
+        void *result = func(dest.data() + kGuard + destOffset, src.data() + kGuard + srcOffset, n);
+        memcpy(expected.data() + kGuard + destOffset, src.data() + kGuard + srcOffset, n);
+
+        return result == dest.data() + kGuard + destOffset && dest == expected;
+    }
+
+    // 在同一块缓冲区内把 [srcOffset, +n) 移动到 [destOffset, +n)，与 memmove 的结果比较
+    static bool moveMatches(MemmoveFunc func, size_t n, size_t srcOffset, size_t destOffset)
+    {
+        const size_t size = n + 2 * kMaxShift + 2 * kGuard;
+        std::vector<unsigned char> buffer(size);
+        for (size_t i = 0; i < size; i++) {
+            buffer[i] = static_cast<unsigned char>(i * 131 + 7);
+        }
+        std::vector<unsigned char> expected = buffer;
+
+        void *result = func(buffer.data() + kGuard + destOffset, buffer.data() + kGuard + srcOffset, n);
+        memmove(expected.data() + kGuard + destOffset, expected.data() + kGuard + srcOffset, n);
+
+        return result == buffer.data() + kGuard + destOffset && buffer == expected;
+    }
+
+    static bool setMatches(MemsetFunc func, size_t n, size_t offset, int c)
+    {
+        const size_t size = n + kMaxOffset + 2 * kGuard;
+        std::vector<unsigned char> dest(size, 0xA5);
+        std::vector<unsigned char> expected(size, 0xA5);
+
+        void *result = func(dest.data() + kGuard + offset, c, n);
+        memset(expected.data() + kGuard + offset, c, n);
+
+        return result == dest.data() + kGuard + offset && dest == expected;
+    }
+
+    // 用定长模板在错位的缓冲区之间复制 N 字节，与 memcpy 的结果比较
+    template<size_t N>
+    static bool fixedCopyMatches()
+    {
+        const size_t size = N + 2 * kGuard + 3;
+        std::vector<unsigned char> src(size);
+        for (size_t i = 0; i < size; i++) {
+            src[i] = static_cast<unsigned char>(i * 131 + 7);
+        }
+        std::vector<unsigned char> dest(size, 0xA5);
+        std::vector<unsigned char> expected(size, 0xA5);
+
+        void *result = my_memcpy<N>(dest.data() + kGuard + 1, src.data() + kGuard + 3);
+        memcpy(expected.data() + kGuard + 1, src.data() + kGuard + 3, N);
+
+        return result == dest.data() + kGuard + 1 && dest == expected;
+    }
+
+    template<size_t... N>
+    static bool allFixedCopiesMatch(std::index_sequence<N...>)
+    {
+        return (fixedCopyMatches<N>() && ...);
+    }
+
+    static int sign(int value) { return (value > 0) - (value < 0); }
+
+    static constexpr size_t kMaxShift = 160;
+    static constexpr size_t kGuard = 64;
+    static constexpr size_t kMaxOffset = 64;
 };
 
 // 测试1: 正常字符串复制
@@ -193,6 +294,533 @@ TEST_F(MyMemcpyTest, NonOverlappingMemory)
     EXPECT_TRUE(memoryEqual(buffer, expected, sizeof(buffer)));
 }
 
+// 测试12: 检测结果与 my_memcpy 实际使用的实现一致
+TEST_F(MyMemcpyTest, DispatchSelectsBestLevel)
+{
+    EXPECT_EQ(my_memcpy_level(), bestSimdLevel());
+    EXPECT_NE(my_memcpy_impl(SimdLevel::Scalar), nullptr);
+    EXPECT_NE(my_memcpy_impl(my_memcpy_level()), nullptr);
+}
+
+// 测试13: 每个实现在 0~4096 的所有长度上与 memcpy 一致，源/目标偏移随长度轮换
+TEST_F(MyMemcpyTest, AllVariantsAllSizes)
+{
+    for (auto level : availableLevels()) {
+        MemcpyFunc func = my_memcpy_impl(level);
+        for (size_t n = 0; n <= 4096; n++) {
+            size_t srcOffset = n % kMaxOffset;
+            size_t destOffset = (n * 7 + 3) % kMaxOffset;
+            ASSERT_TRUE(copyMatches(func, n, srcOffset, destOffset))
+                << simdLevelName(level) << " n=" << n << " src+" << srcOffset << " dest+"
+                << destOffset;
+        }
+    }
+}
+
+// 测试14: 0~kExhaustiveSize 的每个长度，以及几个跨越多轮展开循环的长度，
+// 逐一遍历源/目标的全部 64x64 种错位组合，并检查目标前后的哨兵
+TEST_F(MyMemcpyTest, AllVariantsAllMisalignments)
+{
+    // 覆盖 AVX-512 一轮 4x64 字节展开循环之后的每一种尾部长度
+    constexpr size_t kExhaustiveSize = 320;
+    std::vector<size_t> sizes;
+    for (size_t n = 0; n <= kExhaustiveSize; n++) {
+        sizes.push_back(n);
+    }
+    sizes.insert(sizes.end(), {511, 512, 513, 1000, 4095, 4096, 4097});
+
+    const size_t bufferSize = sizes.back() + kMaxOffset + 2 * kGuard;
+    std::vector<unsigned char> src(bufferSize);
+    for (size_t i = 0; i < bufferSize; i++) {
+        src[i] = static_cast<unsigned char>(i * 131 + 7);
+    }
+    std::vector<unsigned char> dest(bufferSize);
+    const auto untouched = [](const unsigned char *begin, const unsigned char *end) {
+        return std::all_of(begin, end, [](unsigned char c) { return c == 0xA5; });
+    };
+
+    for (auto level : availableLevels()) {
+        MemcpyFunc func = my_memcpy_impl(level);
+        for (size_t n : sizes) {
+            const size_t used = n + kMaxOffset + 2 * kGuard;
+            for (size_t srcOffset = 0; srcOffset < kMaxOffset; srcOffset++) {
+                for (size_t destOffset = 0; destOffset < kMaxOffset; destOffset++) {
+                    std::fill_n(dest.begin(), used, 0xA5);
+                    unsigned char *d = dest.data() + kGuard + destOffset;
+                    const unsigned char *s = src.data() + kGuard + srcOffset;
+                    const bool copied = func(d, s, n) == d && memoryEqual(d, s, n);
+                    ASSERT_TRUE(copied && untouched(dest.data(), d)
+                                && untouched(d + n, dest.data() + used))
+                        << simdLevelName(level) << " n=" << n << " src+" << srcOffset
+                        << " dest+" << destOffset;
+                }
+            }
+        }
+    }
+}
+
+// 测试15: 非临时存储阈值可调，传入 0 恢复默认值
+TEST_F(MyMemcpyTest, NontemporalThresholdTunable)
+{
+    const size_t defaultThreshold = my_memcpy_default_nontemporal_threshold();
+    EXPECT_GT(defaultThreshold, 0u);
+    EXPECT_EQ(my_memcpy_nontemporal_threshold(), defaultThreshold);
+
+    my_memcpy_set_nontemporal_threshold(4096);
+    EXPECT_EQ(my_memcpy_nontemporal_threshold(), 4096u);
+
+    my_memcpy_set_nontemporal_threshold(0);
+    EXPECT_EQ(my_memcpy_nontemporal_threshold(), defaultThreshold);
+}
+
+// 测试16: 调低阈值后拷贝、填充和正向重叠移动走流式写入路径，结果仍然正确
+TEST_F(MyMemcpyTest, NontemporalPathMatchesMemcpy)
+{
+    my_memcpy_set_nontemporal_threshold(1024);
+    const size_t sizes[] = {1023, 1024, 1025, 4095, 4096, 4097, 65536 + 13};
+    for (auto level : availableLevels()) {
+        MemcpyFunc func = my_memcpy_impl(level);
+        for (size_t n : sizes) {
+            for (size_t offset = 0; offset < kMaxOffset; offset++) {
+                ASSERT_TRUE(copyMatches(func, n, offset, (offset * 5 + 1) % kMaxOffset))
+                    << simdLevelName(level) << " n=" << n << " offset=" << offset;
+                ASSERT_TRUE(setMatches(my_memset_impl(level), n, offset, 0x5C))
+                    << simdLevelName(level) << " n=" << n << " offset=" << offset;
+                ASSERT_TRUE(moveMatches(my_memmove_impl(level), n, kMaxShift, offset))
+                    << simdLevelName(level) << " n=" << n << " offset=" << offset;
+            }
+        }
+    }
+    my_memcpy_set_nontemporal_threshold(0);
+}
+
+// 测试17: my_memmove 处理前后两个方向的重叠，以及不重叠的情况
+TEST_F(MyMemcpyTest, MemmoveOverlap)
+{
+    char buffer[] = "1234567890";
+    my_memmove(buffer + 2, buffer, 6);
+    EXPECT_STREQ(buffer, "1212345690");
+
+    char backward[] = "1234567890";
+    my_memmove(backward, backward + 2, 6);
+    EXPECT_STREQ(backward, "3456787890");
+
+    EXPECT_EQ(my_memmove(NULL, buffer, 5), nullptr);
+    EXPECT_EQ(my_memmove(buffer, buffer, 5), buffer);
+}
+
+// 测试18: 每个实现在 0~2048 的所有长度、正反方向的多种重叠距离上与 memmove 一致
+TEST_F(MyMemcpyTest, AllVariantsMemmove)
+{
+    const size_t shifts[] = {0, 1, 7, 16, 33, 64, 65, 127, 160};
+    for (auto level : availableLevels()) {
+        MemmoveFunc func = my_memmove_impl(level);
+        for (size_t n = 0; n <= 2048; n++) {
+            for (size_t shift : shifts) {
+                ASSERT_TRUE(moveMatches(func, n, kMaxShift, kMaxShift + shift))
+                    << simdLevelName(level) << " n=" << n << " shift=+" << shift;
+                ASSERT_TRUE(moveMatches(func, n, kMaxShift, kMaxShift - shift))
+                    << simdLevelName(level) << " n=" << n << " shift=-" << shift;
+            }
+        }
+    }
+}
+
+// 测试19: my_memset 只使用 c 的低 8 位，长度为 0 时不修改目标
+TEST_F(MyMemcpyTest, MemsetBasic)
+{
+    char buffer[16];
+    memset(buffer, 'x', sizeof(buffer));
+
+    EXPECT_EQ(my_memset(buffer, 0x141, 8), buffer);
+    for (int i = 0; i < 8; i++) {
+        EXPECT_EQ(buffer[i], 'A');
+    }
+    EXPECT_EQ(buffer[8], 'x');
+
+    my_memset(buffer, 0, 0);
+    EXPECT_EQ(buffer[0], 'A');
+    EXPECT_EQ(my_memset(NULL, 0, 8), nullptr);
+}
+
+// 测试20: 每个实现在 0~4096 的所有长度和轮换的目标偏移上与 memset 一致
+TEST_F(MyMemcpyTest, AllVariantsMemset)
+{
+    const int values[] = {0, 0xAB, -1, 0x1234};
+    for (auto level : availableLevels()) {
+        MemsetFunc func = my_memset_impl(level);
+        for (size_t n = 0; n <= 4096; n++) {
+            const size_t offset = (n * 7 + 3) % kMaxOffset;
+            const int c = values[n % 4];
+            ASSERT_TRUE(setMatches(func, n, offset, c))
+                << simdLevelName(level) << " n=" << n << " offset=" << offset << " c=" << c;
+        }
+    }
+}
+
+// 测试21: my_memcmp 按 unsigned char 比较并在第一个不同字节处返回
+TEST_F(MyMemcpyTest, MemcmpBasic)
+{
+    EXPECT_EQ(my_memcmp("abc", "abc", 3), 0);
+    EXPECT_LT(my_memcmp("abc", "abd", 3), 0);
+    EXPECT_GT(my_memcmp("abd", "abc", 3), 0);
+    EXPECT_EQ(my_memcmp("abc", "abd", 2), 0);
+
+    const unsigned char high[] = {0x80};
+    const unsigned char low[] = {0x01};
+    EXPECT_GT(my_memcmp(high, low, 1), 0);
+
+    EXPECT_EQ(my_memcmp(NULL, NULL, 4), 0);
+    EXPECT_LT(my_memcmp(NULL, "a", 1), 0);
+    EXPECT_EQ(my_memcmp(NULL, "a", 0), 0);
+}
+
+// 测试22: 每个实现在各种长度、错位和不同位置上的比较结果符号与 memcmp 一致
+TEST_F(MyMemcpyTest, AllVariantsMemcmp)
+{
+    const size_t size = 4096 + kMaxOffset;
+    std::vector<unsigned char> lhs(size);
+    for (size_t i = 0; i < size; i++) {
+        lhs[i] = static_cast<unsigned char>(i * 131 + 7);
+    }
+
+    for (auto level : availableLevels()) {
+        MemcmpFunc func = my_memcmp_impl(level);
+        for (size_t n = 0; n <= 4096; n += (n < 300 ? 1 : 37)) {
+            const size_t lhsOffset = n % kMaxOffset;
+            const size_t rhsOffset = (n * 7 + 3) % kMaxOffset;
+            std::vector<unsigned char> rhs(size);
+            memcpy(rhs.data() + rhsOffset, lhs.data() + lhsOffset, n);
+            const unsigned char *a = lhs.data() + lhsOffset;
+            unsigned char *b = rhs.data() + rhsOffset;
+
+            ASSERT_EQ(func(a, b, n), 0) << simdLevelName(level) << " n=" << n;
+
+            // 短数据遍历每个位置，长数据抽样首、中、尾及向量边界附近
+            std::vector<size_t> positions;
+            if (n < 300) {
+                for (size_t pos = 0; pos < n; pos++) {
+                    positions.push_back(pos);
+                }
+            } else {
+                for (size_t pos : {size_t{0}, size_t{63}, size_t{64}, n / 2, n - 65, n - 1}) {
+                    positions.push_back(pos);
+                }
+            }
+            for (size_t pos : positions) {
+                for (int delta : {1, -1}) {
+                    const unsigned char original = b[pos];
+                    b[pos] = static_cast<unsigned char>(original + delta);
+                    // 在更靠后的位置再制造一个反向差异，确认返回的是第一个不同字节
+                    if (pos + 1 < n) {
+                        b[n - 1] = static_cast<unsigned char>(b[n - 1] - delta);
+                    }
+                    ASSERT_EQ(sign(func(a, b, n)), sign(memcmp(a, b, n)))
+                        << simdLevelName(level) << " n=" << n << " pos=" << pos;
+                    memcpy(b, a, n);
+                }
+            }
+        }
+    }
+}
+
+// 测试23: 多线程拷贝在各种长度和错位下与 memcpy 一致，切分边界不丢失也不重复字节
+TEST_F(MyMemcpyTest, ParallelMemcpyMatchesMemcpy)
+{
+    ThreadPool pool(4);
+    const size_t sizes[] = {(1 << 21) + 1, 3 * (1 << 20) + 4095, 5 * (1 << 20) + 13, 1 << 23};
+    for (size_t n : sizes) {
+        for (size_t offset : {size_t{0}, size_t{1}, size_t{4095}}) {
+            std::vector<unsigned char> src(n + offset);
+            for (size_t i = 0; i < src.size(); i++) {
+                src[i] = static_cast<unsigned char>(i * 131 + (i >> 12));
+            }
+            std::vector<unsigned char> dest(n + 2 * offset + 1, 0xA5);
+            std::vector<unsigned char> expected = dest;
+
+            void *result = parallel_memcpy(dest.data() + offset, src.data() + offset, n, pool, 0);
+            memcpy(expected.data() + offset, src.data() + offset, n);
+
+            EXPECT_EQ(result, dest.data() + offset);
+            ASSERT_TRUE(dest == expected) << "n=" << n << " offset=" << offset;
+        }
+    }
+}
+
+// 测试24: 低于阈值、线程池已停止或参数无效时退回单线程拷贝
+TEST_F(MyMemcpyTest, ParallelMemcpyFallback)
+{
+    ThreadPool pool(2);
+    std::vector<unsigned char> src(1 << 22, 0x3C);
+    std::vector<unsigned char> dest(src.size(), 0);
+
+    parallel_memcpy(dest.data(), src.data(), src.size(), pool);
+    EXPECT_TRUE(dest == src);
+
+    pool.shutdown();
+    std::fill(dest.begin(), dest.end(), 0);
+    parallel_memcpy(dest.data(), src.data(), src.size(), pool, 0);
+    EXPECT_TRUE(dest == src);
+
+    EXPECT_EQ(parallel_memcpy(NULL, src.data(), src.size(), pool), nullptr);
+}
+
+// 测试25: 在工作线程内部调用也能完成，不会因为等待自身所在的线程池而死锁
+TEST_F(MyMemcpyTest, ParallelMemcpyFromWorker)
+{
+    ThreadPool pool(1);
+    std::vector<unsigned char> src(1 << 23, 0x7E);
+    std::vector<unsigned char> dest(src.size(), 0);
+
+    auto future = pool.submitFuture([&](std::stop_token) {
+        parallel_memcpy(dest.data(), src.data(), src.size(), pool, 0);
+    });
+    future.get();
+    EXPECT_TRUE(dest == src);
+}
+
+// 测试26: 定长模板覆盖 0~300 的所有长度（含退回运行时拷贝的部分），结果与 memcpy 一致
+TEST_F(MyMemcpyTest, FixedSizeTemplate)
+{
+    EXPECT_TRUE(allFixedCopiesMatch(std::make_index_sequence<301>{}));
+
+    // 定长拷贝先整体读入，源和目标重叠时同样正确
+    char buffer[] = "0123456789abcdef0123456789ABCDEF!";
+    my_memcpy<32>(buffer + 1, buffer);
+    EXPECT_STREQ(buffer, "00123456789abcdef0123456789ABCDEF");
+}
+
+// 测试27: my_copy_n 按元素复制可平凡复制的结构体，返回目标末尾
+TEST_F(MyMemcpyTest, CopyN)
+{
+    struct Point
+    {
+        int x;
+        int y;
+        double z;
+    };
+    const Point src[3] = {{1, 2, 3.0}, {4, 5, 6.0}, {7, 8, 9.0}};
+    Point dest[3] = {};
+
+    EXPECT_EQ(my_copy_n(src, 3, dest), dest + 3);
+    EXPECT_TRUE(memoryEqual(dest, src, sizeof(src)));
+
+    Point fixed[3] = {};
+    EXPECT_EQ(my_copy_n<2>(src + 1, fixed), fixed + 2);
+    EXPECT_EQ(fixed[0].x, 4);
+    EXPECT_EQ(fixed[1].y, 8);
+    EXPECT_EQ(fixed[2].x, 0);
+}
+
+// 测试28: 跳转表覆盖 0~128 的每个长度，源/目标错位轮换
+TEST_F(MyMemcpyTest, SmallCopyJumpTable)
+{
+    for (size_t n = 0; n <= kSmallCopyMax; n++) {
+        for (size_t offset = 0; offset < 16; offset++) {
+            ASSERT_TRUE(copyMatches(&my_memcpy_small, n, offset, 15 - offset))
+                << "n=" << n << " offset=" << offset;
+        }
+    }
+}
+
+#ifdef __linux__
+// 测试29: move_pages_alloc 分配的缓冲区之间通过 mremap 移动物理页
+TEST_F(MyMemcpyTest, MovePagesRemapsAnonymousMapping)
+{
+    const size_t n = 4 * kMovePagesMinSize;
+    auto *src = static_cast<unsigned char *>(move_pages_alloc(n));
+    auto *dest = static_cast<unsigned char *>(move_pages_alloc(n));
+    ASSERT_NE(src, nullptr);
+    ASSERT_NE(dest, nullptr);
+
+    std::vector<unsigned char> expected(n);
+    for (size_t i = 0; i < n; i++) {
+        expected[i] = static_cast<unsigned char>(i * 131 + (i >> 12));
+    }
+    memcpy(src, expected.data(), n);
+
+    EXPECT_TRUE(move_pages_eligible(dest, src, n));
+    EXPECT_EQ(move_pages_into(dest, src, n), dest);
+    EXPECT_TRUE(memoryEqual(dest, expected.data(), n));
+
+    // src 仍然可以读写，移动后两块缓冲区都还能再次参与移动
+    src[0] = 1;
+    EXPECT_EQ(src[0], 1);
+    EXPECT_TRUE(move_pages_eligible(src, dest, n));
+    EXPECT_EQ(move_pages_into(src, dest, n), src);
+    EXPECT_TRUE(memoryEqual(src, expected.data(), n));
+
+    move_pages_free(src, n);
+    move_pages_free(dest, n);
+}
+
+// 测试30: 不是 move_pages_alloc 分配的映射（例如共享映射，移动后会与其它映射共享数据）
+// 不满足条件，退回拷贝
+TEST_F(MyMemcpyTest, MovePagesRejectsForeignMapping)
+{
+    const size_t n = kMovePagesMinSize;
+    auto *src = static_cast<unsigned char *>(
+        mmap(NULL, n, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0));
+    auto *dest = static_cast<unsigned char *>(move_pages_alloc(n));
+    ASSERT_NE(src, MAP_FAILED);
+    ASSERT_NE(dest, nullptr);
+    memset(src, 0x42, n);
+
+    EXPECT_FALSE(move_pages_eligible(dest, src, n));
+    move_pages_into(dest, src, n);
+    EXPECT_EQ(dest[n - 1], 0x42);
+
+    // 释放之后同一地址不再被当作可移动的缓冲区
+    move_pages_free(dest, n);
+    EXPECT_FALSE(move_pages_eligible(dest, src, n));
+
+    munmap(src, n);
+}
+#endif
+
+// 测试31: 未按页对齐、长度不足或长度不是整页时退回普通拷贝，不再额外写 src
+TEST_F(MyMemcpyTest, MovePagesFallback)
+{
+    std::vector<unsigned char> src(kMovePagesMinSize + 4096 + 1);
+    for (size_t i = 0; i < src.size(); i++) {
+        src[i] = static_cast<unsigned char>(i * 7);
+    }
+    const std::vector<unsigned char> original = src;
+    std::vector<unsigned char> dest(src.size(), 0);
+
+    EXPECT_FALSE(move_pages_eligible(dest.data() + 1, src.data() + 1, kMovePagesMinSize));
+    EXPECT_FALSE(move_pages_eligible(dest.data(), src.data(), 4096));
+    EXPECT_FALSE(move_pages_eligible(dest.data(), src.data(), kMovePagesMinSize + 1));
+
+    EXPECT_EQ(move_pages_into(dest.data() + 1, src.data() + 1, kMovePagesMinSize), dest.data() + 1);
+    EXPECT_TRUE(memoryEqual(dest.data() + 1, original.data() + 1, kMovePagesMinSize));
+    EXPECT_EQ(src, original);
+}
+
+// 测试32: CRC32C 与 XXH64 的标准测试向量
+TEST_F(MyMemcpyTest, ChecksumKnownVectors)
+{
+    const char digits[] = "123456789";
+    EXPECT_EQ(my_crc32c(digits, 9), 0xE3069283u);
+    EXPECT_EQ(my_crc32c(digits, 0), 0u);
+
+    EXPECT_EQ(my_hash64("", 0), 0xEF46DB3751D8E999ULL);
+    EXPECT_EQ(my_hash64("abc", 3), 0x44BC2CF5AD770999ULL);
+
+    char dest[16] = {};
+    uint32_t crc = 0;
+    EXPECT_EQ(my_memcpy_crc32c(dest, digits, 9, &crc), dest);
+    EXPECT_EQ(crc, 0xE3069283u);
+    EXPECT_EQ(std::memcmp(dest, digits, 9), 0);
+}
+
+// 测试33: 边拷贝边校验的结果与先拷贝再计算一致，覆盖各长度、错位和逐位计算的参考 CRC
+TEST_F(MyMemcpyTest, ChecksumCopyMatchesSeparatePasses)
+{
+    auto referenceCrc32c = [](const unsigned char *p, size_t n) {
+        uint32_t crc = 0xFFFFFFFF;
+        for (size_t i = 0; i < n; i++) {
+            crc ^= p[i];
+            for (int bit = 0; bit < 8; bit++) {
+                crc = (crc & 1) ? (crc >> 1) ^ 0x82F63B78 : crc >> 1;
+            }
+        }
+        return ~crc;
+    };
+
+    const size_t maxSize = 1100;
+    std::vector<unsigned char> src(maxSize + 8);
+    for (size_t i = 0; i < src.size(); i++) {
+        src[i] = static_cast<unsigned char>(i * 131 + 7);
+    }
+    std::vector<unsigned char> dest(maxSize + 8);
+
+    for (size_t offset : {0, 1, 3}) {
+        for (size_t n = 0; n <= maxSize; n++) {
+            const unsigned char *s = src.data() + offset;
+            std::fill(dest.begin(), dest.end(), 0);
+
+            uint32_t crc = 0;
+            my_memcpy_crc32c(dest.data() + offset, s, n, &crc);
+            ASSERT_EQ(crc, referenceCrc32c(s, n)) << "n=" << n << " offset=" << offset;
+            ASSERT_EQ(crc, my_crc32c(s, n));
+            ASSERT_TRUE(memoryEqual(dest.data() + offset, s, n));
+
+            std::fill(dest.begin(), dest.end(), 0);
+            uint64_t hash = 0;
+            my_memcpy_hash64(dest.data() + offset, s, n, &hash, 42);
+            ASSERT_EQ(hash, my_hash64(s, n, 42)) << "n=" << n << " offset=" << offset;
+            ASSERT_TRUE(memoryEqual(dest.data() + offset, s, n));
+        }
+    }
+}
+
+// 测试34: 分段累加的 CRC 与整段计算一致
+TEST_F(MyMemcpyTest, ChecksumCopyChained)
+{
+    std::vector<unsigned char> src(64 * 1024 + 13);
+    for (size_t i = 0; i < src.size(); i++) {
+        src[i] = static_cast<unsigned char>(i ^ (i >> 8));
+    }
+    std::vector<unsigned char> dest(src.size());
+
+    uint32_t crc = 0;
+    size_t pos = 0;
+    for (size_t segment = 1; pos < src.size(); segment = segment * 3 + 1) {
+        const size_t n = std::min(segment, src.size() - pos);
+        my_memcpy_crc32c(dest.data() + pos, src.data() + pos, n, &crc);
+        pos += n;
+    }
+    EXPECT_EQ(crc, my_crc32c(src.data(), src.size()));
+    EXPECT_EQ(my_crc32c(src.data() + 100, src.size() - 100, my_crc32c(src.data(), 100)), crc);
+    EXPECT_TRUE(memoryEqual(dest.data(), src.data(), src.size()));
+}
+
+// 测试35: 查表实现与 SSE4.2 实现逐一对比，覆盖各长度、错位与非零初值（不支持 SSE4.2 时只测查表实现）
+TEST_F(MyMemcpyTest, Crc32cSoftwareMatchesHardware)
+{
+    const Crc32cCopyFunc softwareCopy = my_memcpy_crc32c_impl(false);
+    const Crc32cFunc software = my_crc32c_impl(false);
+    ASSERT_NE(softwareCopy, nullptr);
+    ASSERT_NE(software, nullptr);
+    EXPECT_EQ(software("123456789", 9, 0), 0xE3069283u);
+    const Crc32cCopyFunc hardwareCopy = my_memcpy_crc32c_impl(true);
+    const Crc32cFunc hardware = my_crc32c_impl(true);
+    EXPECT_EQ(hardwareCopy == nullptr, hardware == nullptr);
+
+    std::vector<unsigned char> src(9000);
+    for (size_t i = 0; i < src.size(); i++) {
+        src[i] = static_cast<unsigned char>((i * 2654435761u) >> 13);
+    }
+    std::vector<unsigned char> dest(src.size());
+
+    for (size_t offset = 0; offset < 8; offset++) {
+        for (size_t n : {0, 1, 3, 7, 8, 15, 16, 63, 64, 255, 4095, 4096, 4097, 8191}) {
+            const unsigned char *s = src.data() + offset;
+            for (uint32_t seed : {0u, 0xE3069283u}) {
+                uint32_t softwareCrc = seed;
+                std::fill(dest.begin(), dest.end(), 0);
+                softwareCopy(dest.data() + offset, s, n, &softwareCrc);
+                ASSERT_TRUE(memoryEqual(dest.data() + offset, s, n));
+                ASSERT_EQ(softwareCrc, software(s, n, seed)) << "n=" << n << " offset=" << offset;
+                if (hardware == nullptr) {
+                    continue;
+                }
+
+                uint32_t hardwareCrc = seed;
+                std::fill(dest.begin(), dest.end(), 0);
+                hardwareCopy(dest.data() + offset, s, n, &hardwareCrc);
+                ASSERT_TRUE(memoryEqual(dest.data() + offset, s, n));
+                ASSERT_EQ(hardwareCrc, softwareCrc) << "n=" << n << " offset=" << offset;
+                ASSERT_EQ(hardware(s, n, seed), softwareCrc) << "n=" << n << " offset=" << offset;
+            }
+        }
+    }
+
+    // 入口函数使用的是其中之一
+    EXPECT_EQ(my_crc32c(src.data(), src.size()), software(src.data(), src.size(), 0));
+}
+
 // 主函数
 int main(int argc, char **argv)
 {
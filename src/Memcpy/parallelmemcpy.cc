@@ -0,0 +1,96 @@
+#include "parallelmemcpy.hpp"
+#include "mymemcpy.hpp"
+
+#include <Thread/threadpool.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <stdint.h>
+
+namespace {
+
+// 切分边界对齐到目标地址的页边界，避免两个线程写同一页或同一缓存行
+constexpr size_t kPageSize = 4096;
+
+// 每块至少 1 MiB，块太小时调度开销会抵消并行收益
+constexpr size_t kMinChunkSize = 1024 * 1024;
+
+// 所有参与者共享的拷贝状态：各自从 next 领取块，完成后累加 done。
+// 用 shared_ptr 持有，调用线程返回后仍在队列中的任务只会发现没有剩余块
+struct CopyJob
+{
+    unsigned char *dest;
+    const unsigned char *src;
+    size_t size;
+    size_t chunkSize;
+    size_t chunkCount;
+    std::atomic<size_t> next{0};
+    std::atomic<size_t> done{0};
+
+    // 领取并完成块，直到没有剩余
+    void work()
+    {
+        size_t index;
+        while ((index = next.fetch_add(1, std::memory_order_relaxed)) < chunkCount) {
+            const size_t begin = chunkBegin(index);
+            const size_t end = chunkBegin(index + 1);
+            my_memcpy(dest + begin, src + begin, end - begin);
+            if (done.fetch_add(1, std::memory_order_acq_rel) + 1 == chunkCount) {
+                done.notify_all();
+            }
+        }
+    }
+
+    // 第 index 块在缓冲区中的起始偏移，按目标地址向上对齐到页边界
+    [[nodiscard]] size_t chunkBegin(size_t index) const
+    {
+        if (index == 0) {
+            return 0;
+        }
+        if (index >= chunkCount) {
+            return size;
+        }
+        const auto address = reinterpret_cast<uintptr_t>(dest) + index * chunkSize;
+        const auto aligned = (address + kPageSize - 1) & ~static_cast<uintptr_t>(kPageSize - 1);
+        return std::min(size, static_cast<size_t>(aligned - reinterpret_cast<uintptr_t>(dest)));
+    }
+};
+
+} // namespace
+
+void *parallel_memcpy(void *dest, const void *src, size_t n, ThreadPool &pool, size_t cutoff)
+{
+    if (dest == NULL || src == NULL || n == 0) {
+        return dest;
+    }
+
+    // 调用线程也参与拷贝，因此参与者比工作线程多一个
+    const size_t participants = pool.size() + 1;
+    const size_t chunkCount = std::min(participants, n / kMinChunkSize);
+    if (n < cutoff || chunkCount < 2 || !pool.isRunning()) {
+        return my_memcpy(dest, src, n);
+    }
+
+    auto job = std::make_shared<CopyJob>();
+    job->dest = static_cast<unsigned char *>(dest);
+    job->src = static_cast<const unsigned char *>(src);
+    job->size = n;
+    job->chunkCount = chunkCount;
+    job->chunkSize = (n + chunkCount - 1) / chunkCount;
+
+    // 队列已满时不等待，剩余的块由调用线程完成
+    for (size_t i = 1; i < chunkCount; ++i) {
+        if (!pool.trySubmit([job](std::stop_token) { job->work(); })) {
+            break;
+        }
+    }
+    job->work();
+
+    // 等待已被工作线程领取的块完成
+    size_t done;
+    while ((done = job->done.load(std::memory_order_acquire)) != chunkCount) {
+        job->done.wait(done, std::memory_order_acquire);
+    }
+    return dest;
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <stddef.h>
+
+class ThreadPool;
+
+// 低于该长度时拆分与同步的开销大于多线程带来的带宽收益，直接单线程拷贝
+constexpr size_t kParallelMemcpyCutoff = 4 * 1024 * 1024;
+
+// 把大块拷贝按目标地址的页边界切分，由线程池的工作线程和调用线程共同完成。
+// 调用线程也参与拷贝，线程池繁忙、已停止或任务队列已满时会自行完成剩余部分，
+// 因此在工作线程中调用也不会死锁。源和目标不能重叠
+void *parallel_memcpy(void *dest,
+                      const void *src,
+                      size_t n,
+                      ThreadPool &pool,
+                      size_t cutoff = kParallelMemcpyCutoff);
@@ -1,7 +1,17 @@
-#include "openssl_common.hpp"
+#include "openssl_aesmodes.hpp"
+#include "openssl_aesstream.hpp"
+#include "openssl_context.hpp"
+
+#include <Thread/threadpool.hpp>
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <span>
+#include <sstream>
 #include <stdexcept>
 
 AesKey generateAesKey()
@@ -29,67 +39,52 @@ std::string aesEncryptWithIV(const std::string &key,
                                     + std::to_string(key.length()));
     }
 
-    EVP_CIPHER_CTX *ctx = EVP_CIPHER_CTX_new();
-    if (!ctx)
-        handleOpenSSLError();
-
     // 使用提供的IV或生成随机IV
     unsigned char actual_iv[16];
     if (iv.empty()) {
         if (RAND_bytes(actual_iv, sizeof(actual_iv)) != 1) {
-            EVP_CIPHER_CTX_free(ctx);
             handleOpenSSLError();
         }
     } else {
         if (iv.length() != 16) {
-            EVP_CIPHER_CTX_free(ctx);
             throw std::invalid_argument("IV must be 16 bytes (128-bit)");
         }
         memcpy(actual_iv, iv.data(), 16);
     }
 
-    std::string encrypted;
-    try {
-        if (EVP_EncryptInit_ex(ctx,
-                               EVP_aes_256_cbc(),
-                               nullptr,
-                               reinterpret_cast<const unsigned char *>(key.data()),
-                               actual_iv)
-            != 1) {
-            throw std::runtime_error("EVP_EncryptInit_ex failed");
-        }
-
-        int len;
-        encrypted.resize(plaintext.size() + AES_BLOCK_SIZE);
-
-        if (EVP_EncryptUpdate(ctx,
-                              reinterpret_cast<unsigned char *>(encrypted.data()),
-                              &len,
-                              reinterpret_cast<const unsigned char *>(plaintext.data()),
-                              plaintext.size())
-            != 1) {
-            throw std::runtime_error("EVP_EncryptUpdate failed");
-        }
-        int encrypted_len = len;
-
-        if (EVP_EncryptFinal_ex(ctx, reinterpret_cast<unsigned char *>(encrypted.data()) + len, &len)
-            != 1) {
-            throw std::runtime_error("EVP_EncryptFinal_ex failed");
-        }
-        encrypted_len += len;
-
-        encrypted.resize(encrypted_len);
+    // 复用本线程缓存的上下文，离开作用域时 reset 并归还
+    CipherContextCache::Lease ctx;
+    if (EVP_EncryptInit_ex(ctx,
+                           fetchCipher(EVP_aes_256_cbc()),
+                           nullptr,
+                           reinterpret_cast<const unsigned char *>(key.data()),
+                           actual_iv)
+        != 1) {
+        throw std::runtime_error("EVP_EncryptInit_ex failed");
+    }
 
-        // 将IV添加到加密数据前面
-        std::string result(reinterpret_cast<char *>(actual_iv), sizeof(actual_iv));
-        result += encrypted;
-        encrypted = result;
+    // IV 与密文直接写入同一个字符串，避免再拼接一次
+    std::string encrypted(sizeof(actual_iv) + plaintext.size() + AES_BLOCK_SIZE, '\0');
+    memcpy(encrypted.data(), actual_iv, sizeof(actual_iv));
+    auto *out = reinterpret_cast<unsigned char *>(encrypted.data()) + sizeof(actual_iv);
+
+    int len;
+    if (EVP_EncryptUpdate(ctx,
+                          out,
+                          &len,
+                          reinterpret_cast<const unsigned char *>(plaintext.data()),
+                          plaintext.size())
+        != 1) {
+        throw std::runtime_error("EVP_EncryptUpdate failed");
+    }
+    int encrypted_len = len;
 
-        EVP_CIPHER_CTX_free(ctx);
-    } catch (...) {
-        EVP_CIPHER_CTX_free(ctx);
-        throw;
+    if (EVP_EncryptFinal_ex(ctx, out + len, &len) != 1) {
+        throw std::runtime_error("EVP_EncryptFinal_ex failed");
     }
+    encrypted_len += len;
+
+    encrypted.resize(sizeof(actual_iv) + encrypted_len);
 
     return encrypted;
 }
@@ -109,51 +104,41 @@ std::string aesDecrypt(const std::string &key, const std::string &ciphertext)
         throw std::invalid_argument("Ciphertext too short, must contain IV and encrypted data");
     }
 
-    // 提取IV（前16字节）
-    std::string iv_str = ciphertext.substr(0, 16);
-    std::string actual_ciphertext = ciphertext.substr(16);
-
-    EVP_CIPHER_CTX *ctx = EVP_CIPHER_CTX_new();
-    if (!ctx)
-        handleOpenSSLError();
+    // 前16字节是IV，其后是密文，直接使用原缓冲区不再拷贝
+    const auto *iv = reinterpret_cast<const unsigned char *>(ciphertext.data());
+    const size_t actual_size = ciphertext.size() - 16;
+
+    CipherContextCache::Lease ctx;
+    if (EVP_DecryptInit_ex(ctx,
+                           fetchCipher(EVP_aes_256_cbc()),
+                           nullptr,
+                           reinterpret_cast<const unsigned char *>(key.data()),
+                           iv)
+        != 1) {
+        throw std::runtime_error("EVP_DecryptInit_ex failed");
+    }
 
+    int len;
     std::string decrypted;
-    try {
-        if (EVP_DecryptInit_ex(ctx,
-                               EVP_aes_256_cbc(),
-                               nullptr,
-                               reinterpret_cast<const unsigned char *>(key.data()),
-                               reinterpret_cast<const unsigned char *>(iv_str.data()))
-            != 1) {
-            throw std::runtime_error("EVP_DecryptInit_ex failed");
-        }
-
-        int len;
-        decrypted.resize(actual_ciphertext.size() + AES_BLOCK_SIZE);
-
-        if (EVP_DecryptUpdate(ctx,
-                              reinterpret_cast<unsigned char *>(decrypted.data()),
-                              &len,
-                              reinterpret_cast<const unsigned char *>(actual_ciphertext.data()),
-                              actual_ciphertext.size())
-            != 1) {
-            throw std::runtime_error("EVP_DecryptUpdate failed");
-        }
-        int decrypted_len = len;
-
-        if (EVP_DecryptFinal_ex(ctx, reinterpret_cast<unsigned char *>(decrypted.data()) + len, &len)
-            != 1) {
-            throw std::runtime_error("EVP_DecryptFinal_ex failed");
-        }
-        decrypted_len += len;
-
-        decrypted.resize(decrypted_len);
+    decrypted.resize(actual_size + AES_BLOCK_SIZE);
+
+    if (EVP_DecryptUpdate(ctx,
+                          reinterpret_cast<unsigned char *>(decrypted.data()),
+                          &len,
+                          iv + 16,
+                          actual_size)
+        != 1) {
+        throw std::runtime_error("EVP_DecryptUpdate failed");
+    }
+    int decrypted_len = len;
 
-        EVP_CIPHER_CTX_free(ctx);
-    } catch (...) {
-        EVP_CIPHER_CTX_free(ctx);
-        throw;
+    if (EVP_DecryptFinal_ex(ctx, reinterpret_cast<unsigned char *>(decrypted.data()) + len, &len)
+        != 1) {
+        throw std::runtime_error("EVP_DecryptFinal_ex failed");
     }
+    decrypted_len += len;
+
+    decrypted.resize(decrypted_len);
 
     return decrypted;
 }
@@ -396,6 +381,508 @@ TEST_F(AesTest, WithHexConversion)
     EXPECT_EQ(decrypted, testPlaintext);
 }
 
+// 测试上下文复用：上下文在本线程内归还后被下一次调用复用，且不会残留上一次的密钥
+TEST_F(AesTest, ContextReuse)
+{
+    std::string encrypted = aesEncrypt(aesKey.key, testPlaintext);
+    const size_t cached = CipherContextCache::cachedCount();
+    EXPECT_GE(cached, 1u);
+
+    AesKey otherKey = generateAesKey();
+    for (int i = 0; i < 10; ++i) {
+        std::string other = aesEncrypt(otherKey.key, testPlaintext);
+        EXPECT_EQ(aesDecrypt(otherKey.key, other), testPlaintext);
+        EXPECT_EQ(aesDecrypt(aesKey.key, encrypted), testPlaintext);
+    }
+    // 串行调用不会让缓存增长
+    EXPECT_EQ(CipherContextCache::cachedCount(), cached);
+
+    // 同一线程内嵌套借用时拿到不同的上下文
+    {
+        CipherContextCache::Lease outer;
+        CipherContextCache::Lease inner;
+        EXPECT_NE(outer.get(), inner.get());
+    }
+
+    EXPECT_EQ(fetchCipher(EVP_aes_256_cbc()), fetchCipher(EVP_aes_256_cbc()));
+    EXPECT_EQ(EVP_CIPHER_get_key_length(fetchCipher(EVP_aes_256_cbc())), 32);
+}
+
+namespace {
+
+auto bytesOf(const std::string &str) -> std::span<const std::byte>
+{
+    return std::as_bytes(std::span(str));
+}
+
+auto writableBytes(std::string &str) -> std::span<std::byte>
+{
+    return std::as_writable_bytes(std::span(str));
+}
+
+} // namespace
+
+// 测试AES-GCM已知答案（GCM 规范测试用例 16：AES-256，60 字节明文，20 字节附加数据）
+TEST_F(AesTest, GcmKnownAnswer)
+{
+    const std::string key = fromHex(
+        "feffe9928665731c6d6a8f9467308308feffe9928665731c6d6a8f9467308308");
+    const std::string iv = fromHex("cafebabefacedbaddecaf888");
+    const std::string plaintext = fromHex(
+        "d9313225f88406e5a55909c5aff5269a86a7a9531534f7da2e4c303d8a318a72"
+        "1c3c0c95956809532fcf0e2449a6b525b16aedf5aa0de657ba637b39");
+    const std::string aad = fromHex("feedfacedeadbeeffeedfacedeadbeefabaddad2");
+
+    AesGcm gcm(key);
+    std::string sealed(AesGcm::sealedSize(plaintext.size()), '\0');
+    ASSERT_EQ(gcm.encryptWithIv(bytesOf(iv),
+                                bytesOf(plaintext),
+                                writableBytes(sealed),
+                                bytesOf(aad)),
+              sealed.size());
+    EXPECT_EQ(toHex(sealed),
+              "cafebabefacedbaddecaf888"
+              "522dc1f099567d07f47f37a32a84427d643a8cdcbfe5c0c97598a2bd2555d1aa"
+              "8cb08e48590dbb3da7b08b1056828838c5f61e6393ba7a0abcc9f662"
+              "76fc6ece0f4e1768cddf8853bb2d551b");
+
+    std::string opened(AesGcm::openedSize(sealed.size()), '\0');
+    ASSERT_EQ(gcm.decrypt(bytesOf(sealed), writableBytes(opened), bytesOf(aad)), plaintext.size());
+    EXPECT_EQ(opened, plaintext);
+}
+
+// 测试AES-CTR已知答案（NIST SP 800-38A F.5.5 CTR-AES256 前两个分组）
+TEST_F(AesTest, CtrKnownAnswer)
+{
+    AesCtr ctr(fromHex("603deb1015ca71be2b73aef0857d77811f352c073b6108d72d9810a30914dff4"));
+    const std::string iv = fromHex("f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff");
+    const std::string plaintext = fromHex(
+        "6bc1bee22e409f96e93d7e117393172aae2d8a571e03ac9c9eb76fac45af8e51");
+
+    std::string sealed(AesCtr::sealedSize(plaintext.size()), '\0');
+    ctr.encryptWithIv(bytesOf(iv), bytesOf(plaintext), writableBytes(sealed));
+    EXPECT_EQ(toHex(sealed.substr(AesCtr::kIvSize)),
+              "601ec313775789a5b7a7f504bbf3d228f443e3ca4d62b59aca84e990cacaf5c5");
+
+    std::string opened(plaintext.size(), '\0');
+    EXPECT_EQ(ctr.decrypt(bytesOf(sealed), writableBytes(opened)), plaintext.size());
+    EXPECT_EQ(opened, plaintext);
+}
+
+// 测试GCM/CTR各种长度的往返，包括原地加解密
+TEST_F(AesTest, GcmCtrRoundTripInPlace)
+{
+    AesGcm gcm(aesKey.key);
+    AesCtr ctr(aesKey.key);
+
+    for (size_t size : {0, 1, 15, 16, 17, 255, 4096, 1 << 20}) {
+        std::string data(size, '\0');
+        for (size_t i = 0; i < size; ++i) {
+            data[i] = static_cast<char>(i * 131 + 7);
+        }
+
+        // 普通加解密：随机 IV，两次结果不同
+        std::string sealed1(AesGcm::sealedSize(size), '\0');
+        std::string sealed2(AesGcm::sealedSize(size), '\0');
+        gcm.encrypt(bytesOf(data), writableBytes(sealed1));
+        gcm.encrypt(bytesOf(data), writableBytes(sealed2));
+        EXPECT_NE(sealed1, sealed2);
+        std::string opened(size, '\0');
+        EXPECT_EQ(gcm.decrypt(bytesOf(sealed1), writableBytes(opened)), size);
+        EXPECT_EQ(opened, data);
+
+        // 原地：明文预先放在 IV 之后，加密后整个缓冲区就是 IV ‖ 密文 ‖ 标签
+        std::string buffer(AesGcm::sealedSize(size), '\0');
+        std::copy(data.begin(), data.end(), buffer.begin() + AesGcm::kIvSize);
+        auto whole = writableBytes(buffer);
+        gcm.encrypt(whole.subspan(AesGcm::kIvSize, size), whole);
+        gcm.decrypt(whole, whole.subspan(AesGcm::kIvSize, size));
+        EXPECT_EQ(buffer.substr(AesGcm::kIvSize, size), data);
+
+        std::string ctrBuffer(AesCtr::sealedSize(size), '\0');
+        std::copy(data.begin(), data.end(), ctrBuffer.begin() + AesCtr::kIvSize);
+        auto ctrWhole = writableBytes(ctrBuffer);
+        EXPECT_EQ(ctr.encrypt(ctrWhole.subspan(AesCtr::kIvSize, size), ctrWhole), ctrBuffer.size());
+        if (size >= 16) {
+            EXPECT_NE(ctrBuffer.substr(AesCtr::kIvSize), data);
+        }
+        EXPECT_EQ(ctr.decrypt(ctrWhole, ctrWhole.subspan(AesCtr::kIvSize, size)), size);
+        EXPECT_EQ(ctrBuffer.substr(AesCtr::kIvSize), data);
+    }
+}
+
+// 测试GCM篡改检测：IV、密文、标签或附加数据任意一位被改动都会认证失败，且不输出明文
+TEST_F(AesTest, GcmTamperDetection)
+{
+    AesGcm gcm(aesKey.key);
+    const std::string aad = "header";
+    std::string sealed(AesGcm::sealedSize(testPlaintext.size()), '\0');
+    gcm.encrypt(bytesOf(testPlaintext), writableBytes(sealed), bytesOf(aad));
+
+    for (size_t pos : {size_t{0}, AesGcm::kIvSize + 3, sealed.size() - 1}) {
+        std::string corrupted = sealed;
+        corrupted[pos] = static_cast<char>(corrupted[pos] ^ 0x01);
+        std::string opened(testPlaintext.size(), 'q');
+        EXPECT_THROW(gcm.decrypt(bytesOf(corrupted), writableBytes(opened), bytesOf(aad)),
+                     AesAuthenticationError);
+        EXPECT_EQ(opened, std::string(testPlaintext.size(), '\0'));
+    }
+
+    std::string opened(testPlaintext.size(), '\0');
+    const std::string otherAad = "Header";
+    EXPECT_THROW(gcm.decrypt(bytesOf(sealed), writableBytes(opened), bytesOf(otherAad)),
+                 AesAuthenticationError);
+    const AesGcm otherKey(generateAesKey().key);
+    EXPECT_THROW(otherKey.decrypt(bytesOf(sealed), writableBytes(opened), bytesOf(aad)),
+                 AesAuthenticationError);
+    EXPECT_EQ(gcm.decrypt(bytesOf(sealed), writableBytes(opened), bytesOf(aad)),
+              testPlaintext.size());
+    EXPECT_EQ(opened, testPlaintext);
+}
+
+// 测试GCM/CTR参数校验
+TEST_F(AesTest, GcmCtrInvalidArguments)
+{
+    EXPECT_THROW(AesGcm(std::string(16, 'K')), std::invalid_argument);
+    EXPECT_THROW(AesCtr(std::string(64, 'K')), std::invalid_argument);
+
+    AesGcm gcm(aesKey.key);
+    AesCtr ctr(aesKey.key);
+    std::string small(AesGcm::sealedSize(testPlaintext.size()) - 1, '\0');
+    EXPECT_THROW(gcm.encrypt(bytesOf(testPlaintext), writableBytes(small)), std::invalid_argument);
+    EXPECT_THROW(ctr.encryptWithIv(bytesOf(std::string(12, 'i')),
+                                   bytesOf(testPlaintext),
+                                   writableBytes(small)),
+                 std::invalid_argument);
+    std::string tooShort(AesGcm::kOverhead - 1, '\0');
+    EXPECT_THROW(gcm.decrypt(bytesOf(tooShort), writableBytes(small)), std::invalid_argument);
+
+    // 输入与输出部分重叠时拒绝，且不会先写坏输入
+    std::string buffer = testPlaintext + std::string(AesGcm::kOverhead, '\0');
+    auto whole = writableBytes(buffer);
+    EXPECT_THROW(gcm.encrypt(whole.first(testPlaintext.size()), whole), std::invalid_argument);
+    EXPECT_EQ(buffer.substr(0, testPlaintext.size()), testPlaintext);
+}
+
+namespace {
+
+// 以不规则的块大小喂给流式加解密器，拼接全部输出
+template<typename Codec>
+auto feedInPieces(Codec &codec, const std::string &input) -> std::string
+{
+    std::string output;
+    size_t offset = 0;
+    for (size_t piece = 1; offset < input.size(); piece = piece * 7 % 4099 + 1) {
+        const size_t take = std::min(piece, input.size() - offset);
+        output += codec.update(std::string_view(input).substr(offset, take));
+        offset += take;
+    }
+    output += codec.final();
+    return output;
+}
+
+auto patternData(size_t size) -> std::string
+{
+    std::string data(size, '\0');
+    for (size_t i = 0; i < size; ++i) {
+        data[i] = static_cast<char>(i * 131 + (i >> 8));
+    }
+    return data;
+}
+
+} // namespace
+
+// 测试流式加解密：任意切分的输入与一次性输入得到可互相解密的结果，GCM 输出长度符合分段格式
+TEST_F(AesTest, StreamRoundTrip)
+{
+    constexpr size_t segment = 1000;
+    for (AesStreamMode mode : {AesStreamMode::Gcm, AesStreamMode::Ctr}) {
+        for (size_t size : {size_t{0}, size_t{1}, segment - 1, segment, segment + 1, 3 * segment,
+                            3 * segment + 5, size_t{100000}}) {
+            const std::string data = patternData(size);
+
+            AesStreamEncryptor encryptor(aesKey.key, mode, segment);
+            const std::string sealed = feedInPieces(encryptor, data);
+            const size_t segments = size == 0 ? 1 : (size + segment - 1) / segment;
+            const size_t tags = mode == AesStreamMode::Gcm ? segments * AesGcm::kTagSize : 0;
+            const size_t expected = kAesStreamHeaderSize + size + tags;
+            EXPECT_EQ(sealed.size(), expected) << "size " << size;
+
+            AesStreamDecryptor piecewise(aesKey.key, mode);
+            EXPECT_EQ(feedInPieces(piecewise, sealed), data) << "size " << size;
+
+            AesStreamDecryptor whole(aesKey.key, mode);
+            std::string opened = whole.update(sealed);
+            opened += whole.final();
+            EXPECT_EQ(opened, data);
+            EXPECT_EQ(whole.segmentSize(), segment);
+        }
+    }
+
+    // 同样的明文两次加密使用不同的 nonce
+    AesStreamEncryptor first(aesKey.key);
+    AesStreamEncryptor second(aesKey.key);
+    std::string firstSealed = first.update(testPlaintext);
+    firstSealed += first.final();
+    std::string secondSealed = second.update(testPlaintext);
+    secondSealed += second.final();
+    EXPECT_NE(firstSealed, secondSealed);
+}
+
+// 测试流式GCM逐段认证：篡改、调换、截断与改动头部都会被发现，且出错之前的段已经正常输出
+TEST_F(AesTest, StreamTamperDetection)
+{
+    constexpr size_t segment = 256;
+    const std::string data = patternData(4 * segment + 10);
+    AesStreamEncryptor encryptor(aesKey.key, AesStreamMode::Gcm, segment);
+    std::string sealed = encryptor.update(data);
+    sealed += encryptor.final();
+    const size_t sealedSegment = segment + AesGcm::kTagSize;
+
+    auto open = [this](const std::string &input) {
+        AesStreamDecryptor decryptor(aesKey.key);
+        std::string output = decryptor.update(input);
+        output += decryptor.final();
+        return output;
+    };
+    EXPECT_EQ(open(sealed), data);
+
+    // 第 2 段被改动：第 0、1 段照常输出，处理到第 2 段时抛出
+    {
+        std::string corrupted = sealed;
+        const size_t third = kAesStreamHeaderSize + 2 * sealedSegment;
+        corrupted[third + 17] ^= 0x20;
+        AesStreamDecryptor decryptor(aesKey.key);
+        EXPECT_EQ(decryptor.update(corrupted.substr(0, third + 1)), data.substr(0, 2 * segment));
+        EXPECT_THROW(decryptor.update(corrupted.substr(third + 1)), AesAuthenticationError);
+    }
+
+    // 调换第 0、1 段
+    std::string swapped = sealed;
+    std::copy_n(sealed.begin() + kAesStreamHeaderSize + sealedSegment,
+                sealedSegment,
+                swapped.begin() + kAesStreamHeaderSize);
+    std::copy_n(sealed.begin() + kAesStreamHeaderSize,
+                sealedSegment,
+                swapped.begin() + kAesStreamHeaderSize + sealedSegment);
+    EXPECT_THROW(open(swapped), AesAuthenticationError);
+
+    // 删除中间一段、在段边界截断、截掉最后一段的部分、只剩头部
+    std::string dropped = sealed;
+    dropped.erase(kAesStreamHeaderSize + sealedSegment, sealedSegment);
+    EXPECT_THROW(open(dropped), AesAuthenticationError);
+    EXPECT_THROW(open(sealed.substr(0, kAesStreamHeaderSize + 4 * sealedSegment)),
+                 AesAuthenticationError);
+    EXPECT_THROW(open(sealed.substr(0, sealed.size() - 1)), AesAuthenticationError);
+    EXPECT_THROW(open(sealed.substr(0, kAesStreamHeaderSize)), AesAuthenticationError);
+    EXPECT_THROW(open(sealed.substr(0, 10)), AesAuthenticationError);
+
+    // 头部的 nonce 被改动导致认证失败，格式字段被改动直接拒绝
+    std::string badNonce = sealed;
+    badNonce[kAesStreamHeaderSize - 1] ^= 0x01;
+    EXPECT_THROW(open(badNonce), AesAuthenticationError);
+    std::string badMagic = sealed;
+    badMagic[0] = 'X';
+    EXPECT_THROW(open(badMagic), std::runtime_error);
+
+    // 模式字节从 GCM 改成 CTR 不能绕过认证：期望 GCM 时拒绝，各个解密接口都一样
+    std::string ctrMode = sealed;
+    ctrMode[5] = static_cast<char>(AesStreamMode::Ctr);
+    EXPECT_THROW(open(ctrMode), AesAuthenticationError);
+    {
+        std::istringstream in(ctrMode);
+        std::ostringstream out;
+        EXPECT_THROW(decryptStream(in, out, aesKey.key), AesAuthenticationError);
+    }
+    ThreadPool pool(1);
+    std::string opened(ctrMode.size(), '\0');
+    EXPECT_THROW(decryptParallel(bytesOf(ctrMode), writableBytes(opened), aesKey.key, pool),
+                 AesAuthenticationError);
+    EXPECT_THROW(aesStreamOpenedSize(bytesOf(ctrMode)), AesAuthenticationError);
+    // 反过来期望 CTR 时也不接受 GCM 的流
+    AesStreamDecryptor expectCtr(aesKey.key, AesStreamMode::Ctr);
+    EXPECT_THROW(expectCtr.update(sealed), AesAuthenticationError);
+
+    // 错误的密钥
+    AesStreamDecryptor wrongKey(generateAesKey().key);
+    EXPECT_THROW(wrongKey.update(sealed), AesAuthenticationError);
+}
+
+// 测试文件与流的流式加解密，解密失败时不留下输出文件
+TEST_F(AesTest, EncryptFileAndStream)
+{
+    const auto dir = std::filesystem::temp_directory_path();
+    const auto plainPath = (dir / "openssl_aes_stream_plain.bin").string();
+    const auto sealedPath = (dir / "openssl_aes_stream_sealed.bin").string();
+    const auto openedPath = (dir / "openssl_aes_stream_opened.bin").string();
+
+    // 超过一个 4 MiB 读块，且不是分段大小的整数倍
+    const std::string data = patternData((9 << 20) + 12345);
+    std::ofstream(plainPath, std::ios::binary)
+        .write(data.data(), static_cast<std::streamsize>(data.size()));
+
+    auto readAll = [](const std::string &path) {
+        std::ifstream in(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(in), {});
+    };
+
+    for (AesStreamMode mode : {AesStreamMode::Gcm, AesStreamMode::Ctr}) {
+        encryptFile(plainPath, sealedPath, aesKey.key, mode);
+        const std::string sealed = readAll(sealedPath);
+        EXPECT_GT(sealed.size(), data.size());
+        decryptFile(sealedPath, openedPath, aesKey.key, mode);
+        EXPECT_EQ(readAll(openedPath), data);
+
+        // 文件格式与内存中的流式接口一致
+        std::istringstream in(sealed);
+        std::ostringstream out;
+        decryptStream(in, out, aesKey.key, mode);
+        EXPECT_EQ(out.str(), data);
+    }
+
+    std::istringstream in(data);
+    std::stringstream sealedStream;
+    encryptStream(in, sealedStream, aesKey.key, AesStreamMode::Gcm, 1 << 20);
+    std::ostringstream opened;
+    decryptStream(sealedStream, opened, aesKey.key);
+    EXPECT_EQ(opened.str(), data);
+
+    // GCM 文件中间被改动：抛出认证失败并删除输出文件
+    encryptFile(plainPath, sealedPath, aesKey.key);
+    {
+        std::fstream file(sealedPath, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(5 << 20);
+        file.put('\x7f');
+    }
+    std::remove(openedPath.c_str());
+    EXPECT_THROW(decryptFile(sealedPath, openedPath, aesKey.key), AesAuthenticationError);
+    EXPECT_FALSE(std::filesystem::exists(openedPath));
+
+    EXPECT_THROW(encryptFile(plainPath + ".missing", sealedPath, aesKey.key), std::runtime_error);
+
+    std::remove(plainPath.c_str());
+    std::remove(sealedPath.c_str());
+    std::remove(openedPath.c_str());
+}
+
+// 测试并行分段加解密：与流式接口格式相同、可以互相解密，pool 停止时在调用线程完成
+TEST_F(AesTest, ParallelSegmented)
+{
+    ThreadPool pool(3);
+    ThreadPool stopped(1);
+    stopped.shutdown();
+
+    for (AesStreamMode mode : {AesStreamMode::Gcm, AesStreamMode::Ctr}) {
+        for (size_t segment : {size_t{4096}, kAesParallelSegmentSize}) {
+            for (size_t size : {0, 1, 4096, (5 << 20) + 7}) {
+                const std::string data = patternData(size);
+                const auto bytes = std::as_bytes(std::span(data));
+
+                std::vector<std::byte> sealed(aesStreamSealedSize(size, mode, segment));
+                EXPECT_EQ(encryptParallel(bytes, sealed, aesKey.key, pool, mode, segment),
+                          sealed.size());
+                EXPECT_EQ(aesStreamOpenedSize(sealed, mode), size);
+
+                AesStreamDecryptor decryptor(aesKey.key, mode);
+                std::string opened(decryptor.updateBound(sealed.size()), '\0');
+                size_t written = decryptor.update(sealed, writableBytes(opened));
+                written += decryptor.final(writableBytes(opened).subspan(written));
+                opened.resize(written);
+                EXPECT_EQ(opened, data) << "size " << size;
+
+                // 流式加密的结果交给并行解密
+                AesStreamEncryptor encryptor(aesKey.key, mode, segment);
+                std::string streamed = encryptor.update(data);
+                streamed += encryptor.final();
+                std::string parallel(aesStreamOpenedSize(bytesOf(streamed), mode), '\0');
+                EXPECT_EQ(decryptParallel(bytesOf(streamed), writableBytes(parallel), aesKey.key,
+                                          stopped, mode),
+                          size);
+                EXPECT_EQ(parallel, data);
+            }
+        }
+    }
+}
+
+// 测试并行GCM解密的认证：任何一段被改动或整体被截断都会失败，并清零全部输出
+TEST_F(AesTest, ParallelTamperDetection)
+{
+    ThreadPool pool(3);
+    constexpr size_t segment = 64 << 10;
+    const std::string data = patternData(20 * segment + 100);
+    std::vector<std::byte> sealed(aesStreamSealedSize(data.size(), AesStreamMode::Gcm, segment));
+    encryptParallel(bytesOf(data), sealed, aesKey.key, pool, AesStreamMode::Gcm, segment);
+
+    std::vector<std::byte> opened(data.size());
+    EXPECT_EQ(decryptParallel(sealed, opened, aesKey.key, pool), data.size());
+
+    auto corrupted = sealed;
+    corrupted[kAesStreamHeaderSize + 13 * (segment + AesGcm::kTagSize) + 5] ^= std::byte{0x40};
+    EXPECT_THROW(decryptParallel(corrupted, opened, aesKey.key, pool), AesAuthenticationError);
+    EXPECT_TRUE(std::all_of(opened.begin(), opened.end(), [](std::byte b) {
+        return b == std::byte{0};
+    }));
+
+    // 截掉最后一段的一部分；截到只剩不足一个标签的尾巴时连长度都不合法
+    const auto truncated = std::span(sealed).first(sealed.size() - 1);
+    EXPECT_THROW(decryptParallel(truncated, opened, aesKey.key, pool), AesAuthenticationError);
+    const auto ragged = std::span(sealed).first(sealed.size() - 100 - 8);
+    EXPECT_THROW(aesStreamOpenedSize(ragged), AesAuthenticationError);
+    EXPECT_THROW(decryptParallel(std::span(sealed).first(20), opened, aesKey.key, pool),
+                 AesAuthenticationError);
+
+    // 输出缓冲区不足或与输入重叠
+    std::vector<std::byte> small(data.size() - 1);
+    EXPECT_THROW(decryptParallel(sealed, small, aesKey.key, pool), std::invalid_argument);
+    EXPECT_THROW(encryptParallel(std::span(sealed).first(100), sealed, aesKey.key, pool),
+                 std::invalid_argument);
+}
+
+// 测试并行文件加解密与单线程文件接口互通
+TEST_F(AesTest, ParallelFile)
+{
+    ThreadPool pool(3);
+    const auto dir = std::filesystem::temp_directory_path();
+    const auto plainPath = (dir / "openssl_aes_parallel_plain.bin").string();
+    const auto sealedPath = (dir / "openssl_aes_parallel_sealed.bin").string();
+    const auto openedPath = (dir / "openssl_aes_parallel_opened.bin").string();
+
+    auto readAll = [](const std::string &path) {
+        std::ifstream in(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(in), {});
+    };
+
+    for (size_t size : {0, (3 << 20) + 3}) {
+        const std::string data = patternData(size);
+        std::ofstream(plainPath, std::ios::binary)
+            .write(data.data(), static_cast<std::streamsize>(data.size()));
+
+        encryptFileParallel(plainPath, sealedPath, aesKey.key, pool);
+        decryptFile(sealedPath, openedPath, aesKey.key);
+        EXPECT_EQ(readAll(openedPath), data);
+
+        encryptFile(plainPath, sealedPath, aesKey.key, AesStreamMode::Ctr);
+        decryptFileParallel(sealedPath, openedPath, aesKey.key, pool, AesStreamMode::Ctr);
+        EXPECT_EQ(readAll(openedPath), data);
+    }
+
+    // 密文被改动时不留下输出文件
+    encryptFileParallel(plainPath, sealedPath, aesKey.key, pool);
+    {
+        std::fstream file(sealedPath, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(2 << 20);
+        file.put('\x01');
+    }
+    std::remove(openedPath.c_str());
+    EXPECT_THROW(decryptFileParallel(sealedPath, openedPath, aesKey.key, pool),
+                 AesAuthenticationError);
+    EXPECT_FALSE(std::filesystem::exists(openedPath));
+
+    std::remove(plainPath.c_str());
+    std::remove(sealedPath.c_str());
+    std::remove(openedPath.c_str());
+}
+
 int main(int argc, char **argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,275 @@
+#include "openssl_aesmodes.hpp"
+#include "openssl_context.hpp"
+#include "openssl_utils.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+namespace {
+
+using OpenSSLUtils::kMaxUpdate;
+using OpenSSLUtils::toUChar;
+
+void copyKey(std::span<const std::byte> key, unsigned char *out)
+{
+    OpenSSLUtils::checkKeySize(key.size());
+    std::memcpy(out, key.data(), kAesKeySize);
+}
+
+void checkIv(std::span<const std::byte> iv, size_t expected)
+{
+    if (iv.size() != expected) {
+        throw std::invalid_argument("IV must be " + std::to_string(expected) + " bytes, got: "
+                                    + std::to_string(iv.size()));
+    }
+}
+
+// 输出与输入要么完全重合（原地），要么互不重叠
+void checkBuffers(std::span<const std::byte> in, std::span<std::byte> out)
+{
+    if (out.size() < in.size()) {
+        throw std::invalid_argument("Output buffer too small");
+    }
+    const std::byte *inBegin = in.data();
+    const std::byte *outBegin = out.data();
+    if (inBegin != outBegin && inBegin < outBegin + in.size() && outBegin < inBegin + in.size()) {
+        throw std::invalid_argument("Input and output buffers partially overlap");
+    }
+}
+
+void update(EVP_CIPHER_CTX *ctx, bool encrypt, const std::byte *in, size_t size, std::byte *out)
+{
+    while (size > 0) {
+        const size_t chunk = std::min(size, kMaxUpdate);
+        int len = 0;
+        const int ok = encrypt
+                           ? EVP_EncryptUpdate(ctx, toUChar(out), &len, toUChar(in), int(chunk))
+                           : EVP_DecryptUpdate(ctx, toUChar(out), &len, toUChar(in), int(chunk));
+        if (ok != 1) {
+            handleOpenSSLError();
+        }
+        in += chunk;
+        out += chunk;
+        size -= chunk;
+    }
+}
+
+void updateAad(EVP_CIPHER_CTX *ctx, bool encrypt, std::span<const std::byte> aad)
+{
+    // out 为空时数据只参与认证
+    while (!aad.empty()) {
+        const size_t chunk = std::min(aad.size(), kMaxUpdate);
+        int len = 0;
+        const int ok = encrypt
+                           ? EVP_EncryptUpdate(ctx, nullptr, &len, toUChar(aad.data()), int(chunk))
+                           : EVP_DecryptUpdate(ctx, nullptr, &len, toUChar(aad.data()), int(chunk));
+        if (ok != 1) {
+            handleOpenSSLError();
+        }
+        aad = aad.subspan(chunk);
+    }
+}
+
+void randomIv(std::byte *iv, size_t size)
+{
+    if (RAND_bytes(toUChar(iv), static_cast<int>(size)) != 1) {
+        handleOpenSSLError();
+    }
+}
+
+} // namespace
+
+AesGcm::AesGcm(std::span<const std::byte> key)
+{
+    copyKey(key, m_key);
+}
+
+AesGcm::AesGcm(std::string_view key)
+    : AesGcm(std::as_bytes(std::span(key)))
+{}
+
+AesGcm::~AesGcm()
+{
+    OPENSSL_cleanse(m_key, sizeof(m_key));
+}
+
+size_t AesGcm::encrypt(std::span<const std::byte> in,
+                       std::span<std::byte> out,
+                       std::span<const std::byte> aad) const
+{
+    if (out.size() < sealedSize(in.size())) {
+        throw std::invalid_argument("Output buffer too small for AES-GCM");
+    }
+    // 写 IV 之前先检查，避免覆盖部分重叠的输入
+    checkBuffers(in, out.subspan(kIvSize, in.size()));
+    // IV 直接生成在输出缓冲区里
+    randomIv(out.data(), kIvSize);
+    seal(out.first(kIvSize),
+         in,
+         out.subspan(kIvSize, in.size()),
+         out.subspan(kIvSize + in.size(), kTagSize),
+         aad);
+    return sealedSize(in.size());
+}
+
+size_t AesGcm::encryptWithIv(std::span<const std::byte> iv,
+                             std::span<const std::byte> in,
+                             std::span<std::byte> out,
+                             std::span<const std::byte> aad) const
+{
+    checkIv(iv, kIvSize);
+    if (out.size() < sealedSize(in.size())) {
+        throw std::invalid_argument("Output buffer too small for AES-GCM");
+    }
+    // 写 IV 之前先检查，避免覆盖部分重叠的输入
+    checkBuffers(in, out.subspan(kIvSize, in.size()));
+    std::memmove(out.data(), iv.data(), kIvSize);
+    seal(out.first(kIvSize),
+         in,
+         out.subspan(kIvSize, in.size()),
+         out.subspan(kIvSize + in.size(), kTagSize),
+         aad);
+    return sealedSize(in.size());
+}
+
+size_t AesGcm::decrypt(std::span<const std::byte> in,
+                       std::span<std::byte> out,
+                       std::span<const std::byte> aad) const
+{
+    if (in.size() < kOverhead) {
+        throw std::invalid_argument("Ciphertext too short, must contain IV and tag");
+    }
+    const size_t size = openedSize(in.size());
+    open(in.first(kIvSize), in.subspan(kIvSize, size), out, in.last(kTagSize), aad);
+    return size;
+}
+
+void AesGcm::seal(std::span<const std::byte> iv,
+                  std::span<const std::byte> in,
+                  std::span<std::byte> out,
+                  std::span<std::byte> tag,
+                  std::span<const std::byte> aad) const
+{
+    checkIv(iv, kIvSize);
+    checkBuffers(in, out);
+    if (tag.size() < kTagSize) {
+        throw std::invalid_argument("Tag buffer must be 16 bytes");
+    }
+
+    CipherContextCache::Lease ctx;
+    if (EVP_EncryptInit_ex(ctx, fetchCipher(EVP_aes_256_gcm()), nullptr, m_key, toUChar(iv.data()))
+        != 1) {
+        handleOpenSSLError();
+    }
+    updateAad(ctx, true, aad);
+    update(ctx, true, in.data(), in.size(), out.data());
+
+    // GCM 的 Final 不输出数据，只计算标签
+    unsigned char tail[16];
+    int len = 0;
+    if (EVP_EncryptFinal_ex(ctx, tail, &len) != 1
+        || EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_GET_TAG, int(kTagSize), tag.data()) != 1) {
+        handleOpenSSLError();
+    }
+}
+
+void AesGcm::open(std::span<const std::byte> iv,
+                  std::span<const std::byte> in,
+                  std::span<std::byte> out,
+                  std::span<const std::byte> tag,
+                  std::span<const std::byte> aad) const
+{
+    checkIv(iv, kIvSize);
+    checkBuffers(in, out);
+    if (tag.size() != kTagSize) {
+        throw std::invalid_argument("Tag must be 16 bytes");
+    }
+    // SET_TAG 需要非 const 指针，且原地解密时不能依赖输入区域保持不变
+    unsigned char expected[kTagSize];
+    std::memcpy(expected, tag.data(), kTagSize);
+
+    CipherContextCache::Lease ctx;
+    if (EVP_DecryptInit_ex(ctx, fetchCipher(EVP_aes_256_gcm()), nullptr, m_key, toUChar(iv.data()))
+            != 1
+        || EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_SET_TAG, int(kTagSize), expected) != 1) {
+        handleOpenSSLError();
+    }
+    updateAad(ctx, false, aad);
+    update(ctx, false, in.data(), in.size(), out.data());
+
+    unsigned char tail[16];
+    int len = 0;
+    if (EVP_DecryptFinal_ex(ctx, tail, &len) != 1) {
+        // 不把未经认证的明文交给调用方
+        OPENSSL_cleanse(out.data(), in.size());
+        ERR_clear_error();
+        throw AesAuthenticationError();
+    }
+}
+
+AesCtr::AesCtr(std::span<const std::byte> key)
+{
+    copyKey(key, m_key);
+}
+
+AesCtr::AesCtr(std::string_view key)
+    : AesCtr(std::as_bytes(std::span(key)))
+{}
+
+AesCtr::~AesCtr()
+{
+    OPENSSL_cleanse(m_key, sizeof(m_key));
+}
+
+size_t AesCtr::encrypt(std::span<const std::byte> in, std::span<std::byte> out) const
+{
+    if (out.size() < sealedSize(in.size())) {
+        throw std::invalid_argument("Output buffer too small for AES-CTR");
+    }
+    // 写 IV 之前先检查，避免覆盖部分重叠的输入
+    checkBuffers(in, out.subspan(kIvSize, in.size()));
+    randomIv(out.data(), kIvSize);
+    apply(out.first(kIvSize), in, out.subspan(kIvSize, in.size()));
+    return sealedSize(in.size());
+}
+
+size_t AesCtr::encryptWithIv(std::span<const std::byte> iv,
+                             std::span<const std::byte> in,
+                             std::span<std::byte> out) const
+{
+    checkIv(iv, kIvSize);
+    if (out.size() < sealedSize(in.size())) {
+        throw std::invalid_argument("Output buffer too small for AES-CTR");
+    }
+    // 写 IV 之前先检查，避免覆盖部分重叠的输入
+    checkBuffers(in, out.subspan(kIvSize, in.size()));
+    std::memmove(out.data(), iv.data(), kIvSize);
+    apply(out.first(kIvSize), in, out.subspan(kIvSize, in.size()));
+    return sealedSize(in.size());
+}
+
+size_t AesCtr::decrypt(std::span<const std::byte> in, std::span<std::byte> out) const
+{
+    if (in.size() < kOverhead) {
+        throw std::invalid_argument("Ciphertext too short, must contain IV");
+    }
+    const size_t size = openedSize(in.size());
+    apply(in.first(kIvSize), in.subspan(kIvSize, size), out);
+    return size;
+}
+
+void AesCtr::apply(std::span<const std::byte> iv,
+                   std::span<const std::byte> in,
+                   std::span<std::byte> out) const
+{
+    checkIv(iv, kIvSize);
+    checkBuffers(in, out);
+
+    CipherContextCache::Lease ctx;
+    if (EVP_EncryptInit_ex(ctx, fetchCipher(EVP_aes_256_ctr()), nullptr, m_key, toUChar(iv.data()))
+        != 1) {
+        handleOpenSSLError();
+    }
+    update(ctx, true, in.data(), in.size(), out.data());
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "openssl_common.hpp"
+
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+
+// AES-256 密钥长度
+constexpr size_t kAesKeySize = 32;
+
+// GCM 标签校验失败（密文、IV、标签或附加数据被篡改，或密钥不对）
+class AesAuthenticationError : public std::runtime_error
+{
+public:
+    AesAuthenticationError()
+        : std::runtime_error("AES-GCM authentication failed")
+    {}
+};
+
+// AES-256-GCM 认证加密。输出格式为 IV(12) ‖ 密文 ‖ 标签(16)，直接写入调用方提供的缓冲区，
+// 不做任何中间分配与拷贝。OpenSSL 在支持的 CPU 上自动使用 AES-NI 与 PCLMULQDQ。
+// 原地加密时 in 应恰好位于 out.data() + kIvSize，原地解密时 out 恰好位于 in.data() + kIvSize，
+// 其他情况下输入与输出不能重叠。
+// 参数长度不对时抛出 std::invalid_argument，OpenSSL 出错时抛出 std::runtime_error
+class AesGcm
+{
+public:
+    static constexpr size_t kIvSize = 12;
+    static constexpr size_t kTagSize = 16;
+    static constexpr size_t kOverhead = kIvSize + kTagSize;
+
+    explicit AesGcm(std::span<const std::byte> key);
+    explicit AesGcm(std::string_view key);
+    ~AesGcm();
+
+    AesGcm(const AesGcm &) = default;
+    AesGcm &operator=(const AesGcm &) = default;
+
+    static constexpr size_t sealedSize(size_t plaintextSize) { return plaintextSize + kOverhead; }
+    static constexpr size_t openedSize(size_t sealedSize)
+    {
+        return sealedSize < kOverhead ? 0 : sealedSize - kOverhead;
+    }
+
+    // 使用随机 IV 加密，out 至少 sealedSize(in.size()) 字节，返回写入的字节数
+    size_t encrypt(std::span<const std::byte> in,
+                   std::span<std::byte> out,
+                   std::span<const std::byte> aad = {}) const;
+    // 使用指定的 IV，调用方必须保证同一密钥下 IV 不重复
+    size_t encryptWithIv(std::span<const std::byte> iv,
+                         std::span<const std::byte> in,
+                         std::span<std::byte> out,
+                         std::span<const std::byte> aad = {}) const;
+    // 解密 IV ‖ 密文 ‖ 标签，out 至少 openedSize(in.size()) 字节，返回明文长度。
+    // 认证失败时清零 out 并抛出 AesAuthenticationError
+    size_t decrypt(std::span<const std::byte> in,
+                   std::span<std::byte> out,
+                   std::span<const std::byte> aad = {}) const;
+
+    // 底层接口：密文与标签分开存放，不写 IV。out 与 in 等长
+    void seal(std::span<const std::byte> iv,
+              std::span<const std::byte> in,
+              std::span<std::byte> out,
+              std::span<std::byte> tag,
+              std::span<const std::byte> aad = {}) const;
+    void open(std::span<const std::byte> iv,
+              std::span<const std::byte> in,
+              std::span<std::byte> out,
+              std::span<const std::byte> tag,
+              std::span<const std::byte> aad = {}) const;
+
+private:
+    unsigned char m_key[kAesKeySize];
+};
+
+// AES-256-CTR 流加密，输出格式为 IV(16) ‖ 密文，密文与明文等长。
+// 只提供机密性，不防篡改，需要完整性时使用 AesGcm
+class AesCtr
+{
+public:
+    static constexpr size_t kIvSize = 16;
+    static constexpr size_t kOverhead = kIvSize;
+
+    explicit AesCtr(std::span<const std::byte> key);
+    explicit AesCtr(std::string_view key);
+    ~AesCtr();
+
+    AesCtr(const AesCtr &) = default;
+    AesCtr &operator=(const AesCtr &) = default;
+
+    static constexpr size_t sealedSize(size_t plaintextSize) { return plaintextSize + kOverhead; }
+    static constexpr size_t openedSize(size_t sealedSize)
+    {
+        return sealedSize < kOverhead ? 0 : sealedSize - kOverhead;
+    }
+
+    size_t encrypt(std::span<const std::byte> in, std::span<std::byte> out) const;
+    size_t encryptWithIv(std::span<const std::byte> iv,
+                         std::span<const std::byte> in,
+                         std::span<std::byte> out) const;
+    size_t decrypt(std::span<const std::byte> in, std::span<std::byte> out) const;
+
+    // 底层接口：用 iv 起始的密钥流异或 in 写入 out（加密与解密是同一个操作），out 与 in 等长
+    void apply(std::span<const std::byte> iv,
+               std::span<const std::byte> in,
+               std::span<std::byte> out) const;
+
+private:
+    unsigned char m_key[kAesKeySize];
+};
@@ -0,0 +1,942 @@
+#include "openssl_aesstream.hpp"
+#include "openssl_parallel.hpp"
+#include "openssl_utils.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr char kMagic[4] = {'C', 'X', 'A', 'S'};
+constexpr uint8_t kVersion = 1;
+constexpr size_t kNonceOffset = 16;
+constexpr size_t kSegmentAadSize = kAesStreamHeaderSize + 8 + 1;
+
+// 文件加解密每次读入的块大小
+constexpr size_t kFileChunk = 4 << 20;
+
+using Header = std::array<std::byte, kAesStreamHeaderSize>;
+
+using OpenSSLUtils::kMaxUpdate;
+using OpenSSLUtils::toUChar;
+
+void storeLe32(std::byte *p, uint32_t value)
+{
+    for (int i = 0; i < 4; ++i) {
+        p[i] = static_cast<std::byte>(value >> (8 * i));
+    }
+}
+
+auto loadLe32(const std::byte *p) -> uint32_t
+{
+    uint32_t value = 0;
+    for (int i = 0; i < 4; ++i) {
+        value |= static_cast<uint32_t>(p[i]) << (8 * i);
+    }
+    return value;
+}
+
+auto buildHeader(AesStreamMode mode, size_t segmentSize) -> Header
+{
+    Header header{};
+    std::memcpy(header.data(), kMagic, sizeof(kMagic));
+    header[4] = static_cast<std::byte>(kVersion);
+    header[5] = static_cast<std::byte>(mode);
+    storeLe32(header.data() + 8, static_cast<uint32_t>(segmentSize));
+    // GCM 只使用前 12 字节作为基础 nonce，其余保持为 0
+    const int nonceSize = mode == AesStreamMode::Gcm ? int(AesGcm::kIvSize) : int(AesCtr::kIvSize);
+    if (RAND_bytes(toUChar(header.data() + kNonceOffset), nonceSize) != 1) {
+        handleOpenSSLError();
+    }
+    return header;
+}
+
+struct HeaderInfo
+{
+    AesStreamMode mode;
+    size_t segmentSize;
+};
+
+// 模式由调用方指定而不是从头部读出：CTR 不做认证，否则改一个字节就能关掉 GCM 的标签校验
+auto parseHeader(const Header &header, AesStreamMode expected) -> HeaderInfo
+{
+    const auto mode = static_cast<AesStreamMode>(header[5]);
+    const size_t segmentSize = loadLe32(header.data() + 8);
+    const bool reservedZero = header[6] == std::byte{0} && header[7] == std::byte{0}
+                              && loadLe32(header.data() + 12) == 0;
+    if (std::memcmp(header.data(), kMagic, sizeof(kMagic)) != 0
+        || header[4] != static_cast<std::byte>(kVersion)
+        || (mode != AesStreamMode::Gcm && mode != AesStreamMode::Ctr) || !reservedZero
+        || segmentSize == 0 || segmentSize > kAesStreamMaxSegmentSize) {
+        throw std::runtime_error("Invalid AES stream header");
+    }
+    if (mode != expected) {
+        throw AesAuthenticationError();
+    }
+    return {mode, segmentSize};
+}
+
+void checkSegmentSize(size_t segmentSize)
+{
+    if (segmentSize == 0 || segmentSize > kAesStreamMaxSegmentSize) {
+        throw std::invalid_argument("AES stream segment size must be in (0, "
+                                    + std::to_string(kAesStreamMaxSegmentSize) + "], got: "
+                                    + std::to_string(segmentSize));
+    }
+}
+
+// IV[i] = nonce 的后 8 字节与 be64(i) 异或
+auto segmentIv(const Header &header, uint64_t index) -> std::array<unsigned char, AesGcm::kIvSize>
+{
+    std::array<unsigned char, AesGcm::kIvSize> iv;
+    std::memcpy(iv.data(), header.data() + kNonceOffset, iv.size());
+    for (int i = 0; i < 8; ++i) {
+        iv[AesGcm::kIvSize - 1 - i] ^= static_cast<unsigned char>(index >> (8 * i));
+    }
+    return iv;
+}
+
+auto segmentAad(const Header &header, uint64_t index, bool final)
+    -> std::array<unsigned char, kSegmentAadSize>
+{
+    std::array<unsigned char, kSegmentAadSize> aad;
+    std::memcpy(aad.data(), header.data(), header.size());
+    for (int i = 0; i < 8; ++i) {
+        aad[header.size() + i] = static_cast<unsigned char>(index >> (8 * i));
+    }
+    aad[kSegmentAadSize - 1] = final ? 1 : 0;
+    return aad;
+}
+
+// ctx 已经用密钥初始化过，每段只换 IV，不重新展开密钥
+void gcmSeal(EVP_CIPHER_CTX *ctx,
+             const Header &header,
+             uint64_t index,
+             bool final,
+             std::span<const std::byte> in,
+             std::byte *out)
+{
+    const auto iv = segmentIv(header, index);
+    const auto aad = segmentAad(header, index, final);
+    unsigned char tail[16];
+    int len = 0;
+    if (EVP_EncryptInit_ex(ctx, nullptr, nullptr, nullptr, iv.data()) != 1
+        || EVP_EncryptUpdate(ctx, nullptr, &len, aad.data(), int(aad.size())) != 1
+        || EVP_EncryptUpdate(ctx, toUChar(out), &len, toUChar(in.data()), int(in.size())) != 1
+        || EVP_EncryptFinal_ex(ctx, tail, &len) != 1
+        || EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_GET_TAG, int(AesGcm::kTagSize), out + in.size())
+               != 1) {
+        handleOpenSSLError();
+    }
+}
+
+// in 为 密文 || 标签，认证通过后才算输出有效；失败时清零 out
+void gcmOpen(EVP_CIPHER_CTX *ctx,
+             const Header &header,
+             uint64_t index,
+             bool final,
+             std::span<const std::byte> in,
+             std::byte *out)
+{
+    const size_t size = in.size() - AesGcm::kTagSize;
+    const auto iv = segmentIv(header, index);
+    const auto aad = segmentAad(header, index, final);
+    unsigned char tag[AesGcm::kTagSize];
+    std::memcpy(tag, in.data() + size, sizeof(tag));
+    int len = 0;
+    if (EVP_DecryptInit_ex(ctx, nullptr, nullptr, nullptr, iv.data()) != 1
+        || EVP_CIPHER_CTX_ctrl(ctx, EVP_CTRL_GCM_SET_TAG, int(sizeof(tag)), tag) != 1
+        || EVP_DecryptUpdate(ctx, nullptr, &len, aad.data(), int(aad.size())) != 1
+        || EVP_DecryptUpdate(ctx, toUChar(out), &len, toUChar(in.data()), int(size)) != 1) {
+        handleOpenSSLError();
+    }
+    unsigned char tail[16];
+    if (EVP_DecryptFinal_ex(ctx, tail, &len) != 1) {
+        OPENSSL_cleanse(out, size);
+        ERR_clear_error();
+        throw AesAuthenticationError();
+    }
+}
+
+void ctrUpdate(EVP_CIPHER_CTX *ctx, std::span<const std::byte> in, std::byte *out)
+{
+    while (!in.empty()) {
+        const size_t chunk = std::min(in.size(), kMaxUpdate);
+        int len = 0;
+        if (EVP_EncryptUpdate(ctx, toUChar(out), &len, toUChar(in.data()), int(chunk)) != 1) {
+            handleOpenSSLError();
+        }
+        in = in.subspan(chunk);
+        out += chunk;
+    }
+}
+
+auto newKeyedContext(AesStreamMode mode,
+                     const unsigned char *key,
+                     const std::byte *nonce,
+                     bool encrypt) -> EVP_CIPHER_CTX *
+{
+    EVP_CIPHER_CTX *ctx = CipherContextCache::acquire();
+    const EVP_CIPHER *cipher = fetchCipher(mode == AesStreamMode::Gcm ? EVP_aes_256_gcm()
+                                                                      : EVP_aes_256_ctr());
+    // GCM 的 IV 每段单独设置；CTR 解密与加密是同一个操作
+    const unsigned char *iv = mode == AesStreamMode::Ctr ? toUChar(nonce) : nullptr;
+    const int ok = encrypt || mode == AesStreamMode::Ctr
+                       ? EVP_EncryptInit_ex(ctx, cipher, nullptr, key, iv)
+                       : EVP_DecryptInit_ex(ctx, cipher, nullptr, key, iv);
+    if (ok != 1) {
+        CipherContextCache::release(ctx);
+        handleOpenSSLError();
+    }
+    return ctx;
+}
+
+void checkOutput(std::span<std::byte> out, size_t bound)
+{
+    if (out.size() < bound) {
+        throw std::invalid_argument("Output buffer too small for AES stream");
+    }
+}
+
+} // namespace
+
+AesStreamEncryptor::AesStreamEncryptor(std::string_view key, AesStreamMode mode, size_t segmentSize)
+    : m_mode(mode)
+    , m_segmentSize(segmentSize)
+{
+    OpenSSLUtils::checkKeySize(key.size());
+    checkSegmentSize(segmentSize);
+    if (mode != AesStreamMode::Gcm && mode != AesStreamMode::Ctr) {
+        throw std::invalid_argument("Unknown AES stream mode");
+    }
+    m_header = buildHeader(mode, segmentSize);
+    m_ctx.reset(newKeyedContext(mode,
+                                reinterpret_cast<const unsigned char *>(key.data()),
+                                m_header.data() + kNonceOffset,
+                                true));
+}
+
+size_t AesStreamEncryptor::updateBound(size_t inputSize) const
+{
+    const size_t header = m_headerWritten ? 0 : kAesStreamHeaderSize;
+    if (m_mode == AesStreamMode::Ctr) {
+        return header + inputSize;
+    }
+    // 只有后面还有数据的整段才会在 update 中写出
+    const size_t pending = m_buffered + inputSize;
+    const size_t segments = pending == 0 ? 0 : (pending - 1) / m_segmentSize;
+    return header + segments * (m_segmentSize + AesGcm::kTagSize);
+}
+
+size_t AesStreamEncryptor::finalBound() const
+{
+    const size_t header = m_headerWritten ? 0 : kAesStreamHeaderSize;
+    return m_mode == AesStreamMode::Ctr ? header : header + m_buffered + AesGcm::kTagSize;
+}
+
+size_t AesStreamEncryptor::writeHeader(std::span<std::byte> out)
+{
+    if (m_headerWritten) {
+        return 0;
+    }
+    std::memcpy(out.data(), m_header.data(), m_header.size());
+    m_headerWritten = true;
+    return m_header.size();
+}
+
+void AesStreamEncryptor::sealSegment(std::span<const std::byte> in,
+                                     std::span<std::byte> out,
+                                     bool final)
+{
+    gcmSeal(m_ctx.get(), m_header, m_segmentIndex++, final, in, out.data());
+}
+
+size_t AesStreamEncryptor::update(std::span<const std::byte> in, std::span<std::byte> out)
+{
+    if (m_finished) {
+        throw std::logic_error("AesStreamEncryptor::update called after final");
+    }
+    checkOutput(out, updateBound(in.size()));
+    size_t written = writeHeader(out);
+
+    if (m_mode == AesStreamMode::Ctr) {
+        ctrUpdate(m_ctx.get(), in, out.data() + written);
+        return written + in.size();
+    }
+
+    const size_t sealedSize = m_segmentSize + AesGcm::kTagSize;
+    while (!in.empty()) {
+        if (m_buffered == m_segmentSize) {
+            sealSegment(std::span(m_buffer).first(m_segmentSize), out.subspan(written), false);
+            written += sealedSize;
+            m_buffered = 0;
+        }
+        // 缓冲区为空且后面还有数据时，整段直接从输入加密
+        if (m_buffered == 0 && in.size() > m_segmentSize) {
+            sealSegment(in.first(m_segmentSize), out.subspan(written), false);
+            written += sealedSize;
+            in = in.subspan(m_segmentSize);
+            continue;
+        }
+        if (m_buffer.empty()) {
+            m_buffer.resize(m_segmentSize);
+        }
+        const size_t take = std::min(m_segmentSize - m_buffered, in.size());
+        std::memcpy(m_buffer.data() + m_buffered, in.data(), take);
+        m_buffered += take;
+        in = in.subspan(take);
+    }
+    return written;
+}
+
+size_t AesStreamEncryptor::final(std::span<std::byte> out)
+{
+    if (m_finished) {
+        throw std::logic_error("AesStreamEncryptor::final called twice");
+    }
+    checkOutput(out, finalBound());
+    size_t written = writeHeader(out);
+    if (m_mode == AesStreamMode::Gcm) {
+        sealSegment(std::span(m_buffer).first(m_buffered), out.subspan(written), true);
+        written += m_buffered + AesGcm::kTagSize;
+        OPENSSL_cleanse(m_buffer.data(), m_buffered);
+        m_buffered = 0;
+    }
+    m_finished = true;
+    return written;
+}
+
+std::string AesStreamEncryptor::update(std::string_view in)
+{
+    std::string out(updateBound(in.size()), '\0');
+    out.resize(update(std::as_bytes(std::span(in)), std::as_writable_bytes(std::span(out))));
+    return out;
+}
+
+std::string AesStreamEncryptor::final()
+{
+    std::string out(finalBound(), '\0');
+    out.resize(final(std::as_writable_bytes(std::span(out))));
+    return out;
+}
+
+AesStreamDecryptor::AesStreamDecryptor(std::string_view key, AesStreamMode mode)
+    : m_mode(mode)
+{
+    OpenSSLUtils::checkKeySize(key.size());
+    if (mode != AesStreamMode::Gcm && mode != AesStreamMode::Ctr) {
+        throw std::invalid_argument("Unknown AES stream mode");
+    }
+    std::memcpy(m_key.data(), key.data(), m_key.size());
+}
+
+AesStreamDecryptor::~AesStreamDecryptor()
+{
+    OPENSSL_cleanse(m_key.data(), m_key.size());
+}
+
+size_t AesStreamDecryptor::updateBound(size_t inputSize) const
+{
+    // 明文总是不长于密文
+    return m_buffered + inputSize;
+}
+
+size_t AesStreamDecryptor::finalBound() const
+{
+    return m_buffered;
+}
+
+void AesStreamDecryptor::parseHeader()
+{
+    const HeaderInfo info = ::parseHeader(m_header, m_mode);
+    m_segmentSize = info.segmentSize;
+    m_ctx.reset(newKeyedContext(m_mode, m_key.data(), m_header.data() + kNonceOffset, false));
+    // 密钥已经进入上下文，不再需要保留
+    OPENSSL_cleanse(m_key.data(), m_key.size());
+}
+
+void AesStreamDecryptor::openSegment(std::span<const std::byte> in,
+                                     std::span<std::byte> out,
+                                     bool final)
+{
+    gcmOpen(m_ctx.get(), m_header, m_segmentIndex++, final, in, out.data());
+}
+
+size_t AesStreamDecryptor::update(std::span<const std::byte> in, std::span<std::byte> out)
+{
+    if (m_finished) {
+        throw std::logic_error("AesStreamDecryptor::update called after final");
+    }
+    checkOutput(out, updateBound(in.size()));
+
+    if (m_headerSize < m_header.size()) {
+        const size_t take = std::min(m_header.size() - m_headerSize, in.size());
+        std::memcpy(m_header.data() + m_headerSize, in.data(), take);
+        m_headerSize += take;
+        in = in.subspan(take);
+        if (m_headerSize < m_header.size()) {
+            return 0;
+        }
+        parseHeader();
+    }
+
+    if (m_mode == AesStreamMode::Ctr) {
+        ctrUpdate(m_ctx.get(), in, out.data());
+        return in.size();
+    }
+
+    // 每段要等到后面还有数据时才能确定不是最后一段，因此最多滞留一段
+    const size_t sealedSize = m_segmentSize + AesGcm::kTagSize;
+    size_t written = 0;
+    while (!in.empty()) {
+        if (m_buffered == sealedSize) {
+            openSegment(std::span(m_buffer).first(sealedSize), out.subspan(written), false);
+            written += m_segmentSize;
+            m_buffered = 0;
+        }
+        if (m_buffered == 0 && in.size() > sealedSize) {
+            openSegment(in.first(sealedSize), out.subspan(written), false);
+            written += m_segmentSize;
+            in = in.subspan(sealedSize);
+            continue;
+        }
+        if (m_buffer.empty()) {
+            m_buffer.resize(sealedSize);
+        }
+        const size_t take = std::min(sealedSize - m_buffered, in.size());
+        std::memcpy(m_buffer.data() + m_buffered, in.data(), take);
+        m_buffered += take;
+        in = in.subspan(take);
+    }
+    return written;
+}
+
+size_t AesStreamDecryptor::final(std::span<std::byte> out)
+{
+    if (m_finished) {
+        throw std::logic_error("AesStreamDecryptor::final called twice");
+    }
+    checkOutput(out, finalBound());
+    m_finished = true;
+    if (m_headerSize < m_header.size()) {
+        throw AesAuthenticationError();
+    }
+    if (m_mode == AesStreamMode::Ctr) {
+        return 0;
+    }
+    // 最后一段至少有标签；整段缺失或在段边界截断都无法通过 final 标记的认证
+    if (m_buffered < AesGcm::kTagSize) {
+        throw AesAuthenticationError();
+    }
+    openSegment(std::span(m_buffer).first(m_buffered), out, true);
+    const size_t size = m_buffered - AesGcm::kTagSize;
+    m_buffered = 0;
+    return size;
+}
+
+std::string AesStreamDecryptor::update(std::string_view in)
+{
+    std::string out(updateBound(in.size()), '\0');
+    out.resize(update(std::as_bytes(std::span(in)), std::as_writable_bytes(std::span(out))));
+    return out;
+}
+
+std::string AesStreamDecryptor::final()
+{
+    std::string out(finalBound(), '\0');
+    out.resize(final(std::as_writable_bytes(std::span(out))));
+    return out;
+}
+
+namespace {
+
+using OpenSSLUtils::throwFileError;
+#ifndef _WIN32
+using OpenSSLUtils::FileDescriptor;
+using OpenSSLUtils::Mapping;
+#endif
+
+// 加密器与解密器接口相同，输出缓冲区按每次调用的上界按需增长，大小只与分段和块大小有关
+template<typename Codec, typename Write>
+class Pipe
+{
+public:
+    Pipe(Codec &codec, Write write)
+        : m_codec(codec)
+        , m_write(std::move(write))
+    {}
+
+    void update(std::span<const std::byte> in)
+    {
+        reserve(m_codec.updateBound(in.size()));
+        m_write(m_out.data(), m_codec.update(in, m_out));
+    }
+
+    void final()
+    {
+        reserve(m_codec.finalBound());
+        m_write(m_out.data(), m_codec.final(m_out));
+    }
+
+private:
+    void reserve(size_t bound)
+    {
+        if (m_out.size() < bound) {
+            m_out.resize(bound);
+        }
+    }
+
+    Codec &m_codec;
+    Write m_write;
+    std::vector<std::byte> m_out;
+};
+
+template<typename Codec>
+void transformStream(Codec &codec, std::istream &in, std::ostream &out)
+{
+    Pipe pipe(codec, [&out](const std::byte *data, size_t size) {
+        OpenSSLUtils::writeStream(out, data, size);
+    });
+    OpenSSLUtils::readStream(in, 1 << 20, [&pipe](std::span<const char> chunk) {
+        pipe.update(std::as_bytes(chunk));
+    });
+    pipe.final();
+}
+
+#ifndef _WIN32
+void writeAll(int fd, const std::byte *data, size_t size, const std::string &path)
+{
+    while (size > 0) {
+        const ssize_t n = ::write(fd, data, size);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throwFileError("Failed to write", path);
+        }
+        data += n;
+        size -= static_cast<size_t>(n);
+    }
+}
+
+// 输入按块映射后直接交给 codec，整段数据不经过中间缓冲区
+template<typename Codec>
+void transformFd(Codec &codec,
+                 int in,
+                 int out,
+                 const std::string &inPath,
+                 const std::string &outPath)
+{
+    Pipe pipe(codec, [out, &outPath](const std::byte *data, size_t size) {
+        writeAll(out, data, size, outPath);
+    });
+    OpenSSLUtils::readFile(in, inPath, kFileChunk, [&pipe](std::span<const std::byte> chunk) {
+        pipe.update(chunk);
+    });
+    pipe.final();
+}
+#endif
+
+template<typename Codec>
+void transformFile(Codec &codec, const std::string &inPath, const std::string &outPath)
+{
+#ifndef _WIN32
+    FileDescriptor in{::open(inPath.c_str(), O_RDONLY | O_CLOEXEC)};
+    if (in.fd < 0) {
+        throwFileError("Failed to open", inPath);
+    }
+    FileDescriptor out{::open(outPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600)};
+    if (out.fd < 0) {
+        throwFileError("Failed to create", outPath);
+    }
+    try {
+        transformFd(codec, in.fd, out.fd, inPath, outPath);
+    } catch (...) {
+        ::unlink(outPath.c_str());
+        throw;
+    }
+    if (::close(out.fd) != 0) {
+        out.fd = -1;
+        ::unlink(outPath.c_str());
+        throwFileError("Failed to close", outPath);
+    }
+    out.fd = -1;
+#else
+    std::ifstream in(inPath, std::ios::binary);
+    if (!in) {
+        throwFileError("Failed to open", inPath);
+    }
+    std::ofstream out(outPath, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throwFileError("Failed to create", outPath);
+    }
+    try {
+        transformStream(codec, in, out);
+    } catch (...) {
+        out.close();
+        std::remove(outPath.c_str());
+        throw;
+    }
+#endif
+}
+
+} // namespace
+
+void encryptFile(const std::string &inPath,
+                 const std::string &outPath,
+                 std::string_view key,
+                 AesStreamMode mode,
+                 size_t segmentSize)
+{
+    AesStreamEncryptor encryptor(key, mode, segmentSize);
+    transformFile(encryptor, inPath, outPath);
+}
+
+void decryptFile(const std::string &inPath,
+                 const std::string &outPath,
+                 std::string_view key,
+                 AesStreamMode mode)
+{
+    AesStreamDecryptor decryptor(key, mode);
+    transformFile(decryptor, inPath, outPath);
+}
+
+void encryptStream(std::istream &in,
+                   std::ostream &out,
+                   std::string_view key,
+                   AesStreamMode mode,
+                   size_t segmentSize)
+{
+    AesStreamEncryptor encryptor(key, mode, segmentSize);
+    transformStream(encryptor, in, out);
+}
+
+void decryptStream(std::istream &in, std::ostream &out, std::string_view key, AesStreamMode mode)
+{
+    AesStreamDecryptor decryptor(key, mode);
+    transformStream(decryptor, in, out);
+}
+
+namespace {
+
+// CTR 并行时每个任务处理的字节数，必须是分组长度的整数倍
+constexpr size_t kCtrParallelChunk = 1 << 20;
+// GCM 分段较小时，一个任务连续处理多段，凑到约 1 MiB
+constexpr size_t kGcmParallelGrainBytes = 1 << 20;
+
+struct CtxRelease
+{
+    void operator()(EVP_CIPHER_CTX *ctx) const { CipherContextCache::release(ctx); }
+};
+
+using CipherCtxPtr = std::unique_ptr<EVP_CIPHER_CTX, CtxRelease>;
+
+// 第 block 个分组的计数器：nonce 作为 128 位大端整数加上 block
+auto ctrIvAt(const Header &header, uint64_t block) -> std::array<unsigned char, AesCtr::kIvSize>
+{
+    std::array<unsigned char, AesCtr::kIvSize> iv;
+    std::memcpy(iv.data(), header.data() + kNonceOffset, iv.size());
+    uint64_t carry = block;
+    for (size_t i = iv.size(); i-- > 0 && carry != 0;) {
+        const uint64_t sum = iv[i] + (carry & 0xff);
+        iv[i] = static_cast<unsigned char>(sum);
+        carry = (carry >> 8) + (sum >> 8);
+    }
+    return iv;
+}
+
+// GCM 密文主体包含的段数；长度不可能由合法输出得到时视为被截断
+auto gcmSegmentCount(size_t bodySize, size_t segmentSize) -> size_t
+{
+    const size_t sealedSegment = segmentSize + AesGcm::kTagSize;
+    const size_t full = bodySize / sealedSegment;
+    const size_t rest = bodySize % sealedSegment;
+    if (rest == 0 && full == 0) {
+        throw AesAuthenticationError();
+    }
+    if (rest != 0 && rest < AesGcm::kTagSize) {
+        throw AesAuthenticationError();
+    }
+    return rest == 0 ? full : full + 1;
+}
+
+auto readHeader(std::span<const std::byte> sealed, AesStreamMode mode)
+    -> std::pair<Header, HeaderInfo>
+{
+    if (sealed.size() < kAesStreamHeaderSize) {
+        throw AesAuthenticationError();
+    }
+    Header header;
+    std::memcpy(header.data(), sealed.data(), header.size());
+    return {header, parseHeader(header, mode)};
+}
+
+void checkDisjoint(std::span<const std::byte> in, std::span<std::byte> out)
+{
+    const std::byte *inEnd = in.data() + in.size();
+    const std::byte *outEnd = out.data() + out.size();
+    if (!in.empty() && !out.empty() && in.data() < outEnd && out.data() < inEnd) {
+        throw std::invalid_argument("Input and output buffers must not overlap");
+    }
+}
+
+// 两个方向共用：GCM 按段（每个任务若干段），CTR 按固定大小的块
+void transformParallel(const Header &header,
+                       const HeaderInfo &info,
+                       const unsigned char *key,
+                       bool encrypt,
+                       std::span<const std::byte> in,
+                       std::span<std::byte> out,
+                       size_t segments,
+                       ThreadPool &pool)
+{
+    const std::byte *nonce = header.data() + kNonceOffset;
+    auto makeContext = [&] {
+        return CipherCtxPtr(newKeyedContext(info.mode, key, nonce, encrypt));
+    };
+
+    if (info.mode == AesStreamMode::Ctr) {
+        const size_t size = in.size();
+        const size_t chunks = (size + kCtrParallelChunk - 1) / kCtrParallelChunk;
+        parallelFor(pool, chunks, makeContext, [&](CipherCtxPtr &ctx, size_t chunk) {
+            const size_t begin = chunk * kCtrParallelChunk;
+            const size_t length = std::min(kCtrParallelChunk, size - begin);
+            const auto iv = ctrIvAt(header, begin / AES_BLOCK_SIZE);
+            if (EVP_EncryptInit_ex(ctx.get(), nullptr, nullptr, nullptr, iv.data()) != 1) {
+                handleOpenSSLError();
+            }
+            ctrUpdate(ctx.get(), in.subspan(begin, length), out.data() + begin);
+        });
+        return;
+    }
+
+    const size_t segmentSize = info.segmentSize;
+    const size_t sealedSegment = segmentSize + AesGcm::kTagSize;
+    const size_t plainSize = encrypt ? in.size() : out.size();
+    const size_t grain = std::max<size_t>(kGcmParallelGrainBytes / segmentSize, 1);
+    const size_t tasks = (segments + grain - 1) / grain;
+    parallelFor(pool, tasks, makeContext, [&](CipherCtxPtr &ctx, size_t task) {
+        const size_t end = std::min((task + 1) * grain, segments);
+        for (size_t i = task * grain; i < end; ++i) {
+            const size_t begin = i * segmentSize;
+            const size_t length = std::min(segmentSize, plainSize - begin);
+            const bool final = i + 1 == segments;
+            if (encrypt) {
+                gcmSeal(ctx.get(),
+                        header,
+                        i,
+                        final,
+                        in.subspan(begin, length),
+                        out.data() + i * sealedSegment);
+            } else {
+                gcmOpen(ctx.get(),
+                        header,
+                        i,
+                        final,
+                        in.subspan(i * sealedSegment, length + AesGcm::kTagSize),
+                        out.data() + begin);
+            }
+        }
+    });
+}
+
+} // namespace
+
+size_t aesStreamSealedSize(size_t plaintextSize, AesStreamMode mode, size_t segmentSize)
+{
+    checkSegmentSize(segmentSize);
+    if (mode == AesStreamMode::Ctr) {
+        return kAesStreamHeaderSize + plaintextSize;
+    }
+    const size_t segments = std::max<size_t>((plaintextSize + segmentSize - 1) / segmentSize, 1);
+    return kAesStreamHeaderSize + plaintextSize + segments * AesGcm::kTagSize;
+}
+
+size_t aesStreamOpenedSize(std::span<const std::byte> sealed, AesStreamMode mode)
+{
+    const auto [header, info] = readHeader(sealed, mode);
+    const size_t bodySize = sealed.size() - kAesStreamHeaderSize;
+    if (info.mode == AesStreamMode::Ctr) {
+        return bodySize;
+    }
+    return bodySize - gcmSegmentCount(bodySize, info.segmentSize) * AesGcm::kTagSize;
+}
+
+size_t encryptParallel(std::span<const std::byte> in,
+                       std::span<std::byte> out,
+                       std::string_view key,
+                       ThreadPool &pool,
+                       AesStreamMode mode,
+                       size_t segmentSize)
+{
+    OpenSSLUtils::checkKeySize(key.size());
+    if (mode != AesStreamMode::Gcm && mode != AesStreamMode::Ctr) {
+        throw std::invalid_argument("Unknown AES stream mode");
+    }
+    const size_t sealedSize = aesStreamSealedSize(in.size(), mode, segmentSize);
+    checkOutput(out, sealedSize);
+    checkDisjoint(in, out);
+
+    const Header header = buildHeader(mode, segmentSize);
+    std::memcpy(out.data(), header.data(), header.size());
+    const size_t segments = std::max<size_t>((in.size() + segmentSize - 1) / segmentSize, 1);
+    transformParallel(header,
+                      {mode, segmentSize},
+                      reinterpret_cast<const unsigned char *>(key.data()),
+                      true,
+                      in,
+                      out.subspan(kAesStreamHeaderSize, sealedSize - kAesStreamHeaderSize),
+                      segments,
+                      pool);
+    return sealedSize;
+}
+
+size_t decryptParallel(std::span<const std::byte> in,
+                       std::span<std::byte> out,
+                       std::string_view key,
+                       ThreadPool &pool,
+                       AesStreamMode mode)
+{
+    OpenSSLUtils::checkKeySize(key.size());
+    const auto [header, info] = readHeader(in, mode);
+    const auto body = in.subspan(kAesStreamHeaderSize);
+    const size_t segments
+        = info.mode == AesStreamMode::Gcm ? gcmSegmentCount(body.size(), info.segmentSize) : 0;
+    const size_t plainSize = body.size() - segments * AesGcm::kTagSize;
+    checkOutput(out, plainSize);
+    checkDisjoint(in, out);
+
+    try {
+        transformParallel(header,
+                          info,
+                          reinterpret_cast<const unsigned char *>(key.data()),
+                          false,
+                          body,
+                          out.first(plainSize),
+                          segments,
+                          pool);
+    } catch (...) {
+        // 其它段可能已经解密成功，整体不可信，全部清掉
+        OPENSSL_cleanse(out.data(), plainSize);
+        throw;
+    }
+    return plainSize;
+}
+
+namespace {
+
+#ifndef _WIN32
+// 为输出文件实际分配磁盘空间并设好长度，返回 0 或错误码。只用 ftruncate 得到的是稀疏文件，
+// 写入共享映射时才分配块，磁盘已满或超出配额会触发 SIGBUS，而不是在这里抛出异常
+auto allocateFile(int fd, size_t size) -> int
+{
+#ifdef __APPLE__
+    fstore_t store{F_ALLOCATECONTIG | F_ALLOCATEALL, F_PEOFPOSMODE, 0, static_cast<off_t>(size), 0};
+    if (::fcntl(fd, F_PREALLOCATE, &store) == -1) {
+        store.fst_flags = F_ALLOCATEALL;
+        if (::fcntl(fd, F_PREALLOCATE, &store) == -1) {
+            return errno;
+        }
+    }
+    return ::ftruncate(fd, static_cast<off_t>(size)) == 0 ? 0 : errno;
+#else
+    int rc;
+    do {
+        rc = ::posix_fallocate(fd, 0, static_cast<off_t>(size));
+    } while (rc == EINTR);
+    return rc;
+#endif
+}
+
+// 输出文件先分配好空间再共享映射，加解密结果直接写进页缓存
+template<typename Transform>
+void mapOutput(const std::string &outPath, size_t size, Transform transform)
+{
+    FileDescriptor out{::open(outPath.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0600)};
+    if (out.fd < 0) {
+        throwFileError("Failed to create", outPath);
+    }
+    try {
+        Mapping mapping;
+        if (size > 0) {
+            if (const int rc = allocateFile(out.fd, size); rc != 0) {
+                errno = rc;
+                throwFileError("Failed to allocate", outPath);
+            }
+            void *map = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, out.fd, 0);
+            if (map == MAP_FAILED) {
+                throwFileError("Failed to map", outPath);
+            }
+            mapping.data = map;
+            mapping.size = size;
+        }
+        transform(mapping.bytes());
+    } catch (...) {
+        ::unlink(outPath.c_str());
+        throw;
+    }
+}
+#endif
+
+} // namespace
+
+void encryptFileParallel(const std::string &inPath,
+                         const std::string &outPath,
+                         std::string_view key,
+                         ThreadPool &pool,
+                         AesStreamMode mode,
+                         size_t segmentSize)
+{
+#ifndef _WIN32
+    OpenSSLUtils::checkKeySize(key.size());
+    FileDescriptor in{::open(inPath.c_str(), O_RDONLY | O_CLOEXEC)};
+    if (in.fd < 0) {
+        throwFileError("Failed to open", inPath);
+    }
+    Mapping input;
+    if (OpenSSLUtils::mapInput(in.fd, inPath, input)) {
+        mapOutput(outPath,
+                  aesStreamSealedSize(input.size, mode, segmentSize),
+                  [&](std::span<std::byte> out) {
+                      encryptParallel(input.bytes(), out, key, pool, mode, segmentSize);
+                  });
+        return;
+    }
+#endif
+    (void) pool;
+    encryptFile(inPath, outPath, key, mode, segmentSize);
+}
+
+void decryptFileParallel(const std::string &inPath,
+                         const std::string &outPath,
+                         std::string_view key,
+                         ThreadPool &pool,
+                         AesStreamMode mode)
+{
+#ifndef _WIN32
+    OpenSSLUtils::checkKeySize(key.size());
+    FileDescriptor in{::open(inPath.c_str(), O_RDONLY | O_CLOEXEC)};
+    if (in.fd < 0) {
+        throwFileError("Failed to open", inPath);
+    }
+    Mapping input;
+    if (OpenSSLUtils::mapInput(in.fd, inPath, input)) {
+        mapOutput(outPath, aesStreamOpenedSize(input.bytes(), mode), [&](std::span<std::byte> out) {
+            decryptParallel(input.bytes(), out, key, pool, mode);
+        });
+        return;
+    }
+#endif
+    (void) pool;
+    decryptFile(inPath, outPath, key, mode);
+}
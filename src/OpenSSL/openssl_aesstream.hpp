@@ -0,0 +1,203 @@
+#pragma once
+
+#include "openssl_aesmodes.hpp"
+#include "openssl_context.hpp"
+
+#include <utils/object.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class ThreadPool;
+
+// 分段流式 AES-256 加密。内存占用只与分段大小有关，与数据总长度无关。
+// 输出格式如下，le32/le64 为小端整数：
+//
+//   头部（32 字节）：
+//       "CXAS" || version(1) = 1 || mode(1) || 0(2) || le32(segmentSize) || 0(4) || nonce(16)
+//   GCM：明文按 segmentSize 切分，最后一段可以更短（空输入为一个空段），每段独立加密：
+//       segment[i] = 密文[i] || tag[i](16)
+//       IV[i]      = nonce[0..12) 的后 8 字节与 be64(i) 异或
+//       AAD[i]     = 头部 || le64(i) || final(1)，最后一段 final 为 1，其余为 0
+//   CTR：头部之后直接是与明文等长的密文，计数器从 nonce 开始按 128 位大端递增，不做认证
+//
+// 每段的 IV 只取决于 nonce 与段号，各段可以独立并行加解密，见下面的 encryptParallel。
+// GCM 下每段在输出明文之前先校验标签，任何一段被篡改、调换、删除或整个流在段边界被截断
+// 都会在该段处抛出 AesAuthenticationError。头部参与每一段的认证，改动头部同样会被发现。
+// 模式字节只有在 GCM 下才受认证保护，把它改成 CTR 就能绕过标签校验，因此解密接口都由调用方
+// 指定期望的模式（默认 GCM），头部中的模式与之不符时抛出 AesAuthenticationError
+enum class AesStreamMode : uint8_t { Gcm = 1, Ctr = 2 };
+
+constexpr size_t kAesStreamHeaderSize = 32;
+constexpr size_t kAesStreamSegmentSize = 64 << 10;
+// 解密时接受的最大分段，避免损坏的头部导致超大分配
+constexpr size_t kAesStreamMaxSegmentSize = 64 << 20;
+
+// 增量加密：update 可以传入任意长度的数据，输出写入调用方缓冲区，第一次输出时带上头部。
+// 只有不足一段的尾部会被暂存，整段的输入直接加密到输出，不经过内部缓冲区
+class AesStreamEncryptor
+{
+public:
+    explicit AesStreamEncryptor(std::string_view key,
+                                AesStreamMode mode = AesStreamMode::Gcm,
+                                size_t segmentSize = kAesStreamSegmentSize);
+
+    DISABLE_COPY(AesStreamEncryptor)
+    DEFAULT_MOVE(AesStreamEncryptor)
+    ~AesStreamEncryptor() = default;
+
+    // 本次 update/final 最多输出的字节数
+    [[nodiscard]] size_t updateBound(size_t inputSize) const;
+    [[nodiscard]] size_t finalBound() const;
+
+    // out 至少 updateBound(in.size()) 字节，返回写入的字节数
+    size_t update(std::span<const std::byte> in, std::span<std::byte> out);
+    // 写出最后一段，out 至少 finalBound() 字节。之后不能再调用 update
+    size_t final(std::span<std::byte> out);
+
+    // 便捷接口：返回本次输出
+    std::string update(std::string_view in);
+    std::string final();
+
+    [[nodiscard]] AesStreamMode mode() const { return m_mode; }
+    [[nodiscard]] size_t segmentSize() const { return m_segmentSize; }
+
+private:
+    struct CtxDeleter
+    {
+        void operator()(EVP_CIPHER_CTX *ctx) const { CipherContextCache::release(ctx); }
+    };
+
+    size_t writeHeader(std::span<std::byte> out);
+    void sealSegment(std::span<const std::byte> in, std::span<std::byte> out, bool final);
+
+    AesStreamMode m_mode;
+    size_t m_segmentSize;
+    std::array<std::byte, kAesStreamHeaderSize> m_header{};
+    bool m_headerWritten = false;
+    bool m_finished = false;
+    uint64_t m_segmentIndex = 0;
+    std::vector<std::byte> m_buffer;
+    size_t m_buffered = 0;
+    std::unique_ptr<EVP_CIPHER_CTX, CtxDeleter> m_ctx;
+};
+
+// 增量解密：分段大小从头部读出，模式必须与 mode 一致。GCM 下只有通过认证的段才会写到输出，
+// 因此 update 的输出会比输入滞后最多一段
+class AesStreamDecryptor
+{
+public:
+    explicit AesStreamDecryptor(std::string_view key, AesStreamMode mode = AesStreamMode::Gcm);
+
+    DISABLE_COPY(AesStreamDecryptor)
+    DEFAULT_MOVE(AesStreamDecryptor)
+    ~AesStreamDecryptor();
+
+    [[nodiscard]] size_t updateBound(size_t inputSize) const;
+    [[nodiscard]] size_t finalBound() const;
+
+    // 头部不合法时抛出 std::runtime_error，模式不符或认证失败时抛出 AesAuthenticationError
+    size_t update(std::span<const std::byte> in, std::span<std::byte> out);
+    // 校验最后一段；流不完整（包括头部都没读全）时抛出 AesAuthenticationError
+    size_t final(std::span<std::byte> out);
+
+    std::string update(std::string_view in);
+    std::string final();
+
+    [[nodiscard]] AesStreamMode mode() const { return m_mode; }
+    // 头部读完之前为 0
+    [[nodiscard]] size_t segmentSize() const { return m_segmentSize; }
+
+private:
+    struct CtxDeleter
+    {
+        void operator()(EVP_CIPHER_CTX *ctx) const { CipherContextCache::release(ctx); }
+    };
+
+    void parseHeader();
+    void openSegment(std::span<const std::byte> in, std::span<std::byte> out, bool final);
+
+    std::array<unsigned char, kAesKeySize> m_key{};
+    AesStreamMode m_mode;
+    size_t m_segmentSize = 0;
+    std::array<std::byte, kAesStreamHeaderSize> m_header{};
+    size_t m_headerSize = 0;
+    bool m_finished = false;
+    uint64_t m_segmentIndex = 0;
+    std::vector<std::byte> m_buffer;
+    size_t m_buffered = 0;
+    std::unique_ptr<EVP_CIPHER_CTX, CtxDeleter> m_ctx;
+};
+
+// 文件与流的加解密。POSIX 下按块 mmap 输入、用大块 write 输出，
+// 不能映射的输入（管道等）退回 read。内存占用约为两个 4 MiB 缓冲区加一个分段。
+// 解密失败时删除已写出的输出文件，不留下未完整校验的明文
+void encryptFile(const std::string &inPath,
+                 const std::string &outPath,
+                 std::string_view key,
+                 AesStreamMode mode = AesStreamMode::Gcm,
+                 size_t segmentSize = kAesStreamSegmentSize);
+void decryptFile(const std::string &inPath,
+                 const std::string &outPath,
+                 std::string_view key,
+                 AesStreamMode mode = AesStreamMode::Gcm);
+
+void encryptStream(std::istream &in,
+                   std::ostream &out,
+                   std::string_view key,
+                   AesStreamMode mode = AesStreamMode::Gcm,
+                   size_t segmentSize = kAesStreamSegmentSize);
+void decryptStream(std::istream &in,
+                   std::ostream &out,
+                   std::string_view key,
+                   AesStreamMode mode = AesStreamMode::Gcm);
+
+// 并行加解密默认的分段大小
+constexpr size_t kAesParallelSegmentSize = 1 << 20;
+
+// 加密 plaintextSize 字节后的总长度
+size_t aesStreamSealedSize(size_t plaintextSize,
+                           AesStreamMode mode,
+                           size_t segmentSize = kAesStreamSegmentSize);
+// 从头部与总长度算出明文长度，头部不合法时抛出 std::runtime_error，
+// 模式与 mode 不符或长度不符合分段格式（被截断）时抛出 AesAuthenticationError
+size_t aesStreamOpenedSize(std::span<const std::byte> sealed,
+                           AesStreamMode mode = AesStreamMode::Gcm);
+
+// 整块数据的并行分段加解密，输出格式与 AesStreamEncryptor 相同，两者可以互相解密。
+// GCM 按段、CTR 按 1 MiB 的块分给 pool 的工作线程与调用线程，每个参与者只展开一次密钥。
+// 输入与输出不能重叠；out 至少 aesStreamSealedSize / aesStreamOpenedSize 字节，返回写入的字节数。
+// 解密时任何一段认证失败都会清零全部输出并抛出 AesAuthenticationError
+size_t encryptParallel(std::span<const std::byte> in,
+                       std::span<std::byte> out,
+                       std::string_view key,
+                       ThreadPool &pool,
+                       AesStreamMode mode = AesStreamMode::Gcm,
+                       size_t segmentSize = kAesParallelSegmentSize);
+size_t decryptParallel(std::span<const std::byte> in,
+                       std::span<std::byte> out,
+                       std::string_view key,
+                       ThreadPool &pool,
+                       AesStreamMode mode = AesStreamMode::Gcm);
+
+// 文件版本：POSIX 下输入只读映射、输出预先设好长度后共享映射，各段直接在页缓存之间加解密。
+// 输入不是普通文件或没有 mmap 时退回单线程的 encryptFile/decryptFile
+void encryptFileParallel(const std::string &inPath,
+                         const std::string &outPath,
+                         std::string_view key,
+                         ThreadPool &pool,
+                         AesStreamMode mode = AesStreamMode::Gcm,
+                         size_t segmentSize = kAesParallelSegmentSize);
+void decryptFileParallel(const std::string &inPath,
+                         const std::string &outPath,
+                         std::string_view key,
+                         ThreadPool &pool,
+                         AesStreamMode mode = AesStreamMode::Gcm);
@@ -1,60 +1,14 @@
+#include "openssl_base64codec.hpp"
 #include "openssl_common.hpp"
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <chrono>
+#include <random>
+#include <sstream>
 #include <stdexcept>
 
-std::string base64Encode(const std::string &input)
-{
-    BIO *bmem = nullptr;
-    BIO *b64 = BIO_new(BIO_f_base64());
-    BIO_set_flags(b64, BIO_FLAGS_BASE64_NO_NL);
-
-    bmem = BIO_new(BIO_s_mem());
-    b64 = BIO_push(b64, bmem);
-
-    if (BIO_write(b64, input.data(), input.size()) != static_cast<int>(input.size())) {
-        BIO_free_all(b64);
-        handleOpenSSLError();
-    }
-
-    if (BIO_flush(b64) != 1) {
-        BIO_free_all(b64);
-        handleOpenSSLError();
-    }
-
-    char *outputData = nullptr;
-    long outputLen = BIO_get_mem_data(bmem, &outputData);
-    std::string output(outputData, outputLen);
-
-    BIO_free_all(b64);
-    return output;
-}
-
-std::string base64Decode(const std::string &input)
-{
-    BIO *b64 = BIO_new(BIO_f_base64());
-    BIO_set_flags(b64, BIO_FLAGS_BASE64_NO_NL);
-
-    BIO *bmem = BIO_new_mem_buf(input.data(), input.size());
-    bmem = BIO_push(b64, bmem);
-
-    std::string output;
-    output.resize(input.size());
-
-    int decodedLen = BIO_read(bmem, output.data(), output.size());
-    if (decodedLen < 0) {
-        BIO_free_all(bmem);
-        handleOpenSSLError();
-    }
-
-    output.resize(decodedLen);
-    BIO_free_all(bmem);
-
-    return output;
-}
-
 class Base64Test : public ::testing::Test
 {
 protected:
@@ -320,6 +274,277 @@ TEST_F(Base64Test, EncodeDecodeRandomData)
     }
 }
 
+// 测试与 OpenSSL EVP_EncodeBlock 的结果一致，长度覆盖向量内核的整块与标量尾部
+TEST_F(Base64Test, MatchesOpenSSLEncodeBlock)
+{
+    std::mt19937 rng(48);
+    std::string data(1200, '\0');
+    std::generate(data.begin(), data.end(), [&rng] { return static_cast<char>(rng()); });
+
+    for (size_t size = 0; size <= data.size(); size += size < 100 ? 1 : 37) {
+        const std::string_view input(data.data(), size);
+        std::string expected(base64EncodedSize(size) + 1, '\0');
+        const int length = EVP_EncodeBlock(reinterpret_cast<unsigned char *>(expected.data()),
+                                           reinterpret_cast<const unsigned char *>(input.data()),
+                                           static_cast<int>(size));
+        expected.resize(length);
+
+        const std::string encoded = base64Encode(input);
+        ASSERT_EQ(encoded, expected) << "size " << size;
+        EXPECT_EQ(base64DecodedSize(encoded), size);
+        EXPECT_EQ(base64Decode(encoded), input) << "size " << size;
+        EXPECT_EQ(base64Decode(encoded, Base64DecodeMode::Lenient), input) << "size " << size;
+    }
+}
+
+// 测试 URL 安全字母表与省略填充
+TEST_F(Base64Test, UrlSafeAlphabet)
+{
+    const std::string data = "\xFB\xFF\xBF\xFB\xFF";
+    EXPECT_EQ(base64Encode(data), "+/+/+/8=");
+    EXPECT_EQ(base64Encode(data, Base64Alphabet::UrlSafe), "-_-_-_8=");
+    EXPECT_EQ(base64Encode(data, Base64Alphabet::UrlSafe, false), "-_-_-_8");
+    EXPECT_EQ(base64EncodedSize(data.size(), false), 7u);
+
+    EXPECT_EQ(base64Decode("-_-_-_8=", Base64DecodeMode::Strict, Base64Alphabet::UrlSafe), data);
+    EXPECT_THROW(base64Decode("+/+/+/8=", Base64DecodeMode::Strict, Base64Alphabet::UrlSafe),
+                 std::invalid_argument);
+    EXPECT_THROW(base64Decode("-_-_-_8="), std::invalid_argument);
+    // 宽松模式两种字母表都接受，填充可以省略
+    EXPECT_EQ(base64Decode("-_+/-_8", Base64DecodeMode::Lenient), data);
+
+    // 长输入走向量内核
+    std::string longData;
+    for (int i = 0; i < 300; ++i) {
+        longData += data;
+    }
+    const std::string encoded = base64Encode(longData, Base64Alphabet::UrlSafe);
+    EXPECT_EQ(encoded.find_first_of("+/"), std::string::npos);
+    EXPECT_EQ(base64Decode(encoded, Base64DecodeMode::Strict, Base64Alphabet::UrlSafe), longData);
+}
+
+// 测试严格模式对每个字节值的校验，非法字符分别落在向量内核的块内与标量尾部
+TEST_F(Base64Test, StrictRejectsInvalidCharacters)
+{
+    const std::string valid = base64Encode(std::string(150, 'x'));
+    ASSERT_EQ(valid.size(), 200u);
+    for (const auto alphabet : {Base64Alphabet::Standard, Base64Alphabet::UrlSafe}) {
+        const std::string_view chars = alphabet == Base64Alphabet::Standard ? "+/" : "-_";
+        for (int c = 0; c < 256; ++c) {
+            const bool isAlphabet = (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z')
+                                    || (c >= '0' && c <= '9') || c == chars[0] || c == chars[1];
+            for (size_t pos : {size_t{5}, size_t{70}, size_t{190}}) {
+                std::string text = valid;
+                text[pos] = static_cast<char>(c);
+                std::string out(base64DecodedSize(text), '\0');
+                size_t size = 0;
+                size_t errorPos = 0;
+                const bool ok = base64Decode(text, out.data(), &size, Base64DecodeMode::Strict,
+                                             alphabet, &errorPos);
+                ASSERT_EQ(ok, isAlphabet) << "char " << c << " at " << pos;
+                if (!ok) {
+                    EXPECT_EQ(errorPos, pos) << "char " << c;
+                }
+            }
+        }
+    }
+}
+
+// 测试严格模式对填充与未用到的位的要求
+TEST_F(Base64Test, StrictPadding)
+{
+    EXPECT_EQ(base64Decode("Zm8="), "fo");
+    EXPECT_THROW(base64Decode("Zm8"), std::invalid_argument);
+    EXPECT_THROW(base64Decode("Zg="), std::invalid_argument);
+    EXPECT_THROW(base64Decode("Zg==="), std::invalid_argument);
+    EXPECT_THROW(base64Decode("Zh=="), std::invalid_argument); // 未用到的位不为 0
+    EXPECT_THROW(base64Decode("Zg==Zg=="), std::invalid_argument);
+    EXPECT_THROW(base64Decode("Z==="), std::invalid_argument);
+    EXPECT_THROW(base64Decode("Zm9v\n"), std::invalid_argument);
+
+    size_t errorPos = 0;
+    size_t size = 0;
+    char out[8];
+    EXPECT_FALSE(base64Decode("Zm9vY", out, &size, Base64DecodeMode::Strict,
+                              Base64Alphabet::Standard, &errorPos));
+    EXPECT_EQ(errorPos, 5u);
+    EXPECT_FALSE(base64Decode("Zm9v=", out, &size, Base64DecodeMode::Strict,
+                              Base64Alphabet::Standard, &errorPos));
+    EXPECT_EQ(errorPos, 4u);
+}
+
+// 测试宽松模式：跳过换行与空白、省略填充
+TEST_F(Base64Test, LenientDecode)
+{
+    EXPECT_EQ(base64Decode("SGVsbG8gV29ybGQ", Base64DecodeMode::Lenient), "Hello World");
+    EXPECT_EQ(base64Decode(" Zm9v\r\nYmFy\tZg== \n", Base64DecodeMode::Lenient), "foobarf");
+    EXPECT_EQ(base64Decode("Zh", Base64DecodeMode::Lenient), "f");
+    EXPECT_THROW(base64Decode("Zm9vY", Base64DecodeMode::Lenient), std::invalid_argument);
+    EXPECT_THROW(base64Decode("Zg==Zg", Base64DecodeMode::Lenient), std::invalid_argument);
+    EXPECT_THROW(base64Decode("Zm9v!", Base64DecodeMode::Lenient), std::invalid_argument);
+
+    // 每 76 个字符换行（MIME 格式），换行落在向量内核的块中间
+    std::string data(5000, '\0');
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<char>(i * 131 + 7);
+    }
+    const std::string encoded = base64Encode(data);
+    std::string wrapped;
+    for (size_t pos = 0; pos < encoded.size(); pos += 76) {
+        wrapped += encoded.substr(pos, 76);
+        wrapped += "\r\n";
+    }
+    EXPECT_EQ(base64Decode(wrapped, Base64DecodeMode::Lenient), data);
+    EXPECT_THROW(base64Decode(wrapped), std::invalid_argument);
+}
+
+namespace {
+
+// 按 lineLength 切行，每行（包括最后一行）以 lineBreak 结束
+auto wrapLines(const std::string &text, size_t lineLength, const std::string &lineBreak)
+    -> std::string
+{
+    std::string wrapped;
+    for (size_t pos = 0; pos < text.size(); pos += lineLength) {
+        wrapped += text.substr(pos, lineLength);
+        wrapped += lineBreak;
+    }
+    return wrapped;
+}
+
+// 按随机长度切分后逐段 update
+template<typename Codec>
+auto feedInChunks(Codec &codec, std::string_view input, std::mt19937 &rng, size_t maxChunk)
+    -> std::string
+{
+    std::string output;
+    while (!input.empty()) {
+        const size_t take = std::min(input.size(), size_t{rng() % (maxChunk + 1)});
+        output += codec.update(input.substr(0, take));
+        input.remove_prefix(take);
+    }
+    output += codec.final();
+    return output;
+}
+
+} // namespace
+
+// 测试增量编码在任意切分下与一次性编码结果相同
+TEST_F(Base64Test, EncoderMatchesOneShot)
+{
+    std::mt19937 rng(49);
+    std::string data(20000, '\0');
+    std::generate(data.begin(), data.end(), [&rng] { return static_cast<char>(rng()); });
+
+    for (size_t maxChunk : {size_t{1}, size_t{2}, size_t{7}, size_t{100}, size_t{5000}}) {
+        for (const auto alphabet : {Base64Alphabet::Standard, Base64Alphabet::UrlSafe}) {
+            for (const bool padding : {true, false}) {
+                const std::string_view input(data.data(), data.size() - maxChunk % 3);
+                Base64Encoder encoder(alphabet, padding);
+                EXPECT_EQ(feedInChunks(encoder, input, rng, maxChunk),
+                          base64Encode(input, alphabet, padding));
+            }
+        }
+    }
+
+    Base64Encoder encoder;
+    EXPECT_EQ(encoder.final(), "");
+    // final 之后可以继续编码下一段数据
+    EXPECT_EQ(encoder.update("f"), "");
+    EXPECT_EQ(encoder.final(), "Zg==");
+}
+
+// 测试按行输出：每行 lineLength 个字符，最后一行也以换行结束
+TEST_F(Base64Test, EncoderLineWrapping)
+{
+    std::mt19937 rng(76);
+    const std::string data(1000, 'x');
+    for (size_t size : {size_t{0}, size_t{1}, size_t{57}, size_t{114}, size_t{115}, size_t{1000}}) {
+        const std::string input = data.substr(0, size);
+        Base64Encoder mime(Base64Alphabet::Standard, true, kBase64MimeLineLength, "\r\n");
+        EXPECT_EQ(feedInChunks(mime, input, rng, 50),
+                  wrapLines(base64Encode(input), kBase64MimeLineLength, "\r\n"))
+            << "size " << size;
+
+        Base64Encoder pem(Base64Alphabet::Standard, true, kBase64PemLineLength);
+        const std::string wrapped = feedInChunks(pem, input, rng, 300);
+        EXPECT_EQ(wrapped, wrapLines(base64Encode(input), kBase64PemLineLength, "\n"));
+        EXPECT_EQ(base64Decode(wrapped, Base64DecodeMode::Lenient), input);
+    }
+
+    EXPECT_THROW(Base64Encoder(Base64Alphabet::Standard, true, 75), std::invalid_argument);
+    Base64Encoder encoder;
+    std::string small(3, '\0');
+    EXPECT_THROW(encoder.update(std::as_bytes(std::span(data)), std::span(small)),
+                 std::invalid_argument);
+}
+
+// 测试增量解码在任意切分下与一次性解码结果相同，错误位置按整段数据计算
+TEST_F(Base64Test, DecoderSplitAnywhere)
+{
+    std::mt19937 rng(50);
+    std::string data(20000, '\0');
+    std::generate(data.begin(), data.end(), [&rng] { return static_cast<char>(rng()); });
+
+    for (size_t maxChunk : {size_t{1}, size_t{3}, size_t{5}, size_t{100}, size_t{5000}}) {
+        const std::string input = data.substr(0, data.size() - maxChunk % 3);
+        const std::string encoded = base64Encode(input);
+        Base64Decoder strict;
+        EXPECT_EQ(feedInChunks(strict, encoded, rng, maxChunk), input);
+
+        Base64Decoder lenient(Base64DecodeMode::Lenient, Base64Alphabet::UrlSafe);
+        const std::string wrapped = wrapLines(base64Encode(input, Base64Alphabet::UrlSafe, false),
+                                              kBase64MimeLineLength,
+                                              "\r\n");
+        EXPECT_EQ(feedInChunks(lenient, wrapped, rng, maxChunk), input);
+    }
+
+    Base64Decoder decoder;
+    EXPECT_EQ(decoder.update("Zm9v"), "foo");
+    EXPECT_EQ(decoder.update("Yg"), "");
+    EXPECT_EQ(decoder.update("="), "b");
+    EXPECT_EQ(decoder.update("="), "");
+    EXPECT_EQ(decoder.final(), "");
+
+    try {
+        decoder.update("Zm9vYmFy");
+        decoder.update("Zm9v!");
+        FAIL() << "expected std::invalid_argument";
+    } catch (const std::invalid_argument &e) {
+        EXPECT_NE(std::string(e.what()).find("position 12"), std::string::npos) << e.what();
+    }
+
+    Base64Decoder truncated;
+    EXPECT_EQ(truncated.update("Zm9vYg"), "foo");
+    EXPECT_THROW(truncated.final(), std::invalid_argument);
+    Base64Decoder lenient(Base64DecodeMode::Lenient);
+    EXPECT_EQ(lenient.update("Zm9vYg"), "foo");
+    EXPECT_EQ(lenient.final(), "b");
+}
+
+// 测试流式编解码：输入超过一个读取块，按 MIME 格式换行
+TEST_F(Base64Test, EncodeDecodeStream)
+{
+    std::string data((3 << 20) + 5, '\0');
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<char>(i * 7 + (i >> 12));
+    }
+
+    std::istringstream plain(data);
+    std::ostringstream encoded;
+    base64EncodeStream(plain, encoded, Base64Alphabet::Standard, kBase64MimeLineLength, "\r\n");
+    EXPECT_EQ(encoded.str(), wrapLines(base64Encode(data), kBase64MimeLineLength, "\r\n"));
+
+    std::istringstream text(encoded.str());
+    std::ostringstream decoded;
+    base64DecodeStream(text, decoded, Base64DecodeMode::Lenient);
+    EXPECT_EQ(decoded.str(), data);
+
+    std::istringstream wrapped(encoded.str());
+    std::ostringstream rejected;
+    EXPECT_THROW(base64DecodeStream(wrapped, rejected), std::invalid_argument);
+}
+
 int main(int argc, char **argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
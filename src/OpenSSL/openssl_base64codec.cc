@@ -0,0 +1,529 @@
+#include "openssl_base64codec.hpp"
+#include "openssl_base64codec_simd.hpp"
+#include "openssl_utils.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(OPENSSL_BASE64_AVX2) && defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace {
+
+constexpr std::string_view kStandardChars
+    = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+constexpr std::string_view kUrlSafeChars
+    = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+// 解码表中的特殊值，其余为 0~63
+constexpr int8_t kInvalid = -1;
+constexpr int8_t kPadding = -2;
+constexpr int8_t kSpace = -3;
+
+// 每个 12 位值对应的两个字符，编码时每 3 字节只需查两次表
+constexpr auto makeEncodePairs(std::string_view chars) -> std::array<std::array<char, 2>, 4096>
+{
+    std::array<std::array<char, 2>, 4096> table{};
+    for (int i = 0; i < 4096; ++i) {
+        table[i] = {chars[i >> 6], chars[i & 0x3F]};
+    }
+    return table;
+}
+
+constexpr auto makeDecodeValues(std::string_view chars, bool lenient) -> std::array<int8_t, 256>
+{
+    std::array<int8_t, 256> table{};
+    table.fill(kInvalid);
+    for (size_t i = 0; i < chars.size(); ++i) {
+        table[static_cast<unsigned char>(chars[i])] = static_cast<int8_t>(i);
+    }
+    if (lenient) {
+        const std::string_view other = chars == kStandardChars ? kUrlSafeChars : kStandardChars;
+        table[static_cast<unsigned char>(other[62])] = 62;
+        table[static_cast<unsigned char>(other[63])] = 63;
+        for (char c : {' ', '\t', '\r', '\n'}) {
+            table[static_cast<unsigned char>(c)] = kSpace;
+        }
+    }
+    table['='] = kPadding;
+    return table;
+}
+
+constexpr auto kStandardPairs = makeEncodePairs(kStandardChars);
+constexpr auto kUrlSafePairs = makeEncodePairs(kUrlSafeChars);
+constexpr auto kStandardValues = makeDecodeValues(kStandardChars, false);
+constexpr auto kUrlSafeValues = makeDecodeValues(kUrlSafeChars, false);
+// 宽松模式两种字母表都接受，共用一张表
+constexpr auto kLenientValues = makeDecodeValues(kStandardChars, true);
+
+#ifdef OPENSSL_BASE64_AVX2
+// 同时检查操作系统是否保存 YMM 寄存器
+bool cpuHasAvx2()
+{
+#ifdef _MSC_VER
+    int regs[4];
+    __cpuid(regs, 0);
+    if (regs[0] < 7) {
+        return false;
+    }
+    __cpuid(regs, 1);
+    if ((regs[2] & (1 << 27)) == 0 || (_xgetbv(0) & 0x6) != 0x6) {
+        return false;
+    }
+    __cpuidex(regs, 7, 0);
+    return (regs[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+bool useAvx2()
+{
+    static const bool supported = cpuHasAvx2();
+    return supported;
+}
+#endif
+
+void encodeScalar(const unsigned char *in,
+                  size_t n,
+                  char *out,
+                  const std::array<std::array<char, 2>, 4096> &pairs,
+                  bool padding)
+{
+    size_t i = 0;
+    for (; n - i >= 3; i += 3) {
+        const uint32_t v = (uint32_t{in[i]} << 16) | (uint32_t{in[i + 1]} << 8) | in[i + 2];
+        memcpy(out, pairs[v >> 12].data(), 2);
+        memcpy(out + 2, pairs[v & 0xFFF].data(), 2);
+        out += 4;
+    }
+    if (n - i == 1) {
+        memcpy(out, pairs[uint32_t{in[i]} << 4].data(), 2);
+        if (padding) {
+            memcpy(out + 2, "==", 2);
+        }
+    } else if (n - i == 2) {
+        const uint32_t v = (uint32_t{in[i]} << 10) | (uint32_t{in[i + 1]} << 2);
+        memcpy(out, pairs[v >> 6].data(), 2);
+        out[2] = pairs[v & 0x3F][1];
+        if (padding) {
+            out[3] = '=';
+        }
+    }
+}
+
+struct DecodeResult
+{
+    size_t written = 0;
+    size_t errorPos = 0;
+    bool ok = true;
+};
+
+// 写出 count 为 2 或 3 时剩余的 1~2 字节。严格模式下未用到的位必须为 0
+bool flushPartial(const Base64DecodeState &state, unsigned char *out, bool strict)
+{
+    if (state.count == 2) {
+        out[0] = static_cast<unsigned char>(state.bits >> 4);
+        return !strict || (state.bits & 0xF) == 0;
+    }
+    out[0] = static_cast<unsigned char>(state.bits >> 10);
+    out[1] = static_cast<unsigned char>(state.bits >> 2);
+    return !strict || (state.bits & 0x3) == 0;
+}
+
+// 解码 in，结果接在 out + result.written 之后，outRoom 为 out 的总大小。
+// 状态在 4 字符边界上时先交给向量内核，内核停下的地方（非法字符、填充或空白所在的块）
+// 以及尾部逐个字符处理，处理完重新回到边界后再交还给向量内核
+void decodeRun(std::string_view in,
+               unsigned char *out,
+               size_t outRoom,
+               Base64DecodeState &state,
+               DecodeResult &result,
+               Base64DecodeMode mode,
+               Base64Alphabet alphabet)
+{
+    const bool strict = mode == Base64DecodeMode::Strict;
+    const auto &values = !strict                                 ? kLenientValues
+                         : alphabet == Base64Alphabet::UrlSafe ? kUrlSafeValues
+                                                               : kStandardValues;
+    const auto *chars = reinterpret_cast<const unsigned char *>(in.data());
+    const size_t n = in.size();
+    size_t i = 0;
+    size_t o = result.written;
+
+    while (i < n) {
+        if (state.count == 0 && state.padding == 0) {
+#ifdef OPENSSL_BASE64_AVX2
+            if (useAvx2()) {
+                const size_t done = Base64Kernel::decodeAvx2(in.data() + i, n - i, out + o,
+                                                             outRoom - o, alphabet);
+                i += done;
+                o += done / 4 * 3;
+            }
+#endif
+            for (; n - i >= 4; i += 4, o += 3) {
+                const int a = values[chars[i]];
+                const int b = values[chars[i + 1]];
+                const int c = values[chars[i + 2]];
+                const int d = values[chars[i + 3]];
+                if ((a | b | c | d) < 0) {
+                    break;
+                }
+                const uint32_t v = (uint32_t(a) << 18) | (uint32_t(b) << 12) | (uint32_t(c) << 6)
+                                   | uint32_t(d);
+                out[o] = static_cast<unsigned char>(v >> 16);
+                out[o + 1] = static_cast<unsigned char>(v >> 8);
+                out[o + 2] = static_cast<unsigned char>(v);
+            }
+            if (i == n) {
+                break;
+            }
+        }
+
+        const int value = values[chars[i]];
+        if (value >= 0) {
+            if (state.padding != 0) {
+                break; // 填充之后又出现数据
+            }
+            state.bits = (state.bits << 6) | uint32_t(value);
+            if (++state.count == 4) {
+                out[o] = static_cast<unsigned char>(state.bits >> 16);
+                out[o + 1] = static_cast<unsigned char>(state.bits >> 8);
+                out[o + 2] = static_cast<unsigned char>(state.bits);
+                o += 3;
+                state.bits = 0;
+                state.count = 0;
+            }
+        } else if (value == kPadding) {
+            if (state.padding == 0) {
+                if (state.count < 2 || !flushPartial(state, out + o, strict)) {
+                    break;
+                }
+                o += state.count - 1;
+                state.expectedPadding = 4 - state.count;
+                state.bits = 0;
+                state.count = 0;
+            } else if (state.padding == state.expectedPadding) {
+                break;
+            }
+            ++state.padding;
+        } else if (value != kSpace) {
+            break;
+        }
+        ++i;
+    }
+
+    result.written = o;
+    if (i < n) {
+        result.ok = false;
+        result.errorPos = i;
+    }
+}
+
+// 输入结束：检查填充是否完整，宽松模式下补出省略了填充的最后 1~2 字节
+void decodeFinish(Base64DecodeState &state,
+                  unsigned char *out,
+                  DecodeResult &result,
+                  Base64DecodeMode mode)
+{
+    const bool strict = mode == Base64DecodeMode::Strict;
+    bool ok = true;
+    if (state.padding != 0) {
+        ok = !strict || state.padding == state.expectedPadding;
+    } else if (state.count == 1 || (state.count != 0 && strict)) {
+        ok = false;
+    } else if (state.count != 0) {
+        flushPartial(state, out + result.written, false);
+        result.written += state.count - 1;
+    }
+    state = Base64DecodeState{};
+    result.ok = ok;
+}
+
+void checkOutput(size_t size, size_t bound)
+{
+    if (size < bound) {
+        throw std::invalid_argument("Output buffer too small for base64");
+    }
+}
+
+// 流式编解码每次读取的输入大小
+constexpr size_t kStreamChunkSize = 1 << 20;
+
+template<typename Codec>
+void transformStream(Codec &codec, std::istream &in, std::ostream &out)
+{
+    OpenSSLUtils::readStream(in, kStreamChunkSize, [&](std::span<const char> chunk) {
+        const std::string result = codec.update(std::string_view(chunk.data(), chunk.size()));
+        OpenSSLUtils::writeStream(out, result.data(), result.size());
+    });
+    const std::string tail = codec.final();
+    OpenSSLUtils::writeStream(out, tail.data(), tail.size());
+}
+
+} // namespace
+
+size_t base64DecodedSize(std::string_view encoded)
+{
+    size_t n = encoded.size();
+    for (int i = 0; i < 2 && n > 0 && encoded[n - 1] == '='; ++i) {
+        --n;
+    }
+    return n / 4 * 3 + (n % 4 > 1 ? n % 4 - 1 : 0);
+}
+
+char *base64Encode(const void *data, size_t n, char *out, Base64Alphabet alphabet, bool padding)
+{
+    const auto *in = static_cast<const unsigned char *>(data);
+    size_t done = 0;
+#ifdef OPENSSL_BASE64_AVX2
+    if (useAvx2()) {
+        done = Base64Kernel::encodeAvx2(in, n, out, alphabet);
+    }
+#endif
+    const auto &pairs = alphabet == Base64Alphabet::UrlSafe ? kUrlSafePairs : kStandardPairs;
+    encodeScalar(in + done, n - done, out + done / 3 * 4, pairs, padding);
+    return out + base64EncodedSize(n, padding);
+}
+
+bool base64Decode(std::string_view in,
+                  void *out,
+                  size_t *outSize,
+                  Base64DecodeMode mode,
+                  Base64Alphabet alphabet,
+                  size_t *errorPos)
+{
+    auto *dest = static_cast<unsigned char *>(out);
+    Base64DecodeState state;
+    DecodeResult result;
+    decodeRun(in, dest, base64DecodedSize(in), state, result, mode, alphabet);
+    if (result.ok) {
+        decodeFinish(state, dest, result, mode);
+        result.errorPos = in.size();
+    }
+    if (!result.ok) {
+        if (errorPos != nullptr) {
+            *errorPos = result.errorPos;
+        }
+        return false;
+    }
+    if (outSize != nullptr) {
+        *outSize = result.written;
+    }
+    return true;
+}
+
+std::string base64Encode(std::string_view in, Base64Alphabet alphabet, bool padding)
+{
+    std::string result(base64EncodedSize(in.size(), padding), '\0');
+    base64Encode(in.data(), in.size(), result.data(), alphabet, padding);
+    return result;
+}
+
+std::string base64Decode(std::string_view in, Base64DecodeMode mode, Base64Alphabet alphabet)
+{
+    std::string result(base64DecodedSize(in), '\0');
+    size_t size = 0;
+    size_t errorPos = 0;
+    if (!base64Decode(in, result.data(), &size, mode, alphabet, &errorPos)) {
+        if (errorPos == in.size()) {
+            throw std::invalid_argument("base64Decode: truncated input or incomplete padding");
+        }
+        throw std::invalid_argument("base64Decode: invalid character at position "
+                                    + std::to_string(errorPos));
+    }
+    result.resize(size);
+    return result;
+}
+
+Base64Encoder::Base64Encoder(Base64Alphabet alphabet,
+                             bool padding,
+                             size_t lineLength,
+                             std::string_view lineBreak)
+    : m_alphabet(alphabet)
+    , m_padding(padding)
+    , m_lineLength(lineLength)
+    , m_lineBreak(lineBreak)
+{
+    if (lineLength % 4 != 0) {
+        throw std::invalid_argument("Base64Encoder: line length must be a multiple of 4");
+    }
+}
+
+size_t Base64Encoder::updateBound(size_t inputSize) const
+{
+    const size_t chars = (m_pendingSize + inputSize) / 3 * 4;
+    if (m_lineLength == 0) {
+        return chars;
+    }
+    return chars + (m_column + chars) / m_lineLength * m_lineBreak.size();
+}
+
+size_t Base64Encoder::finalBound() const
+{
+    return 4 + (m_lineLength == 0 ? 0 : m_lineBreak.size());
+}
+
+char *Base64Encoder::breakLineIfFull(char *out)
+{
+    if (m_lineLength != 0 && m_column == m_lineLength) {
+        memcpy(out, m_lineBreak.data(), m_lineBreak.size());
+        out += m_lineBreak.size();
+        m_column = 0;
+    }
+    return out;
+}
+
+// n 为 3 的倍数，按行切开后整段交给 base64Encode
+char *Base64Encoder::encodeGroups(const unsigned char *in, size_t n, char *out)
+{
+    while (n > 0) {
+        const size_t take = m_lineLength == 0 ? n
+                                               : std::min(n, (m_lineLength - m_column) / 4 * 3);
+        out = base64Encode(in, take, out, m_alphabet);
+        m_column += take / 3 * 4;
+        in += take;
+        n -= take;
+        out = breakLineIfFull(out);
+    }
+    return out;
+}
+
+size_t Base64Encoder::update(std::span<const std::byte> in, std::span<char> out)
+{
+    checkOutput(out.size(), updateBound(in.size()));
+    const auto *data = reinterpret_cast<const unsigned char *>(in.data());
+    size_t n = in.size();
+    char *dest = out.data();
+
+    // 先用新数据补齐上次暂存的 1~2 字节
+    if (m_pendingSize > 0) {
+        const size_t take = std::min(3 - m_pendingSize, n);
+        unsigned char group[3];
+        memcpy(group, m_pending, m_pendingSize);
+        memcpy(group + m_pendingSize, data, take);
+        data += take;
+        n -= take;
+        if (m_pendingSize + take < 3) {
+            memcpy(m_pending, group, m_pendingSize + take);
+            m_pendingSize += take;
+            return 0;
+        }
+        dest = encodeGroups(group, 3, dest);
+        m_pendingSize = 0;
+    }
+
+    const size_t whole = n / 3 * 3;
+    dest = encodeGroups(data, whole, dest);
+    m_pendingSize = n - whole;
+    memcpy(m_pending, data + whole, m_pendingSize);
+    return static_cast<size_t>(dest - out.data());
+}
+
+size_t Base64Encoder::final(std::span<char> out)
+{
+    checkOutput(out.size(), finalBound());
+    char *dest = base64Encode(m_pending, m_pendingSize, out.data(), m_alphabet, m_padding);
+    m_column += base64EncodedSize(m_pendingSize, m_padding);
+    m_pendingSize = 0;
+    if (m_lineLength != 0 && m_column != 0) {
+        memcpy(dest, m_lineBreak.data(), m_lineBreak.size());
+        dest += m_lineBreak.size();
+    }
+    m_column = 0;
+    return static_cast<size_t>(dest - out.data());
+}
+
+std::string Base64Encoder::update(std::string_view in)
+{
+    std::string out(updateBound(in.size()), '\0');
+    out.resize(update(std::as_bytes(std::span(in)), std::span(out)));
+    return out;
+}
+
+std::string Base64Encoder::final()
+{
+    std::string out(finalBound(), '\0');
+    out.resize(final(std::span(out)));
+    return out;
+}
+
+Base64Decoder::Base64Decoder(Base64DecodeMode mode, Base64Alphabet alphabet)
+    : m_mode(mode)
+    , m_alphabet(alphabet)
+{}
+
+size_t Base64Decoder::updateBound(size_t inputSize) const
+{
+    // 与 base64DecodedSize 相同：遇到填充时 2~3 个字符也会写出 1~2 字节
+    const size_t n = static_cast<size_t>(m_state.count) + inputSize;
+    return n / 4 * 3 + (n % 4 > 1 ? n % 4 - 1 : 0);
+}
+
+size_t Base64Decoder::update(std::string_view in, std::span<std::byte> out)
+{
+    checkOutput(out.size(), updateBound(in.size()));
+    DecodeResult result;
+    decodeRun(in,
+              reinterpret_cast<unsigned char *>(out.data()),
+              out.size(),
+              m_state,
+              result,
+              m_mode,
+              m_alphabet);
+    if (!result.ok) {
+        throw std::invalid_argument("Base64Decoder: invalid character at position "
+                                    + std::to_string(m_consumed + result.errorPos));
+    }
+    m_consumed += in.size();
+    return result.written;
+}
+
+size_t Base64Decoder::final(std::span<std::byte> out)
+{
+    checkOutput(out.size(), finalBound());
+    DecodeResult result;
+    decodeFinish(m_state, reinterpret_cast<unsigned char *>(out.data()), result, m_mode);
+    m_consumed = 0;
+    if (!result.ok) {
+        throw std::invalid_argument("Base64Decoder: truncated input or incomplete padding");
+    }
+    return result.written;
+}
+
+std::string Base64Decoder::update(std::string_view in)
+{
+    std::string out(updateBound(in.size()), '\0');
+    out.resize(update(in, std::as_writable_bytes(std::span(out))));
+    return out;
+}
+
+std::string Base64Decoder::final()
+{
+    std::string out(finalBound(), '\0');
+    out.resize(final(std::as_writable_bytes(std::span(out))));
+    return out;
+}
+
+void base64EncodeStream(std::istream &in,
+                        std::ostream &out,
+                        Base64Alphabet alphabet,
+                        size_t lineLength,
+                        std::string_view lineBreak)
+{
+    Base64Encoder encoder(alphabet, true, lineLength, lineBreak);
+    transformStream(encoder, in, out);
+}
+
+void base64DecodeStream(std::istream &in,
+                        std::ostream &out,
+                        Base64DecodeMode mode,
+                        Base64Alphabet alphabet)
+{
+    Base64Decoder decoder(mode, alphabet);
+    transformStream(decoder, in, out);
+}
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <span>
+#include <string>
+#include <string_view>
+
+// Base64 编解码（RFC 4648），不经过 BIO，结果直接写入调用方缓冲区或预先定好长度的字符串。
+// x86 上 CPU 支持 AVX2 时每次处理 24 字节输入 / 32 个字符：编码用字节重排拆出 6 位组再查表，
+// 解码用高低半字节查表同时完成校验与取值；其余情况以及不足一块的尾部使用查表的标量实现
+
+enum class Base64Alphabet {
+    Standard, // A-Z a-z 0-9 + /
+    UrlSafe,  // A-Z a-z 0-9 - _，用于 URL 与文件名
+};
+
+enum class Base64DecodeMode {
+    // 只接受所选字母表中的字符，必须带完整的 '=' 填充（长度为 4 的倍数），
+    // 填充前最后一个字符中未用到的位必须为 0，即每段数据只有唯一的合法编码
+    Strict,
+    // 跳过空白字符（空格、\t、\r、\n），填充可以省略，标准与 URL 安全两种字母表的字符都接受，
+    // 不检查未用到的位。'=' 之后仍不能再出现数据字符
+    Lenient,
+};
+
+// 编码 n 字节后的字符数
+constexpr size_t base64EncodedSize(size_t n, bool padding = true)
+{
+    return padding ? (n + 2) / 3 * 4 : n / 3 * 4 + (n % 3 == 0 ? 0 : n % 3 + 1);
+}
+
+// 解码 encoded 所需的缓冲区大小。不含空白字符时就是解码后的准确长度，否则为上限
+size_t base64DecodedSize(std::string_view encoded);
+
+// 将 n 字节编码写入 out（至少 base64EncodedSize(n, padding) 字节，不追加 '\0'），返回写入结束位置
+char *base64Encode(const void *data,
+                   size_t n,
+                   char *out,
+                   Base64Alphabet alphabet = Base64Alphabet::Standard,
+                   bool padding = true);
+
+// 解码写入 out（至少 base64DecodedSize(in) 字节），不抛异常。成功时 outSize 为写入的字节数；
+// 失败返回 false，errorPos 为第一个不合法字符的位置（严格模式下未用到的位不为 0 时为其后的 '='），
+// 输入在需要更多字符处结束时为 in.size()
+bool base64Decode(std::string_view in,
+                  void *out,
+                  size_t *outSize,
+                  Base64DecodeMode mode = Base64DecodeMode::Strict,
+                  Base64Alphabet alphabet = Base64Alphabet::Standard,
+                  size_t *errorPos = nullptr);
+
+// 便捷接口，解码失败时抛出 std::invalid_argument
+std::string base64Encode(std::string_view in,
+                         Base64Alphabet alphabet = Base64Alphabet::Standard,
+                         bool padding = true);
+std::string base64Decode(std::string_view in,
+                         Base64DecodeMode mode = Base64DecodeMode::Strict,
+                         Base64Alphabet alphabet = Base64Alphabet::Standard);
+
+// 常用的换行长度：MIME（RFC 2045）每行 76 个字符，PEM（RFC 7468）每行 64 个字符
+constexpr size_t kBase64MimeLineLength = 76;
+constexpr size_t kBase64PemLineLength = 64;
+
+// 增量编码：update 可以传入任意长度的数据，不足 3 字节的 0~2 字节留到下一次调用，
+// 其余直接编码到调用方缓冲区，内存占用与数据总长度无关，输出与一次性编码整块数据相同。
+// lineLength 不为 0 时每输出 lineLength 个字符追加一次 lineBreak，最后一行不满时在 final 中补上换行
+class Base64Encoder
+{
+public:
+    // lineLength 必须是 4 的倍数，否则抛出 std::invalid_argument
+    explicit Base64Encoder(Base64Alphabet alphabet = Base64Alphabet::Standard,
+                           bool padding = true,
+                           size_t lineLength = 0,
+                           std::string_view lineBreak = "\n");
+
+    // 本次 update/final 最多输出的字符数
+    [[nodiscard]] size_t updateBound(size_t inputSize) const;
+    [[nodiscard]] size_t finalBound() const;
+
+    // out 至少 updateBound(in.size()) 字节，返回写入的字符数
+    size_t update(std::span<const std::byte> in, std::span<char> out);
+    // 写出暂存的 0~2 字节与填充，out 至少 finalBound() 字节。之后可以继续编码下一段数据
+    size_t final(std::span<char> out);
+
+    std::string update(std::string_view in);
+    std::string final();
+
+private:
+    char *encodeGroups(const unsigned char *in, size_t n, char *out);
+    char *breakLineIfFull(char *out);
+
+    Base64Alphabet m_alphabet;
+    bool m_padding;
+    size_t m_lineLength;
+    std::string m_lineBreak;
+    size_t m_column = 0;
+    unsigned char m_pending[2] = {};
+    size_t m_pendingSize = 0;
+};
+
+// 解码状态：尚未凑满 4 个字符的 6 位组，以及已经读到的填充。一次性解码与 Base64Decoder 共用
+struct Base64DecodeState
+{
+    uint32_t bits = 0;
+    int count = 0;
+    int padding = 0;
+    int expectedPadding = 0;
+};
+
+// 增量解码：不足 4 个字符的 0~3 个字符以 6 位组的形式留到下一次调用，规则与一次性的 base64Decode 相同，
+// 输入在任意位置切分结果都一样。换行后的输入（如 Base64Encoder 带 lineLength 的输出）需要 Lenient 模式
+class Base64Decoder
+{
+public:
+    explicit Base64Decoder(Base64DecodeMode mode = Base64DecodeMode::Strict,
+                           Base64Alphabet alphabet = Base64Alphabet::Standard);
+
+    [[nodiscard]] size_t updateBound(size_t inputSize) const;
+    [[nodiscard]] static constexpr size_t finalBound() { return 2; }
+
+    // 出现不合法字符时抛出 std::invalid_argument，消息中的位置从本段数据的第一个字符起计算。
+    // 抛出异常后解码器停在出错位置，不能继续使用
+    size_t update(std::string_view in, std::span<std::byte> out);
+    // 检查输入在完整的位置结束（严格模式下填充完整），宽松模式下写出省略了填充的最后 1~2 字节。
+    // 之后可以继续解码下一段数据
+    size_t final(std::span<std::byte> out);
+
+    std::string update(std::string_view in);
+    std::string final();
+
+private:
+    Base64DecodeMode m_mode;
+    Base64Alphabet m_alphabet;
+    Base64DecodeState m_state;
+    uint64_t m_consumed = 0;
+};
+
+// 流式编解码，输入按 1 MiB 分块读取，内存占用恒定
+void base64EncodeStream(std::istream &in,
+                        std::ostream &out,
+                        Base64Alphabet alphabet = Base64Alphabet::Standard,
+                        size_t lineLength = 0,
+                        std::string_view lineBreak = "\n");
+void base64DecodeStream(std::istream &in,
+                        std::ostream &out,
+                        Base64DecodeMode mode = Base64DecodeMode::Strict,
+                        Base64Alphabet alphabet = Base64Alphabet::Standard);
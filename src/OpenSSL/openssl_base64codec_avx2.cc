@@ -0,0 +1,193 @@
+#include "openssl_base64codec_simd.hpp"
+
+#include <immintrin.h>
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+namespace {
+
+constexpr std::string_view kStandardChars
+    = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+constexpr std::string_view kUrlSafeChars
+    = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+// 编码查表：6 位组先归类为 0（a-z）、1~10（0-9）、11、12（最后两个符号）、13（A-Z），
+// 再按类别取出 ASCII 与 6 位组之差
+constexpr auto makeEncodeOffsets(std::string_view chars) -> std::array<int8_t, 16>
+{
+    std::array<int8_t, 16> offsets{};
+    offsets[0] = static_cast<int8_t>(chars[26] - 26);
+    for (int i = 1; i <= 10; ++i) {
+        offsets[i] = static_cast<int8_t>(chars[52] - 52);
+    }
+    offsets[11] = static_cast<int8_t>(chars[62] - 62);
+    offsets[12] = static_cast<int8_t>(chars[63] - 63);
+    offsets[13] = static_cast<int8_t>(chars[0]);
+    return offsets;
+}
+
+// 解码查表。字符按高半字节分组，同一组内合法的低半字节集合相同的共用一个标志位，
+// lo[低半字节] 记录该低半字节在哪些组中不合法，hi[高半字节] 为所在组的标志位，
+// 两者相与非零即为非法字符。非 ASCII 与控制字符所在的组在 lo 中全部置位。
+// 取值为字符加 roll[高半字节]，与同组其他字符差值不同的那个符号单独处理
+struct DecodeTables
+{
+    std::array<uint8_t, 16> lo{};
+    std::array<uint8_t, 16> hi{};
+    std::array<int8_t, 16> roll{};
+    char special = 0;
+    int8_t specialRoll = 0;
+};
+
+constexpr auto makeDecodeTables(std::string_view chars) -> DecodeTables
+{
+    DecodeTables tables;
+    std::array<uint16_t, 16> validLow{};
+    for (size_t value = 0; value < chars.size(); ++value) {
+        const auto c = static_cast<unsigned char>(chars[value]);
+        validLow[c >> 4] = static_cast<uint16_t>(validLow[c >> 4] | (1u << (c & 0xF)));
+    }
+
+    std::array<uint16_t, 8> groups{};
+    int groupCount = 0;
+    for (int h = 0; h < 16; ++h) {
+        int group = 0;
+        while (group < groupCount && groups[group] != validLow[h]) {
+            ++group;
+        }
+        if (group == groupCount) {
+            groups[groupCount++] = validLow[h];
+        }
+        tables.hi[h] = static_cast<uint8_t>(1u << group);
+        for (int l = 0; l < 16; ++l) {
+            if ((validLow[h] & (1u << l)) == 0) {
+                tables.lo[l] = static_cast<uint8_t>(tables.lo[l] | tables.hi[h]);
+            }
+        }
+    }
+
+    // 最后一个符号（'/' 或 '_'）与同组字符的差值不同
+    tables.special = chars[63];
+    tables.specialRoll = static_cast<int8_t>(63 - chars[63]);
+    for (size_t value = 0; value < 63; ++value) {
+        const auto c = static_cast<unsigned char>(chars[value]);
+        tables.roll[c >> 4] = static_cast<int8_t>(static_cast<int>(value) - c);
+    }
+    return tables;
+}
+
+// 分组不超过 8 个、每组内（除 special 外）差值一致时查表才成立
+constexpr bool checkDecodeTables(std::string_view chars, const DecodeTables &tables)
+{
+    for (int c = 0; c < 256; ++c) {
+        const bool invalid = (tables.lo[c & 0xF] & tables.hi[c >> 4]) != 0;
+        const size_t value = chars.find(static_cast<char>(c));
+        if (invalid != (value == std::string_view::npos)) {
+            return false;
+        }
+        if (!invalid && c != static_cast<unsigned char>(tables.special)
+            && c + tables.roll[c >> 4] != static_cast<int>(value)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+constexpr auto kStandardEncode = makeEncodeOffsets(kStandardChars);
+constexpr auto kUrlSafeEncode = makeEncodeOffsets(kUrlSafeChars);
+constexpr auto kStandardDecode = makeDecodeTables(kStandardChars);
+constexpr auto kUrlSafeDecode = makeDecodeTables(kUrlSafeChars);
+static_assert(checkDecodeTables(kStandardChars, kStandardDecode));
+static_assert(checkDecodeTables(kUrlSafeChars, kUrlSafeDecode));
+
+inline __m256i broadcast16(const void *table)
+{
+    return _mm256_broadcastsi128_si256(_mm_loadu_si128(static_cast<const __m128i *>(table)));
+}
+
+} // namespace
+
+size_t Base64Kernel::encodeAvx2(const unsigned char *in,
+                                size_t n,
+                                char *out,
+                                Base64Alphabet alphabet)
+{
+    const __m256i offsets = broadcast16(
+        alphabet == Base64Alphabet::UrlSafe ? kUrlSafeEncode.data() : kStandardEncode.data());
+    // 每个 32 位字放入一组 3 字节 s0 s1 s2，排成 s1 s0 s2 s1，使 4 个 6 位组分别落在可移位的位置上
+    const __m256i spread = _mm256_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,
+                                            1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+    size_t done = 0;
+    for (; n - done >= 28; done += 24) {
+        const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + done));
+        const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + done + 12));
+        const __m256i bytes = _mm256_shuffle_epi8(
+            _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1), spread);
+
+        // 两次 16 位乘法代替可变移位，得到 4 个各占一个字节的 6 位组
+        const __m256i ac = _mm256_mulhi_epu16(
+            _mm256_and_si256(bytes, _mm256_set1_epi32(0x0FC0FC00)), _mm256_set1_epi32(0x04000040));
+        const __m256i bd = _mm256_mullo_epi16(
+            _mm256_and_si256(bytes, _mm256_set1_epi32(0x003F03F0)), _mm256_set1_epi32(0x01000010));
+        const __m256i indices = _mm256_or_si256(ac, bd);
+
+        // 0~51 饱和减法后为 0，52~63 为 1~12；0~25 再改为 13
+        __m256i category = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+        const __m256i upper = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+        category = _mm256_or_si256(category, _mm256_and_si256(upper, _mm256_set1_epi8(13)));
+        const __m256i chars = _mm256_add_epi8(indices, _mm256_shuffle_epi8(offsets, category));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out), chars);
+        out += 32;
+    }
+    return done;
+}
+
+size_t Base64Kernel::decodeAvx2(const char *in,
+                                size_t n,
+                                unsigned char *out,
+                                size_t outRoom,
+                                Base64Alphabet alphabet)
+{
+    const DecodeTables &tables = alphabet == Base64Alphabet::UrlSafe ? kUrlSafeDecode
+                                                                      : kStandardDecode;
+    const __m256i lowTable = broadcast16(tables.lo.data());
+    const __m256i highTable = broadcast16(tables.hi.data());
+    const __m256i rollTable = broadcast16(tables.roll.data());
+    const __m256i special = _mm256_set1_epi8(tables.special);
+    const __m256i specialRoll = _mm256_set1_epi8(tables.specialRoll);
+    const __m256i nibbleMask = _mm256_set1_epi8(0x0F);
+    // 每个 32 位字中的 3 个有效字节按大端顺序取出，两个 128 位通道各 12 字节
+    const __m256i gather = _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+                                            2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+    const __m256i compact = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7);
+
+    size_t done = 0;
+    size_t written = 0;
+    while (n - done >= 32 && outRoom - written >= 32) {
+        const __m256i chars = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + done));
+        const __m256i high = _mm256_and_si256(_mm256_srli_epi32(chars, 4), nibbleMask);
+        const __m256i low = _mm256_and_si256(chars, nibbleMask);
+        const __m256i lowBits = _mm256_shuffle_epi8(lowTable, low);
+        const __m256i highBits = _mm256_shuffle_epi8(highTable, high);
+        if (!_mm256_testz_si256(lowBits, highBits)) {
+            break;
+        }
+
+        const __m256i roll = _mm256_blendv_epi8(_mm256_shuffle_epi8(rollTable, high),
+                                                specialRoll,
+                                                _mm256_cmpeq_epi8(chars, special));
+        const __m256i values = _mm256_add_epi8(chars, roll);
+
+        // 相邻两个 6 位组合成 12 位，再两两合成 24 位
+        const __m256i pairs = _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+        const __m256i words = _mm256_madd_epi16(pairs, _mm256_set1_epi32(0x00011000));
+        const __m256i bytes = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(words, gather),
+                                                          compact);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + written), bytes);
+        done += 32;
+        written += 24;
+    }
+    return done;
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "openssl_base64codec.hpp"
+
+#include <cstddef>
+
+// Base64 的向量内核，在 openssl_base64codec_avx2.cc 中以 -mavx2 单独编译，
+// 由 openssl_base64codec.cc 在运行时确认 CPU 支持后调用
+namespace Base64Kernel {
+
+#ifdef OPENSSL_BASE64_AVX2
+// 每次读取 28 字节、编码其中 24 字节为 32 个字符，剩余不足 28 字节时停止。
+// 返回已编码的输入字节数（3 的倍数），尾部交给标量实现
+size_t encodeAvx2(const unsigned char *in, size_t n, char *out, Base64Alphabet alphabet);
+
+// 每次解码 32 个字符为 24 字节，但会写满 32 字节，因此还要求 outRoom 至少 32。
+// 遇到含有字母表以外字符（包括 '=' 与空白）的块时停在该块开头，返回已解码的字符数（32 的倍数）
+size_t decodeAvx2(const char *in,
+                  size_t n,
+                  unsigned char *out,
+                  size_t outRoom,
+                  Base64Alphabet alphabet);
+#endif
+
+} // namespace Base64Kernel
@@ -0,0 +1,593 @@
+#include "openssl_aesmodes.hpp"
+#include "openssl_aesstream.hpp"
+#include "openssl_base64codec.hpp"
+#include "openssl_context.hpp"
+#include "openssl_hasher.hpp"
+#include "openssl_rsakey.hpp"
+#include "openssl_treehash.hpp"
+
+#include <Thread/threadpool.hpp>
+
+#include <utils/benchmarkmain.hpp>
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <initializer_list>
+#include <iomanip>
+#include <span>
+#include <sstream>
+#include <utility>
+
+// 运行方式：
+//   openssl_bench                                  # 默认输出 JSON 到 openssl_bench.json
+//   openssl_bench --benchmark_filter=Hex           # 只运行十六进制编解码用例
+//   openssl_bench --benchmark_filter=Base64        # BIO 链与向量化 Base64 编解码对比、分块增量编码
+//   openssl_bench --benchmark_filter=Hash          # 只运行摘要相关用例
+//   openssl_bench --benchmark_filter=PerMessage    # 小消息上下文复用前后的单条开销
+//   openssl_bench --benchmark_filter=HashBatch     # 批量哈希随线程数的扩展性
+//   openssl_bench --benchmark_filter=TreeHash      # 单个大输入的树形哈希随线程数的扩展性
+//   openssl_bench --benchmark_filter=AesModes      # CBC 与 GCM/CTR 加密吞吐量对比
+//   openssl_bench --benchmark_filter=AesParallel   # 分段 GCM/CTR 随线程数的扩展性
+//   openssl_bench --benchmark_filter=RsaDecrypt    # RSA-2048 批量解密每秒次数随线程数的变化
+
+namespace {
+
+// 旧实现：逐字节经过 stringstream 格式化，作为对比基线
+auto toHexStream(const std::string &str) -> std::string
+{
+    std::stringstream ss;
+    ss << std::hex << std::setfill('0');
+    for (unsigned char c : str) {
+        ss << std::setw(2) << static_cast<int>(c);
+    }
+    return ss.str();
+}
+
+auto fromHexStoi(const std::string &str) -> std::string
+{
+    std::string result;
+    for (size_t i = 0; i < str.length(); i += 2) {
+        result.push_back(static_cast<char>(std::stoi(str.substr(i, 2), nullptr, 16)));
+    }
+    return result;
+}
+
+// 旧的 Base64 实现：经过 BIO_f_base64 + BIO_s_mem 链，再从内存 BIO 拷贝出结果
+auto base64EncodeBio(const std::string &input) -> std::string
+{
+    BIO *b64 = BIO_new(BIO_f_base64());
+    BIO_set_flags(b64, BIO_FLAGS_BASE64_NO_NL);
+    BIO *bmem = BIO_new(BIO_s_mem());
+    b64 = BIO_push(b64, bmem);
+    BIO_write(b64, input.data(), static_cast<int>(input.size()));
+    BIO_flush(b64);
+    char *outputData = nullptr;
+    const long outputLen = BIO_get_mem_data(bmem, &outputData);
+    std::string output(outputData, outputLen);
+    BIO_free_all(b64);
+    return output;
+}
+
+auto base64DecodeBio(const std::string &input) -> std::string
+{
+    BIO *b64 = BIO_new(BIO_f_base64());
+    BIO_set_flags(b64, BIO_FLAGS_BASE64_NO_NL);
+    BIO *bmem = BIO_new_mem_buf(input.data(), static_cast<int>(input.size()));
+    bmem = BIO_push(b64, bmem);
+    std::string output(input.size(), '\0');
+    const int decodedLen = BIO_read(bmem, output.data(), static_cast<int>(output.size()));
+    output.resize(decodedLen > 0 ? decodedLen : 0);
+    BIO_free_all(bmem);
+    return output;
+}
+
+auto randomBytes(size_t size) -> std::string
+{
+    std::string data(size, '\0');
+    if (RAND_bytes(reinterpret_cast<unsigned char *>(data.data()), static_cast<int>(size)) != 1) {
+        handleOpenSSLError();
+    }
+    return data;
+}
+
+// 旧实现在大输入上过慢，只测到 1 MiB
+constexpr int64_t kLegacyMaxSize = 1 << 20;
+
+enum CodecImpl : int64_t { Legacy, String, Buffer };
+
+const char *const kCodecImplNames[] = {"legacy", "string", "buffer"};
+
+// 十六进制与 Base64 编解码共用：32 B ~ 64 MiB，依次测试旧实现、
+// 返回 std::string 的接口与写入预分配缓冲区的接口
+void codecArguments(benchmark::internal::Benchmark *benchmark)
+{
+    for (int64_t size : benchmark::CreateRange(32, 64 << 20, 8)) {
+        for (int64_t impl : {Legacy, String, Buffer}) {
+            if (impl != Legacy || size <= kLegacyMaxSize) {
+                benchmark->Args({size, impl});
+            }
+        }
+    }
+}
+
+// 小消息基准中 range(1) 的取值：每次新建上下文 + 隐式 fetch，或线程缓存上下文 + 预先 fetch
+enum ContextMode : int64_t { FreshContext, CachedContext };
+
+// 旧的做法：每条消息 new/free 一次上下文，Init 时按名字隐式 fetch
+auto digestFresh(const std::string &data, const EVP_MD *md) -> std::string
+{
+    EVP_MD_CTX *ctx = EVP_MD_CTX_new();
+    unsigned char digest[EVP_MAX_MD_SIZE];
+    unsigned int length = 0;
+    EVP_DigestInit_ex(ctx, md, nullptr);
+    EVP_DigestUpdate(ctx, data.data(), data.size());
+    EVP_DigestFinal_ex(ctx, digest, &length);
+    EVP_MD_CTX_free(ctx);
+    return std::string(reinterpret_cast<char *>(digest), length);
+}
+
+auto digestCached(const std::string &data, const EVP_MD *md) -> std::string
+{
+    Hasher hasher(md);
+    hasher.update(data);
+    return hasher.final();
+}
+
+// AES-256-CBC 加密一条消息，cipher 与 ctx 由调用方决定是否复用
+auto cbcEncrypt(EVP_CIPHER_CTX *ctx,
+                const EVP_CIPHER *cipher,
+                const std::string &key,
+                const std::string &iv,
+                const std::string &data) -> std::string
+{
+    std::string out(data.size() + 16, '\0');
+    int len = 0;
+    int total = 0;
+    EVP_EncryptInit_ex(ctx,
+                       cipher,
+                       nullptr,
+                       reinterpret_cast<const unsigned char *>(key.data()),
+                       reinterpret_cast<const unsigned char *>(iv.data()));
+    EVP_EncryptUpdate(ctx,
+                      reinterpret_cast<unsigned char *>(out.data()),
+                      &len,
+                      reinterpret_cast<const unsigned char *>(data.data()),
+                      static_cast<int>(data.size()));
+    total = len;
+    EVP_EncryptFinal_ex(ctx, reinterpret_cast<unsigned char *>(out.data()) + total, &len);
+    out.resize(total + len);
+    return out;
+}
+
+// AES 模式基准中 range(1) 的取值。CBC 沿用 aesEncryptWithIV 原来的做法：
+// 密文写入 std::string 后再拼接到 IV 后面；GCM/CTR 直接写入预分配的缓冲区
+enum AesBenchMode : int64_t { CbcString, GcmEncrypt, GcmDecrypt, CtrEncrypt };
+
+const char *const kAesBenchModeNames[] = {"cbc string",
+                                          "gcm encrypt",
+                                          "gcm decrypt",
+                                          "ctr encrypt"};
+
+// 生成 RSA-2048 密钥对并经过 PEM 得到已解析的句柄
+auto generateRsaKeys() -> std::pair<RsaPublicKey, RsaPrivateKey>
+{
+    EVP_PKEY *pkey = EVP_RSA_gen(2048);
+    if (pkey == nullptr) {
+        handleOpenSSLError();
+    }
+    const auto toPem = [pkey](bool isPrivate) {
+        BIO *bio = BIO_new(BIO_s_mem());
+        const int ok = isPrivate ? PEM_write_bio_PrivateKey(bio, pkey, nullptr, nullptr, 0,
+                                                            nullptr, nullptr)
+                                 : PEM_write_bio_PUBKEY(bio, pkey);
+        char *data = nullptr;
+        const long size = BIO_get_mem_data(bio, &data);
+        std::string pem(data, ok == 1 ? size : 0);
+        BIO_free(bio);
+        return pem;
+    };
+    const std::string publicPem = toPem(false);
+    const std::string privatePem = toPem(true);
+    EVP_PKEY_free(pkey);
+    return {RsaPublicKey::fromPem(publicPem), RsaPrivateKey::fromPem(privatePem)};
+}
+
+} // namespace
+
+// 十六进制编码，旧实现逐字节经过 stringstream
+static void BM_ToHex(benchmark::State &state)
+{
+    const auto size = static_cast<size_t>(state.range(0));
+    const auto impl = state.range(1);
+    const std::string data = randomBytes(size);
+    std::string buffer(size * 2, '\0');
+
+    for (auto _ : state) {
+        if (impl == Buffer) {
+            benchmark::DoNotOptimize(toHex(data.data(), size, buffer.data()));
+        } else {
+            std::string hex = impl == Legacy ? toHexStream(data) : toHex(data);
+            benchmark::DoNotOptimize(hex);
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+    state.SetLabel(kCodecImplNames[impl]);
+}
+BENCHMARK(BM_ToHex)->Apply(codecArguments);
+
+// 十六进制解码，旧实现逐对 substr + stoi
+static void BM_FromHex(benchmark::State &state)
+{
+    const auto size = static_cast<size_t>(state.range(0));
+    const auto impl = state.range(1);
+    const std::string hex = toHex(randomBytes(size));
+    std::string buffer(size, '\0');
+
+    for (auto _ : state) {
+        if (impl == Buffer) {
+            benchmark::DoNotOptimize(fromHex(hex, buffer.data()));
+        } else {
+            std::string data = impl == Legacy ? fromHexStoi(hex) : fromHex(hex);
+            benchmark::DoNotOptimize(data);
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+    state.SetLabel(kCodecImplNames[impl]);
+}
+BENCHMARK(BM_FromHex)->Apply(codecArguments);
+
+// Base64 编码，旧实现经过 BIO 链；range(0) 为编码前的字节数
+static void BM_Base64Encode(benchmark::State &state)
+{
+    const auto size = static_cast<size_t>(state.range(0));
+    const auto impl = state.range(1);
+    const std::string data = randomBytes(size);
+    std::string buffer(base64EncodedSize(size), '\0');
+
+    for (auto _ : state) {
+        if (impl == Buffer) {
+            benchmark::DoNotOptimize(base64Encode(data.data(), size, buffer.data()));
+        } else {
+            std::string text = impl == Legacy ? base64EncodeBio(data) : base64Encode(data);
+            benchmark::DoNotOptimize(text);
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+    state.SetLabel(kCodecImplNames[impl]);
+}
+BENCHMARK(BM_Base64Encode)->Apply(codecArguments);
+
+// Base64 严格模式解码；range(0) 为解码后的字节数
+static void BM_Base64Decode(benchmark::State &state)
+{
+    const auto size = static_cast<size_t>(state.range(0));
+    const auto impl = state.range(1);
+    const std::string text = base64Encode(randomBytes(size));
+    std::string buffer(size, '\0');
+
+    for (auto _ : state) {
+        if (impl == Buffer) {
+            size_t written = 0;
+            benchmark::DoNotOptimize(base64Decode(text, buffer.data(), &written));
+        } else {
+            std::string data = impl == Legacy ? base64DecodeBio(text) : base64Decode(text);
+            benchmark::DoNotOptimize(data);
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+    state.SetLabel(kCodecImplNames[impl]);
+}
+BENCHMARK(BM_Base64Decode)->Apply(codecArguments);
+
+// 64 MiB 数据分块增量编码，range(0) 为每次 update 的块大小，range(1) 为换行长度（0 不换行）。
+// 输出写入固定大小的缓冲区，内存占用与总长度无关
+static void BM_Base64Encoder(benchmark::State &state)
+{
+    const auto chunk = static_cast<size_t>(state.range(0));
+    const auto lineLength = static_cast<size_t>(state.range(1));
+    const std::string data = randomBytes(64 << 20);
+    std::string buffer(base64EncodedSize(chunk + 2) * 2, '\0');
+
+    for (auto _ : state) {
+        Base64Encoder encoder(Base64Alphabet::Standard, true, lineLength, "\r\n");
+        for (size_t offset = 0; offset < data.size(); offset += chunk) {
+            const auto piece = std::as_bytes(std::span(data).subspan(offset, chunk));
+            benchmark::DoNotOptimize(encoder.update(piece, std::span(buffer)));
+        }
+        benchmark::DoNotOptimize(encoder.final(std::span(buffer)));
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(data.size()));
+}
+BENCHMARK(BM_Base64Encoder)->ArgsProduct({{4 << 10, 64 << 10, 1 << 20}, {0, 76}});
+
+// 内存中数据的摘要吞吐量，作为 hashFile 的上限参考
+static void BM_Hasher_Update(benchmark::State &state)
+{
+    const auto size = static_cast<size_t>(state.range(0));
+    const std::string data = randomBytes(size);
+    Hasher hasher(EVP_sha256());
+
+    for (auto _ : state) {
+        hasher.update(data);
+        benchmark::DoNotOptimize(hasher.final());
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Hasher_Update)->Range(4 << 10, 256 << 20)->RangeMultiplier(16);
+
+// 文件流式摘要（文件已在页缓存中），range(1) 为每次映射的块大小
+static void BM_HashFile(benchmark::State &state)
+{
+    const auto size = static_cast<size_t>(state.range(0));
+    const auto chunk = static_cast<size_t>(state.range(1));
+    const auto path = (std::filesystem::temp_directory_path() / "openssl_bench_hashfile.bin")
+                          .string();
+    {
+        const std::string data = randomBytes(size);
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(data.data(), static_cast<std::streamsize>(data.size()));
+    }
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(hashFile(path, EVP_sha256(), chunk));
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+    std::remove(path.c_str());
+}
+BENCHMARK(BM_HashFile)
+    ->ArgsProduct({{16 << 20, 256 << 20}, {1 << 20, 64 << 20}})
+    ->Unit(benchmark::kMillisecond);
+
+// 单条小消息的摘要开销，range(1) 见 ContextMode
+static void BM_PerMessage_Sha256(benchmark::State &state)
+{
+    const std::string data = randomBytes(static_cast<size_t>(state.range(0)));
+    const bool cached = state.range(1) == CachedContext;
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(cached ? digestCached(data, EVP_sha256())
+                                        : digestFresh(data, EVP_sha256()));
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+    state.SetLabel(cached ? "cached ctx + fetched md" : "new ctx + implicit fetch");
+}
+BENCHMARK(BM_PerMessage_Sha256)->ArgsProduct({{16, 64, 256, 1024}, {FreshContext, CachedContext}});
+
+// 单条小消息的 AES-256-CBC 加密开销，range(1) 见 ContextMode
+static void BM_PerMessage_AesCbc(benchmark::State &state)
+{
+    const std::string data = randomBytes(static_cast<size_t>(state.range(0)));
+    const std::string key = randomBytes(32);
+    const std::string iv = randomBytes(16);
+    const bool cached = state.range(1) == CachedContext;
+
+    for (auto _ : state) {
+        if (cached) {
+            CipherContextCache::Lease ctx;
+            benchmark::DoNotOptimize(cbcEncrypt(ctx, fetchCipher(EVP_aes_256_cbc()), key, iv, data));
+        } else {
+            EVP_CIPHER_CTX *ctx = EVP_CIPHER_CTX_new();
+            benchmark::DoNotOptimize(cbcEncrypt(ctx, EVP_aes_256_cbc(), key, iv, data));
+            EVP_CIPHER_CTX_free(ctx);
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+    state.SetLabel(cached ? "cached ctx + fetched cipher" : "new ctx + implicit fetch");
+}
+BENCHMARK(BM_PerMessage_AesCbc)->ArgsProduct({{16, 64, 256, 1024}, {FreshContext, CachedContext}});
+
+// 64 B ~ 64 MiB 单条消息的 AES-256 加解密吞吐量，range(1) 见 AesBenchMode
+static void BM_AesModes(benchmark::State &state)
+{
+    const auto size = static_cast<size_t>(state.range(0));
+    const auto mode = state.range(1);
+    const std::string data = randomBytes(size);
+    const std::string key = randomBytes(kAesKeySize);
+    const auto bytes = std::as_bytes(std::span(data));
+    const AesGcm gcm(key);
+    const AesCtr ctr(key);
+    std::vector<std::byte> sealed(AesGcm::sealedSize(size));
+    std::vector<std::byte> opened(size);
+    if (mode == GcmDecrypt) {
+        gcm.encrypt(bytes, sealed);
+    }
+
+    for (auto _ : state) {
+        switch (mode) {
+        case CbcString: {
+            const std::string iv = randomBytes(16);
+            CipherContextCache::Lease ctx;
+            std::string result = iv;
+            result += cbcEncrypt(ctx, fetchCipher(EVP_aes_256_cbc()), key, iv, data);
+            benchmark::DoNotOptimize(result);
+            break;
+        }
+        case GcmEncrypt:
+            benchmark::DoNotOptimize(gcm.encrypt(bytes, sealed));
+            break;
+        case GcmDecrypt:
+            benchmark::DoNotOptimize(gcm.decrypt(sealed, opened));
+            break;
+        case CtrEncrypt:
+            benchmark::DoNotOptimize(ctr.encrypt(bytes, sealed));
+            break;
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+    state.SetLabel(kAesBenchModeNames[mode]);
+}
+BENCHMARK(BM_AesModes)->ArgsProduct({benchmark::CreateRange(64, 64 << 20, 8),
+                                     {CbcString, GcmEncrypt, GcmDecrypt, CtrEncrypt}});
+
+// 256 MiB 单个输入的分段加解密，range(0) 为参与线程数（含调用线程），
+// 0 表示整块交给单个 AesGcm/AesCtr 的基线；range(1) 见 AesBenchMode（不含 CBC）
+static void BM_AesParallel(benchmark::State &state)
+{
+    const auto threads = static_cast<size_t>(state.range(0));
+    const auto mode = state.range(1);
+    const std::string data = randomBytes(256 << 20);
+    const std::string key = randomBytes(kAesKeySize);
+    const auto bytes = std::as_bytes(std::span(data));
+    const auto streamMode = mode == CtrEncrypt ? AesStreamMode::Ctr : AesStreamMode::Gcm;
+    const AesGcm gcm(key);
+    const AesCtr ctr(key);
+    ThreadPool pool(threads > 1 ? threads - 1 : 1);
+    if (threads <= 1) {
+        pool.shutdown();
+    }
+
+    std::vector<std::byte> sealed(
+        std::max(AesGcm::sealedSize(data.size()), aesStreamSealedSize(data.size(), streamMode)));
+    std::vector<std::byte> opened(data.size());
+    if (mode == GcmDecrypt) {
+        const size_t size = threads == 0 ? gcm.encrypt(bytes, sealed)
+                                         : encryptParallel(bytes, sealed, key, pool);
+        sealed.resize(size);
+    }
+
+    for (auto _ : state) {
+        if (threads == 0) {
+            switch (mode) {
+            case GcmEncrypt:
+                gcm.encrypt(bytes, sealed);
+                break;
+            case GcmDecrypt:
+                gcm.decrypt(sealed, opened);
+                break;
+            case CtrEncrypt:
+                ctr.encrypt(bytes, sealed);
+                break;
+            }
+        } else if (mode == GcmDecrypt) {
+            decryptParallel(sealed, opened, key, pool);
+        } else {
+            encryptParallel(bytes, sealed, key, pool, streamMode);
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(data.size()));
+    state.counters["threads"] = static_cast<double>(threads);
+    state.SetLabel(kAesBenchModeNames[mode]);
+}
+BENCHMARK(BM_AesParallel)
+    ->ArgsProduct({{0, 1, 2, 4, 8, 16}, {GcmEncrypt, GcmDecrypt, CtrEncrypt}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// 批量哈希的吞吐量随参与线程数（含调用线程）的变化，range(0) 为单条消息长度，
+// 共 range(2) 条消息。线程数为 0 时逐条调用一次性的 Hasher 作为基线
+static void BM_HashBatch(benchmark::State &state)
+{
+    const auto size = static_cast<size_t>(state.range(0));
+    const auto threads = static_cast<size_t>(state.range(1));
+    const auto count = static_cast<size_t>(state.range(2));
+    const std::string data = randomBytes(size * count);
+    std::vector<std::span<const std::byte>> inputs;
+    for (size_t i = 0; i < count; ++i) {
+        inputs.push_back(std::as_bytes(std::span(data).subspan(i * size, size)));
+    }
+    std::vector<unsigned char> digests(count * 32);
+    ThreadPool pool(threads > 1 ? threads - 1 : 1);
+    if (threads <= 1) {
+        pool.shutdown(); // pool 停止后 hashBatch 在调用线程串行计算
+    }
+
+    for (auto _ : state) {
+        if (threads == 0) {
+            for (size_t i = 0; i < count; ++i) {
+                Hasher hasher(EVP_sha256());
+                hasher.update(inputs[i]);
+                hasher.final(digests.data() + i * 32);
+            }
+        } else {
+            hashBatch(inputs, EVP_sha256(), pool, digests);
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(2));
+    state.SetBytesProcessed(state.iterations() * state.range(0) * state.range(2));
+    state.counters["threads"] = static_cast<double>(threads);
+}
+BENCHMARK(BM_HashBatch)
+    ->ArgsProduct({{64}, {0, 1, 2, 4, 8, 16}, {1 << 16}})
+    ->ArgsProduct({{4 << 10}, {0, 1, 2, 4, 8, 16}, {1 << 13}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// 256 MiB 单个输入的树形哈希，range(0) 为参与线程数（含调用线程），0 表示普通的串行 SHA-256；
+// range(1) 为 1 时使用 BLAKE2b-512
+static void BM_TreeHash(benchmark::State &state)
+{
+    const auto threads = static_cast<size_t>(state.range(0));
+    const bool blake2 = state.range(1) != 0;
+    const std::string data = randomBytes(256 << 20);
+    const auto bytes = std::as_bytes(std::span(data));
+    ThreadPool pool(threads > 1 ? threads - 1 : 1);
+    if (threads <= 1) {
+        pool.shutdown();
+    }
+
+    for (auto _ : state) {
+        if (threads == 0) {
+            Hasher hasher(blake2 ? EVP_blake2b512() : EVP_sha256());
+            hasher.update(bytes);
+            benchmark::DoNotOptimize(hasher.final());
+        } else {
+            benchmark::DoNotOptimize(blake2 ? treeHashBlake2(bytes, pool)
+                                            : treeHash(bytes, EVP_sha256(), pool));
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(data.size()));
+    state.counters["threads"] = static_cast<double>(threads);
+    state.SetLabel(blake2 ? "blake2b512" : "sha256");
+}
+BENCHMARK(BM_TreeHash)
+    ->ArgsProduct({{0, 1, 2, 4, 8, 16}, {0, 1}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+// 一批 256 条 RSA-2048 OAEP 密文的解密，range(0) 为参与线程数（含调用线程），
+// 0 表示逐条调用 rsaDecrypt 的基线。items_per_second 即每秒私钥运算次数
+static void BM_RsaDecryptBatch(benchmark::State &state)
+{
+    const auto threads = static_cast<size_t>(state.range(0));
+    static const auto keys = generateRsaKeys();
+    std::vector<std::string> ciphertexts;
+    for (int i = 0; i < 256; ++i) {
+        ciphertexts.push_back(rsaEncrypt(keys.first, randomBytes(32)));
+    }
+    ThreadPool pool(threads > 1 ? threads - 1 : 1);
+    if (threads <= 1) {
+        pool.shutdown();
+    }
+
+    for (auto _ : state) {
+        if (threads == 0) {
+            for (const auto &ciphertext : ciphertexts) {
+                benchmark::DoNotOptimize(rsaDecrypt(keys.second, ciphertext));
+            }
+        } else {
+            benchmark::DoNotOptimize(rsaDecryptBatch(keys.second, ciphertexts, pool));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(ciphertexts.size()));
+    state.counters["threads"] = static_cast<double>(threads);
+}
+BENCHMARK(BM_RsaDecryptBatch)
+    ->ArgsProduct({{0, 1, 2, 4, 8, 16}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+int main(int argc, char **argv)
+{
+    return Utils::runBenchmarks(argc, argv, "openssl_bench.json");
+}
@@ -1,25 +1,203 @@
 #include "openssl_common.hpp"
 
-#include <iomanip>
-#include <sstream>
+#include <array>
+#include <cstring>
+#include <stdexcept>
 
-std::string toHex(const std::string &str)
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define OPENSSL_COMMON_SSE2
+#endif
+
+namespace {
+
+constexpr char kHexDigits[] = "0123456789abcdef";
+
+// 每个字节对应的两个十六进制字符
+constexpr auto makeHexPairs() -> std::array<std::array<char, 2>, 256>
+{
+    std::array<std::array<char, 2>, 256> table{};
+    for (int i = 0; i < 256; ++i) {
+        table[i] = {kHexDigits[i >> 4], kHexDigits[i & 0xF]};
+    }
+    return table;
+}
+
+// 字符对应的半字节值，非法字符为 -1
+constexpr auto makeHexValues() -> std::array<int8_t, 256>
+{
+    std::array<int8_t, 256> table{};
+    for (int i = 0; i < 256; ++i) {
+        table[i] = -1;
+    }
+    for (int i = 0; i < 10; ++i) {
+        table['0' + i] = static_cast<int8_t>(i);
+    }
+    for (int i = 0; i < 6; ++i) {
+        table['a' + i] = static_cast<int8_t>(10 + i);
+        table['A' + i] = static_cast<int8_t>(10 + i);
+    }
+    return table;
+}
+
+constexpr auto kHexPairs = makeHexPairs();
+constexpr auto kHexValues = makeHexValues();
+
+void encodeScalar(const unsigned char *in, size_t n, char *out)
+{
+    for (size_t i = 0; i < n; ++i) {
+        memcpy(out + 2 * i, kHexPairs[in[i]].data(), 2);
+    }
+}
+
+// 返回成功解码的字节数；遇到非法字符时停在该字节对
+size_t decodeScalar(const char *in, size_t pairs, unsigned char *out)
+{
+    for (size_t i = 0; i < pairs; ++i) {
+        const int hi = kHexValues[static_cast<unsigned char>(in[2 * i])];
+        const int lo = kHexValues[static_cast<unsigned char>(in[2 * i + 1])];
+        if ((hi | lo) < 0) {
+            return i;
+        }
+        out[i] = static_cast<unsigned char>((hi << 4) | lo);
+    }
+    return pairs;
+}
+
+#ifdef OPENSSL_COMMON_SSE2
+// 半字节 0~15 转为 ASCII：加 '0'，大于 9 的再加 'a' - '0' - 10
+inline __m128i nibbleToAscii(__m128i nibble)
 {
-    std::stringstream ss;
-    ss << std::hex << std::setfill('0');
-    for (unsigned char c : str) {
-        ss << std::setw(2) << static_cast<int>(c);
+    const __m128i letter = _mm_cmpgt_epi8(nibble, _mm_set1_epi8(9));
+    const __m128i ascii = _mm_add_epi8(nibble, _mm_set1_epi8('0'));
+    return _mm_add_epi8(ascii, _mm_and_si128(letter, _mm_set1_epi8('a' - '0' - 10)));
+}
+
+// 每次 16 字节输入、32 字符输出，返回已处理的字节数
+size_t encodeSse2(const unsigned char *in, size_t n, char *out)
+{
+    const __m128i lowMask = _mm_set1_epi8(0x0F);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+        const __m128i hi = nibbleToAscii(_mm_and_si128(_mm_srli_epi16(bytes, 4), lowMask));
+        const __m128i lo = nibbleToAscii(_mm_and_si128(bytes, lowMask));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 2 * i), _mm_unpacklo_epi8(hi, lo));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 2 * i + 16), _mm_unpackhi_epi8(hi, lo));
     }
-    return ss.str();
+    return i;
+}
+
+// 16 个字符转为半字节，非法字符在 valid 中对应位为 0
+inline __m128i asciiToNibble(__m128i chars, int &valid)
+{
+    const __m128i digit = _mm_sub_epi8(chars, _mm_set1_epi8('0'));
+    const __m128i letter = _mm_sub_epi8(_mm_or_si128(chars, _mm_set1_epi8(0x20)),
+                                        _mm_set1_epi8('a'));
+    // 无符号比较 x <= limit 等价于 subs_epu8(x, limit) == 0
+    const __m128i isDigit = _mm_cmpeq_epi8(_mm_subs_epu8(digit, _mm_set1_epi8(9)),
+                                           _mm_setzero_si128());
+    const __m128i isLetter = _mm_cmpeq_epi8(_mm_subs_epu8(letter, _mm_set1_epi8(5)),
+                                            _mm_setzero_si128());
+    valid = _mm_movemask_epi8(_mm_or_si128(isDigit, isLetter));
+    return _mm_or_si128(_mm_and_si128(isDigit, digit),
+                        _mm_and_si128(isLetter, _mm_add_epi8(letter, _mm_set1_epi8(10))));
+}
+
+// 相邻两个半字节合并为一个字节：16 位小端通道中为 hi | lo << 8
+inline __m128i packNibbles(__m128i nibbles)
+{
+    const __m128i hi = _mm_slli_epi16(_mm_and_si128(nibbles, _mm_set1_epi16(0x00FF)), 4);
+    return _mm_or_si128(hi, _mm_srli_epi16(nibbles, 8));
+}
+
+// 每次 32 字符输入、16 字节输出，遇到非法字符时停下交给标量版本定位
+size_t decodeSse2(const char *in, size_t pairs, unsigned char *out)
+{
+    size_t i = 0;
+    for (; i + 16 <= pairs; i += 16) {
+        int valid0 = 0;
+        int valid1 = 0;
+        const __m128i n0 = asciiToNibble(
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + 2 * i)), valid0);
+        const __m128i n1 = asciiToNibble(
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + 2 * i + 16)), valid1);
+        if ((valid0 & valid1) != 0xFFFF) {
+            break;
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i),
+                         _mm_packus_epi16(packNibbles(n0), packNibbles(n1)));
+    }
+    return i;
+}
+#endif
+
+} // namespace
+
+char *toHex(const void *data, size_t n, char *out)
+{
+    const auto *in = static_cast<const unsigned char *>(data);
+    size_t done = 0;
+#ifdef OPENSSL_COMMON_SSE2
+    done = encodeSse2(in, n, out);
+#endif
+    encodeScalar(in + done, n - done, out + 2 * done);
+    return out + 2 * n;
+}
+
+bool fromHex(std::string_view hex, void *out, size_t *errorPos)
+{
+    const size_t pairs = hex.size() / 2;
+    auto *dest = static_cast<unsigned char *>(out);
+    size_t done = 0;
+#ifdef OPENSSL_COMMON_SSE2
+    done = decodeSse2(hex.data(), pairs, dest);
+#endif
+    done += decodeScalar(hex.data() + 2 * done, pairs - done, dest + done);
+
+    if (done < pairs) {
+        if (errorPos != nullptr) {
+            const bool highInvalid = kHexValues[static_cast<unsigned char>(hex[2 * done])] < 0;
+            *errorPos = 2 * done + (highInvalid ? 0 : 1);
+        }
+        return false;
+    }
+    if (hex.size() % 2 != 0) {
+        if (errorPos != nullptr) {
+            *errorPos = hex.size();
+        }
+        return false;
+    }
+    return true;
+}
+
+bool fromHex(std::string_view hex, std::string &out, size_t *errorPos)
+{
+    out.resize(hex.size() / 2);
+    if (!fromHex(hex, out.data(), errorPos)) {
+        out.clear();
+        return false;
+    }
+    return true;
+}
+
+std::string toHex(const std::string &str)
+{
+    std::string result(str.size() * 2, '\0');
+    toHex(str.data(), str.size(), result.data());
+    return result;
 }
 
 std::string fromHex(const std::string &str)
 {
     std::string result;
-    for (size_t i = 0; i < str.length(); i += 2) {
-        std::string byteString = str.substr(i, 2);
-        char byte = static_cast<char>(std::stoi(byteString, nullptr, 16));
-        result.push_back(byte);
+    size_t errorPos = 0;
+    if (!fromHex(str, result, &errorPos)) {
+        if (errorPos == str.size()) {
+            throw std::invalid_argument("fromHex: odd number of hex digits");
+        }
+        throw std::invalid_argument("fromHex: invalid hex digit at position "
+                                    + std::to_string(errorPos));
     }
     return result;
 }
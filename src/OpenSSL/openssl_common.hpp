@@ -8,10 +8,22 @@
 #include <openssl/rsa.h>
 
 #include <string>
+#include <string_view>
 #include <vector>
 
+// 十六进制编解码。toHex 输出小写；fromHex 同时接受大小写，
+// 非法字符或奇数长度时抛出 std::invalid_argument
 std::string toHex(const std::string &str);
 std::string fromHex(const std::string &str);
+
+// 将 n 字节编码为 2n 个字符写入 out（不追加 '\0'），返回写入结束位置
+char *toHex(const void *data, size_t n, char *out);
+
+// 将 hex 解码为 hex.size() / 2 个字节写入 out，不抛异常。
+// 失败返回 false，errorPos 为第一个非法字符的位置，长度为奇数时为 hex.size()
+bool fromHex(std::string_view hex, void *out, size_t *errorPos = nullptr);
+bool fromHex(std::string_view hex, std::string &out, size_t *errorPos = nullptr);
+
 void handleOpenSSLError();
 
 struct AesKey
@@ -0,0 +1,86 @@
+#include "openssl_context.hpp"
+
+#include <mutex>
+#include <unordered_map>
+
+namespace {
+
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+// 旧式对象指针 -> 显式 fetch 得到的对象。fetch 出的对象在进程退出时统一释放
+template<typename T, T *(*Fetch)(OSSL_LIB_CTX *, const char *, const char *), void (*Free)(T *)>
+class FetchCache
+{
+public:
+    ~FetchCache()
+    {
+        for (auto &[legacy, fetched] : m_fetched) {
+            Free(fetched);
+        }
+    }
+
+    const T *get(const T *legacy, const char *name)
+    {
+        // 热路径只查线程内的副本，不加锁
+        thread_local std::unordered_map<const T *, const T *> local;
+        if (auto it = local.find(legacy); it != local.end()) {
+            return it->second;
+        }
+
+        const T *result = legacy;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_fetched.find(legacy);
+            if (it == m_fetched.end()) {
+                T *fetched = name != nullptr ? Fetch(nullptr, name, nullptr) : nullptr;
+                if (fetched == nullptr) {
+                    // 没有对应 provider 实现的算法交给 Init 时的隐式 fetch 处理
+                    ERR_clear_error();
+                    return legacy;
+                }
+                it = m_fetched.emplace(legacy, fetched).first;
+            }
+            result = it->second;
+        }
+        local.emplace(legacy, result);
+        return result;
+    }
+
+private:
+    std::mutex m_mutex;
+    std::unordered_map<const T *, T *> m_fetched;
+};
+
+auto digestCache() -> FetchCache<EVP_MD, EVP_MD_fetch, EVP_MD_free> &
+{
+    static FetchCache<EVP_MD, EVP_MD_fetch, EVP_MD_free> cache;
+    return cache;
+}
+
+auto cipherCache() -> FetchCache<EVP_CIPHER, EVP_CIPHER_fetch, EVP_CIPHER_free> &
+{
+    static FetchCache<EVP_CIPHER, EVP_CIPHER_fetch, EVP_CIPHER_free> cache;
+    return cache;
+}
+#endif
+
+} // namespace
+
+const EVP_MD *fetchDigest(const EVP_MD *md)
+{
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+    if (md != nullptr && EVP_MD_get0_provider(md) == nullptr) {
+        return digestCache().get(md, EVP_MD_get0_name(md));
+    }
+#endif
+    return md;
+}
+
+const EVP_CIPHER *fetchCipher(const EVP_CIPHER *cipher)
+{
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+    if (cipher != nullptr && EVP_CIPHER_get0_provider(cipher) == nullptr) {
+        return cipherCache().get(cipher, EVP_CIPHER_get0_name(cipher));
+    }
+#endif
+    return cipher;
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "openssl_common.hpp"
+
+#include <utils/object.hpp>
+
+#include <vector>
+
+// OpenSSL 3 中 EVP_sha256() 等返回的是旧式静态对象，每次 Init 都要按名字到 provider
+// 里隐式 fetch 一次（加锁 + 查表）。这里进程内只显式 fetch 一次并缓存，之后直接复用。
+// OpenSSL 1.1 没有 fetch，原样返回
+const EVP_MD *fetchDigest(const EVP_MD *md);
+const EVP_CIPHER *fetchCipher(const EVP_CIPHER *cipher);
+
+// 线程内的上下文缓存：acquire 优先复用本线程归还的上下文，release 时 reset 后放回，
+// 避免每条消息都 new/free 一次。嵌套使用时各自拿到不同的上下文
+template<typename Ctx, typename Traits>
+class ContextCache : noncopyable
+{
+public:
+    // 借出的上下文，析构时归还到当前线程的缓存
+    class Lease : noncopyable
+    {
+    public:
+        Lease()
+            : m_ctx(acquire())
+        {}
+        ~Lease() { release(m_ctx); }
+
+        Ctx *get() const { return m_ctx; }
+        operator Ctx *() const { return m_ctx; }
+
+    private:
+        Ctx *m_ctx;
+    };
+
+    static Ctx *acquire()
+    {
+        auto &cache = threadCache();
+        if (!cache.free.empty()) {
+            Ctx *ctx = cache.free.back();
+            cache.free.pop_back();
+            return ctx;
+        }
+        Ctx *ctx = Traits::create();
+        if (!ctx) {
+            handleOpenSSLError();
+        }
+        return ctx;
+    }
+
+    static void release(Ctx *ctx)
+    {
+        if (!ctx) {
+            return;
+        }
+        auto &cache = threadCache();
+        // reset 会清除密钥等敏感状态，但保留已分配的内存
+        if (cache.free.size() >= kMaxCachedPerThread || Traits::reset(ctx) != 1) {
+            Traits::destroy(ctx);
+            return;
+        }
+        cache.free.push_back(ctx);
+    }
+
+    // 当前线程缓存的空闲上下文数量
+    static size_t cachedCount() { return threadCache().free.size(); }
+
+private:
+    static constexpr size_t kMaxCachedPerThread = 4;
+
+    struct ThreadCache
+    {
+        ~ThreadCache()
+        {
+            for (Ctx *ctx : free) {
+                Traits::destroy(ctx);
+            }
+        }
+
+        std::vector<Ctx *> free;
+    };
+
+    static ThreadCache &threadCache()
+    {
+        thread_local ThreadCache cache;
+        return cache;
+    }
+};
+
+struct MdContextTraits
+{
+    static EVP_MD_CTX *create() { return EVP_MD_CTX_new(); }
+    static int reset(EVP_MD_CTX *ctx) { return EVP_MD_CTX_reset(ctx); }
+    static void destroy(EVP_MD_CTX *ctx) { EVP_MD_CTX_free(ctx); }
+};
+
+struct CipherContextTraits
+{
+    static EVP_CIPHER_CTX *create() { return EVP_CIPHER_CTX_new(); }
+    static int reset(EVP_CIPHER_CTX *ctx) { return EVP_CIPHER_CTX_reset(ctx); }
+    static void destroy(EVP_CIPHER_CTX *ctx) { EVP_CIPHER_CTX_free(ctx); }
+};
+
+using MdContextCache = ContextCache<EVP_MD_CTX, MdContextTraits>;
+using CipherContextCache = ContextCache<EVP_CIPHER_CTX, CipherContextTraits>;
@@ -1,36 +1,24 @@
-#include "openssl_common.hpp"
+#include "openssl_hasher.hpp"
+#include "openssl_treehash.hpp"
+
+#include <Thread/threadpool.hpp>
 
 #include <gtest/gtest.h>
 
+#include <atomic>
 #include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
 #include <stdexcept>
+#include <thread>
 
 std::string hash(const std::string &plain, const EVP_MD *type)
 {
-    EVP_MD_CTX *ctx = EVP_MD_CTX_new();
-    if (!ctx)
-        handleOpenSSLError();
-
-    if (EVP_DigestInit_ex(ctx, type, nullptr) != 1) {
-        EVP_MD_CTX_free(ctx);
-        handleOpenSSLError();
-    }
-
-    if (EVP_DigestUpdate(ctx, plain.data(), plain.size()) != 1) {
-        EVP_MD_CTX_free(ctx);
-        handleOpenSSLError();
-    }
-
-    unsigned char digest[EVP_MAX_MD_SIZE];
-    unsigned int digestLen;
-    if (EVP_DigestFinal_ex(ctx, digest, &digestLen) != 1) {
-        EVP_MD_CTX_free(ctx);
-        handleOpenSSLError();
-    }
-
-    EVP_MD_CTX_free(ctx);
-
-    return std::string(reinterpret_cast<char *>(digest), digestLen);
+    Hasher hasher(type);
+    hasher.update(plain);
+    return hasher.final();
 }
 
 class HashTest : public ::testing::Test
@@ -295,6 +283,68 @@ TEST_F(HashTest, HashWithHexConversion)
     EXPECT_EQ(hashResult.length(), fromHexResult.length());
 }
 
+// 测试十六进制编解码：覆盖所有字节值、SIMD 分块边界与大小写输入
+TEST_F(HashTest, HexRoundTrip)
+{
+    EXPECT_EQ(toHex(""), "");
+    EXPECT_EQ(fromHex(""), "");
+    EXPECT_EQ(toHex(std::string("\x00\x01\x7f\x80\xab\xff", 6)), "00017f80abff");
+    EXPECT_EQ(fromHex("00017F80aBfF"), std::string("\x00\x01\x7f\x80\xab\xff", 6));
+
+    std::string bytes;
+    for (int i = 0; i < 256 * 3 + 17; ++i) {
+        bytes.push_back(static_cast<char>(i * 31 + 5));
+    }
+    for (size_t n = 0; n <= bytes.size(); n += (n < 80 ? 1 : 37)) {
+        const std::string data = bytes.substr(0, n);
+        const std::string hex = toHex(data);
+        ASSERT_EQ(hex.size(), 2 * n);
+        for (size_t i = 0; i < n; ++i) {
+            const auto byte = static_cast<unsigned char>(data[i]);
+            ASSERT_EQ(hex[2 * i], "0123456789abcdef"[byte >> 4]);
+            ASSERT_EQ(hex[2 * i + 1], "0123456789abcdef"[byte & 0xF]);
+        }
+        ASSERT_EQ(fromHex(hex), data) << "n=" << n;
+
+        std::string upper = hex;
+        for (auto &c : upper) {
+            c = static_cast<char>(toupper(static_cast<unsigned char>(c)));
+        }
+        ASSERT_EQ(fromHex(upper), data) << "n=" << n;
+    }
+}
+
+// 测试十六进制解码的错误报告：非法字符位置与奇数长度
+TEST_F(HashTest, HexDecodeErrors)
+{
+    const std::string valid = toHex(std::string(40, '\x5a'));
+    const char invalidChars[] = {'g', 'G', ' ', '/', ':', '@', '`', '\x80', '\xff', '\0'};
+
+    std::string out;
+    size_t errorPos = 0;
+    for (size_t pos : {0, 1, 15, 16, 31, 32, 33, 79}) {
+        for (char c : invalidChars) {
+            std::string hex = valid;
+            hex[pos] = c;
+            errorPos = 0;
+            EXPECT_FALSE(fromHex(hex, out, &errorPos)) << "pos=" << pos << " char=" << int(c);
+            EXPECT_EQ(errorPos, pos);
+            EXPECT_TRUE(out.empty());
+            EXPECT_THROW(fromHex(hex), std::invalid_argument);
+        }
+    }
+
+    EXPECT_FALSE(fromHex("abc", out, &errorPos));
+    EXPECT_EQ(errorPos, 3u);
+    EXPECT_THROW(fromHex("abc"), std::invalid_argument);
+
+    unsigned char buffer[3];
+    EXPECT_TRUE(fromHex("0aFf10", buffer));
+    EXPECT_EQ(buffer[0], 0x0A);
+    EXPECT_EQ(buffer[1], 0xFF);
+    EXPECT_EQ(buffer[2], 0x10);
+}
+
 // 测试多次哈希的一致性
 TEST_F(HashTest, MultipleHashingConsistency)
 {
@@ -377,6 +427,234 @@ TEST_F(HashTest, LargeDataHash)
     EXPECT_EQ(hashResult, hashResult2);
 }
 
+// 测试增量哈希：任意切分后逐段 update 的结果与一次性计算一致，final 后可以复用
+TEST_F(HashTest, HasherIncremental)
+{
+    std::string data;
+    for (int i = 0; i < 10000; ++i) {
+        data.push_back(static_cast<char>(i * 131));
+    }
+
+    for (const EVP_MD *md : {EVP_md5(), EVP_sha256(), EVP_sha512()}) {
+        const std::string expected = hash(data, md);
+        Hasher hasher(md);
+        EXPECT_EQ(hasher.digestSize(), expected.size());
+
+        for (size_t step : {1, 7, 64, 1000, 9999}) {
+            for (size_t pos = 0; pos < data.size(); pos += step) {
+                const auto *begin = reinterpret_cast<const std::byte *>(data.data()) + pos;
+                hasher.update(std::span(begin, std::min(step, data.size() - pos)));
+            }
+            EXPECT_EQ(hasher.final(), expected) << "step=" << step;
+        }
+
+        // final 之后自动重置
+        hasher.update("abc");
+        hasher.update("");
+        EXPECT_EQ(toHex(hasher.final()), toHex(hash("abc", md)));
+    }
+
+    // reset 丢弃已输入的数据
+    Hasher hasher(EVP_sha256());
+    hasher.update("garbage");
+    hasher.reset();
+    EXPECT_EQ(toHex(hasher.final()),
+              "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+
+    // Hasher 可以移动
+    Hasher moved(std::move(hasher));
+    moved.update("abc");
+    EXPECT_EQ(toHex(moved.final()),
+              "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+}
+
+// 测试文件与流的流式哈希：覆盖空文件、不足一块、恰好整块与多块的情况
+TEST_F(HashTest, HashFileAndStream)
+{
+    const auto path = (std::filesystem::temp_directory_path() / "openssl_hash_test.bin").string();
+    const size_t pageSize = 4096;
+
+    for (size_t size : {size_t(0), size_t(1), pageSize, 5 * pageSize + 123, size_t(3 << 20)}) {
+        std::string data(size, '\0');
+        for (size_t i = 0; i < size; ++i) {
+            data[i] = static_cast<char>((i * 2654435761u) >> 13);
+        }
+        {
+            std::ofstream out(path, std::ios::binary | std::ios::trunc);
+            out.write(data.data(), static_cast<std::streamsize>(data.size()));
+        }
+
+        const std::string expected = hash(data, EVP_sha256());
+        EXPECT_EQ(hashFile(path, EVP_sha256()), expected) << "size=" << size;
+        // 小块大小强制走多次映射
+        EXPECT_EQ(hashFile(path, EVP_sha256(), pageSize), expected) << "size=" << size;
+        EXPECT_EQ(hashFile(path, EVP_sha256(), 1), expected) << "size=" << size;
+
+        std::istringstream in(data);
+        EXPECT_EQ(hashStream(in, EVP_sha256(), 1000), expected) << "size=" << size;
+    }
+    std::remove(path.c_str());
+
+    EXPECT_THROW(hashFile(path + ".missing", EVP_sha256()), std::runtime_error);
+}
+
+// 测试预先 fetch 的算法：结果与旧式对象一致，且多线程并发使用时各自复用上下文
+TEST_F(HashTest, FetchedDigestAndThreads)
+{
+    const EVP_MD *fetched = fetchDigest(EVP_sha256());
+    ASSERT_NE(fetched, nullptr);
+    EXPECT_EQ(fetchDigest(EVP_sha256()), fetched);
+    EXPECT_EQ(fetchDigest(fetched), fetched);
+    EXPECT_EQ(EVP_MD_get_size(fetched), 32);
+    EXPECT_EQ(hash(plainText, fetched), hash(plainText, EVP_sha256()));
+
+    const std::string expected = toHex(hash(plainText, EVP_sha512()));
+    std::atomic<int> mismatches{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < 200; ++i) {
+                if (toHex(hash(plainText, EVP_sha512())) != expected) {
+                    ++mismatches;
+                }
+            }
+            // 每个线程串行使用时只缓存一个上下文
+            if (MdContextCache::cachedCount() != 1) {
+                ++mismatches;
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(mismatches, 0);
+}
+
+// 测试批量哈希：并行与串行路径的结果都与逐条计算一致，摘要按输入顺序连续存放
+TEST_F(HashTest, HashBatch)
+{
+    std::vector<std::string> messages;
+    for (size_t i = 0; i < 2000; ++i) {
+        std::string message((i * 7919) % 5000, '\0');
+        for (size_t j = 0; j < message.size(); ++j) {
+            message[j] = static_cast<char>(i + j * 31);
+        }
+        messages.push_back(std::move(message));
+    }
+    std::vector<std::span<const std::byte>> inputs;
+    for (const auto &message : messages) {
+        inputs.push_back(std::as_bytes(std::span(message)));
+    }
+
+    ThreadPool pool(4);
+    for (const EVP_MD *md : {EVP_sha256(), EVP_sha1()}) {
+        const auto digestSize = static_cast<size_t>(EVP_MD_get_size(md));
+        for (size_t count : {size_t(0), size_t(1), size_t(10), messages.size()}) {
+            const auto batch = std::span(inputs).first(count);
+            std::vector<unsigned char> digests = hashBatch(batch, md, pool);
+            ASSERT_EQ(digests.size(), count * digestSize);
+            for (size_t i = 0; i < count; ++i) {
+                const std::string digest(reinterpret_cast<char *>(digests.data()) + i * digestSize,
+                                         digestSize);
+                ASSERT_EQ(digest, hash(messages[i], md)) << "count=" << count << " i=" << i;
+            }
+        }
+    }
+
+    // pool 停止后退回串行
+    std::vector<unsigned char> expected = hashBatch(inputs, EVP_sha256(), pool);
+    pool.shutdown();
+    EXPECT_EQ(hashBatch(inputs, EVP_sha256(), pool), expected);
+
+    std::vector<unsigned char> small(31);
+    EXPECT_THROW(hashBatch(std::span(inputs).first(1), EVP_sha256(), pool, small),
+                 std::invalid_argument);
+    EXPECT_THROW(hashBatch(inputs, nullptr, pool), std::exception);
+}
+
+// 测试树形哈希：与按文档格式逐层计算的参考实现及固定测试向量一致
+TEST_F(HashTest, TreeHash)
+{
+    auto reference = [](const std::string &data, const EVP_MD *md, size_t leafSize) {
+        std::vector<std::string> nodes;
+        for (size_t pos = 0; pos < data.size() || nodes.empty(); pos += leafSize) {
+            nodes.push_back(hash(std::string(1, '\x00') + data.substr(pos, leafSize), md));
+        }
+        while (nodes.size() > 1) {
+            std::vector<std::string> parents;
+            for (size_t i = 0; i + 1 < nodes.size(); i += 2) {
+                parents.push_back(hash(std::string(1, '\x01') + nodes[i] + nodes[i + 1], md));
+            }
+            if (nodes.size() % 2 != 0) {
+                parents.push_back(nodes.back());
+            }
+            nodes.swap(parents);
+        }
+        std::string root(1, '\x02');
+        for (uint64_t value : {uint64_t(leafSize), uint64_t(data.size())}) {
+            for (int i = 0; i < 8; ++i) {
+                root.push_back(static_cast<char>(value >> (8 * i)));
+            }
+        }
+        return hash(root + nodes[0], md);
+    };
+    auto bytes = [](const std::string &data) { return std::as_bytes(std::span(data)); };
+
+    std::string data(1000, '\0');
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<char>(i * 31 + 7);
+    }
+
+    ThreadPool pool(4);
+    // 固定测试向量，格式变化时这里会失败
+    EXPECT_EQ(toHex(treeHash(bytes(data), EVP_sha256(), pool, 64)),
+              "814c5993d8865900291f4f4e75dcce0a01917a174ee01acffbe82575a6b31182");
+    EXPECT_EQ(toHex(treeHash({}, EVP_sha256(), pool)),
+              "11079e8717678defe8055fa8b26c1bdcda1169ca4b8321cb5f9d51fca794ffba");
+    EXPECT_EQ(toHex(treeHash(bytes("abc"), EVP_sha256(), pool)),
+              "e2a37d2fdf357117e6285285175c414db329a525410aeb6a1bdd678ba7df79ec");
+    EXPECT_EQ(toHex(treeHashBlake2(bytes(data), pool, 64)),
+              "952e88bb4b02119f4c09c5143a4941f87d5d53d2a615500a7858f4ac7b8e71d4"
+              "b07c3273eebc75ae470259445a14c05bbbf767cfc01c7806f56cef79320b8a5b");
+
+    // 覆盖单叶子、恰好整叶、奇数个节点，以及层内节点足够多时的并行合并
+    std::string large(64 << 10, '\0');
+    for (size_t i = 0; i < large.size(); ++i) {
+        large[i] = static_cast<char>((i * 2654435761u) >> 11);
+    }
+    for (size_t leafSize : {size_t(1), size_t(7), size_t(16), size_t(1000), size_t(1) << 20}) {
+        const std::string input = leafSize == 1 ? large.substr(0, 333) : large;
+        EXPECT_EQ(treeHash(bytes(input), EVP_sha256(), pool, leafSize),
+                  reference(input, EVP_sha256(), leafSize))
+            << "leafSize=" << leafSize;
+    }
+
+    // 不同叶子大小得到不同结果，且与普通哈希不同
+    EXPECT_NE(treeHash(bytes(data), EVP_sha256(), pool, 64),
+              treeHash(bytes(data), EVP_sha256(), pool, 128));
+    EXPECT_NE(treeHash(bytes(data), EVP_sha256(), pool), hash(data, EVP_sha256()));
+    EXPECT_THROW(treeHash(bytes(data), EVP_sha256(), pool, 0), std::invalid_argument);
+
+    // 文件版本与内存版本一致
+    const auto path = (std::filesystem::temp_directory_path() / "openssl_treehash_test.bin").string();
+    for (const std::string *input : {&data, &large}) {
+        {
+            std::ofstream out(path, std::ios::binary | std::ios::trunc);
+            out.write(input->data(), static_cast<std::streamsize>(input->size()));
+        }
+        EXPECT_EQ(treeHashFile(path, EVP_sha256(), pool, 100),
+                  treeHash(bytes(*input), EVP_sha256(), pool, 100));
+    }
+    std::ofstream(path, std::ios::binary | std::ios::trunc).close();
+    EXPECT_EQ(treeHashFile(path, EVP_sha256(), pool), treeHash({}, EVP_sha256(), pool));
+    std::remove(path.c_str());
+
+    // pool 停止后串行计算，结果不变
+    const std::string expected = treeHash(bytes(large), EVP_sha256(), pool, 16);
+    pool.shutdown();
+    EXPECT_EQ(treeHash(bytes(large), EVP_sha256(), pool, 16), expected);
+}
+
 // 测试null算法处理（应该抛出异常或返回错误）
 TEST_F(HashTest, NullAlgorithm)
 {
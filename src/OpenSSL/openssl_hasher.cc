@@ -0,0 +1,160 @@
+#include "openssl_hasher.hpp"
+#include "openssl_parallel.hpp"
+#include "openssl_utils.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#endif
+
+Hasher::Hasher(const EVP_MD *md)
+    : m_md(fetchDigest(md))
+    , m_ctx(MdContextCache::acquire())
+{
+    reset();
+}
+
+void Hasher::update(std::span<const std::byte> data)
+{
+    update(data.data(), data.size());
+}
+
+void Hasher::update(const void *data, size_t size)
+{
+    if (size > 0 && EVP_DigestUpdate(m_ctx.get(), data, size) != 1) {
+        handleOpenSSLError();
+    }
+}
+
+std::string Hasher::final()
+{
+    std::string digest(EVP_MAX_MD_SIZE, '\0');
+    digest.resize(final(reinterpret_cast<unsigned char *>(digest.data())));
+    return digest;
+}
+
+size_t Hasher::final(unsigned char *out)
+{
+    unsigned int length = 0;
+    if (EVP_DigestFinal_ex(m_ctx.get(), out, &length) != 1) {
+        handleOpenSSLError();
+    }
+    reset();
+    return length;
+}
+
+void Hasher::reset()
+{
+    // 复用已分配的 ctx，只重新初始化摘要状态
+    if (EVP_DigestInit_ex(m_ctx.get(), m_md, nullptr) != 1) {
+        handleOpenSSLError();
+    }
+}
+
+size_t Hasher::digestSize() const
+{
+    return static_cast<size_t>(EVP_MD_get_size(m_md));
+}
+
+std::string hashFile(const std::string &path, const EVP_MD *md, size_t chunkSize)
+{
+    Hasher hasher(md);
+    const auto update = [&hasher](auto chunk) { hasher.update(chunk.data(), chunk.size()); };
+
+#ifndef _WIN32
+    OpenSSLUtils::FileDescriptor file{::open(path.c_str(), O_RDONLY | O_CLOEXEC)};
+    if (file.fd < 0) {
+        OpenSSLUtils::throwFileError("Failed to open", path);
+    }
+    OpenSSLUtils::readFile(file.fd, path, chunkSize, update);
+#else
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        OpenSSLUtils::throwFileError("Failed to open", path);
+    }
+    OpenSSLUtils::readStream(in, std::min<size_t>(chunkSize, 1 << 20), update);
+#endif
+    return hasher.final();
+}
+
+std::string hashStream(std::istream &in, const EVP_MD *md, size_t chunkSize)
+{
+    Hasher hasher(md);
+    OpenSSLUtils::readStream(in, chunkSize, [&hasher](std::span<const char> chunk) {
+        hasher.update(chunk.data(), chunk.size());
+    });
+    return hasher.final();
+}
+
+namespace {
+
+// 总数据量低于该值时串行计算，调度开销会抵消并行收益
+constexpr size_t kBatchParallelMinBytes = 256 << 10;
+
+// 每次领取的消息数量按平均长度折算成约 64 KiB，减少原子操作与缓存行争用
+constexpr size_t kBatchGrainBytes = 64 << 10;
+constexpr size_t kBatchMaxGrain = 1024;
+
+} // namespace
+
+void hashBatch(std::span<const std::span<const std::byte>> inputs,
+               const EVP_MD *md,
+               ThreadPool &pool,
+               std::span<unsigned char> out)
+{
+    // 先在调用线程初始化一次，算法无效时直接抛出，不分派任务
+    Hasher hasher(md);
+    const size_t digestSize = hasher.digestSize();
+    if (out.size() < inputs.size() * digestSize) {
+        throw std::invalid_argument("hashBatch: output buffer too small");
+    }
+
+    size_t totalBytes = 0;
+    for (const auto &input : inputs) {
+        totalBytes += input.size();
+    }
+
+    const size_t participants = pool.size() + 1;
+    if (totalBytes < kBatchParallelMinBytes || inputs.size() < 2 || !pool.isRunning()) {
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            hasher.update(inputs[i]);
+            hasher.final(out.data() + i * digestSize);
+        }
+        return;
+    }
+
+    // 每个参与者至少分到几组，便于长短不一的消息之间负载均衡
+    const size_t averageSize = std::max<size_t>(totalBytes / inputs.size(), 1);
+    const size_t grain
+        = std::clamp<size_t>(kBatchGrainBytes / averageSize,
+                             1,
+                             std::min(kBatchMaxGrain,
+                                      std::max<size_t>(inputs.size() / (participants * 4), 1)));
+    const size_t groupCount = (inputs.size() + grain - 1) / grain;
+
+    parallelFor(
+        pool,
+        groupCount,
+        [md] { return Hasher(md); },
+        [&](Hasher &worker, size_t group) {
+            const size_t end = std::min((group + 1) * grain, inputs.size());
+            for (size_t i = group * grain; i < end; ++i) {
+                worker.update(inputs[i]);
+                worker.final(out.data() + i * digestSize);
+            }
+        });
+}
+
+std::vector<unsigned char> hashBatch(std::span<const std::span<const std::byte>> inputs,
+                                     const EVP_MD *md,
+                                     ThreadPool &pool)
+{
+    const size_t digestSize = Hasher(md).digestSize();
+    std::vector<unsigned char> digests(inputs.size() * digestSize);
+    hashBatch(inputs, md, pool, digests);
+    return digests;
+}
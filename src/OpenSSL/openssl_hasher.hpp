@@ -0,0 +1,75 @@
+#pragma once
+
+#include "openssl_context.hpp"
+
+#include <utils/object.hpp>
+
+class ThreadPool;
+
+#include <cstddef>
+#include <istream>
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// 增量哈希：构造时从线程缓存取一个 EVP_MD_CTX 并用预先 fetch 的算法初始化，可多次 update，
+// final 返回摘要后自动重置，同一个对象可以连续计算多条消息。
+// 出错时通过 handleOpenSSLError 抛出 std::runtime_error
+class Hasher
+{
+public:
+    explicit Hasher(const EVP_MD *md);
+
+    DISABLE_COPY(Hasher)
+    DEFAULT_MOVE(Hasher)
+    ~Hasher() = default;
+
+    void update(std::span<const std::byte> data);
+    void update(const void *data, size_t size);
+    void update(std::string_view data) { update(data.data(), data.size()); }
+
+    // 返回二进制摘要，并重置为初始状态
+    std::string final();
+    // 写入 out（至少 digestSize() 字节），返回摘要长度
+    size_t final(unsigned char *out);
+
+    void reset();
+
+    [[nodiscard]] size_t digestSize() const;
+    [[nodiscard]] const EVP_MD *md() const { return m_md; }
+
+private:
+    struct CtxDeleter
+    {
+        void operator()(EVP_MD_CTX *ctx) const { MdContextCache::release(ctx); }
+    };
+
+    const EVP_MD *m_md;
+    std::unique_ptr<EVP_MD_CTX, CtxDeleter> m_ctx;
+};
+
+// 每次映射/读取的块大小，内存占用与文件大小无关
+constexpr size_t kHashFileChunk = 64 << 20;
+
+// 流式计算文件摘要：普通文件按块 mmap 并提示顺序访问，
+// 管道等不能映射的文件退回对齐缓冲区 read。打不开或读取失败时抛出 std::runtime_error
+std::string hashFile(const std::string &path, const EVP_MD *md, size_t chunkSize = kHashFileChunk);
+
+// 从输入流读取到 EOF 并计算摘要
+std::string hashStream(std::istream &in, const EVP_MD *md, size_t chunkSize = 1 << 20);
+
+// 批量计算大量独立消息的摘要：消息按块分给 pool 的工作线程与调用线程，
+// 每个参与者整批只使用一个 Hasher。第 i 条消息的摘要写入
+// out[i * digestSize, (i + 1) * digestSize)，out 至少 inputs.size() * digestSize 字节。
+// 总数据量较小或 pool 已停止时在调用线程串行计算
+void hashBatch(std::span<const std::span<const std::byte>> inputs,
+               const EVP_MD *md,
+               ThreadPool &pool,
+               std::span<unsigned char> out);
+
+// 返回连续存放的摘要数组
+std::vector<unsigned char> hashBatch(std::span<const std::span<const std::byte>> inputs,
+                                     const EVP_MD *md,
+                                     ThreadPool &pool);
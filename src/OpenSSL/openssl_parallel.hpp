@@ -0,0 +1,80 @@
+#pragma once
+
+#include <Thread/threadpool.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+
+// 在 pool 的工作线程与调用线程上并行执行 work(state, index)，index 取遍 [0, count)。
+// 每个参与者第一次领到任务时调用 makeState() 创建自己的状态（例如一个 Hasher），之后整批复用。
+// 队列已满时不等待，剩余任务由调用线程完成；任务抛出的第一个异常在调用线程重新抛出。
+// 调用方负责在任务太少时直接串行执行
+template<typename MakeState, typename Work>
+void parallelFor(ThreadPool &pool, size_t count, MakeState makeState, Work work)
+{
+    // 所有参与者共享的状态，用 shared_ptr 持有，调用线程返回后仍在队列中的任务只会发现没有剩余工作
+    struct Job
+    {
+        Job(MakeState makeState, Work work, size_t count)
+            : makeState(std::move(makeState))
+            , work(std::move(work))
+            , count(count)
+        {}
+
+        MakeState makeState;
+        Work work;
+        size_t count;
+        std::atomic<size_t> next{0};
+        std::atomic<size_t> done{0};
+        std::mutex errorMutex;
+        std::exception_ptr error;
+
+        void run()
+        {
+            std::optional<decltype(makeState())> state;
+            size_t index;
+            while ((index = next.fetch_add(1, std::memory_order_relaxed)) < count) {
+                try {
+                    if (!state) {
+                        state.emplace(makeState());
+                    }
+                    work(*state, index);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(errorMutex);
+                    if (!error) {
+                        error = std::current_exception();
+                    }
+                }
+                if (done.fetch_add(1, std::memory_order_acq_rel) + 1 == count) {
+                    done.notify_all();
+                }
+            }
+        }
+    };
+
+    if (count == 0) {
+        return;
+    }
+
+    auto job = std::make_shared<Job>(std::move(makeState), std::move(work), count);
+    const size_t helpers = pool.isRunning() ? std::min(pool.size(), count - 1) : 0;
+    for (size_t i = 0; i < helpers; ++i) {
+        if (!pool.trySubmit([job](std::stop_token) { job->run(); })) {
+            break;
+        }
+    }
+    job->run();
+
+    // 等待已被工作线程领取的任务完成
+    size_t done;
+    while ((done = job->done.load(std::memory_order_acquire)) != count) {
+        job->done.wait(done, std::memory_order_acquire);
+    }
+    if (job->error) {
+        std::rethrow_exception(job->error);
+    }
+}
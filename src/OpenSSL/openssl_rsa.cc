@@ -1,4 +1,6 @@
-#include "openssl_common.hpp"
+#include "openssl_rsakey.hpp"
+
+#include <Thread/threadpool.hpp>
 
 #include <gtest/gtest.h>
 
@@ -60,135 +62,15 @@ RsaKeyPair generateRsaKey()
     return RsaKeyPair{publicKey, privateKey};
 }
 
+// 只有 PEM 字符串时经过 LRU 缓存取得已解析的密钥，同一个密钥只解析一次
 std::string rsaEncrypt(const std::string &publicKeyPem, const std::string &plaintext)
 {
-    // 检查输入长度
-    // 对于2048位RSA使用OAEP填充，最大加密长度是 2048/8 - 42 = 214字节
-    const size_t maxRsaPlaintextLength = 214;
-    if (plaintext.length() > maxRsaPlaintextLength) {
-        throw std::invalid_argument(
-            "Plaintext too long for RSA encryption: " + std::to_string(plaintext.length())
-            + " bytes (max: " + std::to_string(maxRsaPlaintextLength) + " bytes)");
-    }
-
-    BIO *bio = BIO_new_mem_buf(publicKeyPem.data(), publicKeyPem.size());
-    if (!bio)
-        handleOpenSSLError();
-
-    EVP_PKEY *pkey = PEM_read_bio_PUBKEY(bio, nullptr, nullptr, nullptr);
-    BIO_free(bio);
-
-    if (!pkey)
-        handleOpenSSLError();
-
-    EVP_PKEY_CTX *ctx = EVP_PKEY_CTX_new(pkey, nullptr);
-    if (!ctx) {
-        EVP_PKEY_free(pkey);
-        handleOpenSSLError();
-    }
-
-    std::string encrypted;
-    try {
-        if (EVP_PKEY_encrypt_init(ctx) <= 0) {
-            throw std::runtime_error("EVP_PKEY_encrypt_init failed");
-        }
-
-        if (EVP_PKEY_CTX_set_rsa_padding(ctx, RSA_PKCS1_OAEP_PADDING) <= 0) {
-            throw std::runtime_error("EVP_PKEY_CTX_set_rsa_padding failed");
-        }
-
-        size_t outlen;
-        if (EVP_PKEY_encrypt(ctx,
-                             nullptr,
-                             &outlen,
-                             reinterpret_cast<const unsigned char *>(plaintext.data()),
-                             plaintext.size())
-            <= 0) {
-            throw std::runtime_error("EVP_PKEY_encrypt (size) failed");
-        }
-
-        encrypted.resize(outlen);
-        if (EVP_PKEY_encrypt(ctx,
-                             reinterpret_cast<unsigned char *>(encrypted.data()),
-                             &outlen,
-                             reinterpret_cast<const unsigned char *>(plaintext.data()),
-                             plaintext.size())
-            <= 0) {
-            throw std::runtime_error("EVP_PKEY_encrypt failed");
-        }
-
-        encrypted.resize(outlen);
-
-        EVP_PKEY_CTX_free(ctx);
-        EVP_PKEY_free(pkey);
-    } catch (...) {
-        EVP_PKEY_CTX_free(ctx);
-        EVP_PKEY_free(pkey);
-        throw;
-    }
-
-    return encrypted;
+    return rsaEncrypt(cachedRsaPublicKey(publicKeyPem), plaintext);
 }
 
 std::string rsaDecrypt(const std::string &privateKeyPem, const std::string &ciphertext)
 {
-    BIO *bio = BIO_new_mem_buf(privateKeyPem.data(), privateKeyPem.size());
-    if (!bio)
-        handleOpenSSLError();
-
-    EVP_PKEY *pkey = PEM_read_bio_PrivateKey(bio, nullptr, nullptr, nullptr);
-    BIO_free(bio);
-
-    if (!pkey)
-        handleOpenSSLError();
-
-    EVP_PKEY_CTX *ctx = EVP_PKEY_CTX_new(pkey, nullptr);
-    if (!ctx) {
-        EVP_PKEY_free(pkey);
-        handleOpenSSLError();
-    }
-
-    std::string decrypted;
-    try {
-        if (EVP_PKEY_decrypt_init(ctx) <= 0) {
-            throw std::runtime_error("EVP_PKEY_decrypt_init failed");
-        }
-
-        if (EVP_PKEY_CTX_set_rsa_padding(ctx, RSA_PKCS1_OAEP_PADDING) <= 0) {
-            throw std::runtime_error("EVP_PKEY_CTX_set_rsa_padding failed");
-        }
-
-        size_t outlen;
-        if (EVP_PKEY_decrypt(ctx,
-                             nullptr,
-                             &outlen,
-                             reinterpret_cast<const unsigned char *>(ciphertext.data()),
-                             ciphertext.size())
-            <= 0) {
-            throw std::runtime_error("EVP_PKEY_decrypt (size) failed");
-        }
-
-        decrypted.resize(outlen);
-        if (EVP_PKEY_decrypt(ctx,
-                             reinterpret_cast<unsigned char *>(decrypted.data()),
-                             &outlen,
-                             reinterpret_cast<const unsigned char *>(ciphertext.data()),
-                             ciphertext.size())
-            <= 0) {
-            throw std::runtime_error("EVP_PKEY_decrypt failed");
-        }
-
-        decrypted.resize(outlen);
-
-        EVP_PKEY_CTX_free(ctx);
-        EVP_PKEY_free(pkey);
-    } catch (...) {
-        EVP_PKEY_CTX_free(ctx);
-        EVP_PKEY_free(pkey);
-        throw;
-    }
-
-    return decrypted;
+    return rsaDecrypt(cachedRsaPrivateKey(privateKeyPem), ciphertext);
 }
 
 class RsaTest : public ::testing::Test
@@ -490,28 +372,102 @@ TEST_F(RsaTest, KeyPairIsolation)
     }
 }
 
-// 性能测试：多次加密解密操作
+// 性能测试：每次解析 PEM、经过 LRU 缓存的字符串接口与直接使用已解析密钥三种方式对比
 TEST_F(RsaTest, PerformanceTest)
 {
     const int iterations = 50; // RSA操作较慢，减少迭代次数
-    auto start_time = std::chrono::high_resolution_clock::now();
+    using Clock = std::chrono::high_resolution_clock;
 
-    for (int i = 0; i < iterations; ++i) {
-        std::string testText = "Performance test " + std::to_string(i);
-        std::string encrypted = rsaEncrypt(rsaKeys.publicKey, testText);
-        std::string decrypted = rsaDecrypt(rsaKeys.privateKey, encrypted);
-        EXPECT_EQ(decrypted, testText);
-    }
+    auto measure = [&](const char *name, auto &&roundTrip) {
+        auto start_time = Clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            std::string testText = "Performance test " + std::to_string(i);
+            EXPECT_EQ(roundTrip(testText), testText);
+        }
+        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now()
+                                                                              - start_time);
+        std::cout << "RSA Performance (" << name << "): " << iterations << " iterations took "
+                  << duration.count() / 1000.0 << " ms" << std::endl;
+        return duration;
+    };
+
+    auto parsed = measure("parse PEM every call", [&](const std::string &text) {
+        return rsaDecrypt(RsaPrivateKey::fromPem(rsaKeys.privateKey),
+                          rsaEncrypt(RsaPublicKey::fromPem(rsaKeys.publicKey), text));
+    });
+    auto cached = measure("PEM strings via LRU cache", [&](const std::string &text) {
+        return rsaDecrypt(rsaKeys.privateKey, rsaEncrypt(rsaKeys.publicKey, text));
+    });
+    RsaPublicKey publicKey = RsaPublicKey::fromPem(rsaKeys.publicKey);
+    RsaPrivateKey privateKey = RsaPrivateKey::fromPem(rsaKeys.privateKey);
+    auto handle = measure("parsed key handles", [&](const std::string &text) {
+        return rsaDecrypt(privateKey, rsaEncrypt(publicKey, text));
+    });
 
-    auto end_time = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
+    // 可以根据需要设置性能阈值
+    EXPECT_LE(std::chrono::duration_cast<std::chrono::milliseconds>(parsed).count(), 10000);
+    EXPECT_LE(std::chrono::duration_cast<std::chrono::milliseconds>(cached).count(), 10000);
+    EXPECT_LE(std::chrono::duration_cast<std::chrono::milliseconds>(handle).count(), 10000);
+}
+
+// 测试已解析密钥句柄：复制后共享同一个 EVP_PKEY，可以与 PEM 字符串接口互通
+TEST_F(RsaTest, ParsedKeyHandles)
+{
+    RsaPublicKey publicKey = RsaPublicKey::fromPem(rsaKeys.publicKey);
+    RsaPrivateKey privateKey = RsaPrivateKey::fromPem(rsaKeys.privateKey);
+    EXPECT_EQ(publicKey.size(), 256u);
+    EXPECT_EQ(publicKey.maxPlaintextSize(), static_cast<size_t>(maxEncryptLength));
+    EXPECT_EQ(privateKey.size(), 256u);
+
+    RsaPublicKey copy = publicKey;
+    EXPECT_EQ(copy.get(), publicKey.get());
+
+    EXPECT_EQ(rsaDecrypt(privateKey, rsaEncrypt(copy, plainText)), plainText);
+    EXPECT_EQ(rsaDecrypt(rsaKeys.privateKey, rsaEncrypt(publicKey, plainText)), plainText);
+    EXPECT_EQ(rsaDecrypt(privateKey, rsaEncrypt(rsaKeys.publicKey, plainText)), plainText);
+
+    EXPECT_THROW(rsaEncrypt(publicKey, std::string(maxEncryptLength + 1, 'A')),
+                 std::invalid_argument);
+    EXPECT_THROW(RsaPublicKey::fromPem("not a key"), std::runtime_error);
+    EXPECT_THROW(RsaPrivateKey::fromPem(rsaKeys.publicKey), std::runtime_error);
+}
 
-    // 输出性能信息
-    std::cout << "RSA Performance: " << iterations << " iterations took " << duration.count()
-              << " ms" << std::endl;
+// 测试 PEM 密钥缓存：相同 PEM 命中同一个密钥，超出容量时淘汰最久未使用的
+TEST_F(RsaTest, KeyCacheLru)
+{
+    const size_t oldCapacity = rsaKeyCacheCapacity();
+    clearRsaKeyCache();
+    setRsaKeyCacheCapacity(2);
 
-    // 可以根据需要设置性能阈值
-    EXPECT_LE(duration.count(), 10000); // 10秒内完成50次操作
+    RsaKeyPair keys2 = generateRsaKey();
+    RsaKeyPair keys3 = generateRsaKey();
+
+    RsaPublicKey first = cachedRsaPublicKey(rsaKeys.publicKey);
+    EXPECT_EQ(cachedRsaPublicKey(rsaKeys.publicKey).get(), first.get());
+    EXPECT_EQ(rsaKeyCacheSize(), 1u);
+
+    // 依次放入 keys2、keys3 后，最久未使用的 rsaKeys 被淘汰
+    RsaPublicKey second = cachedRsaPublicKey(keys2.publicKey);
+    cachedRsaPublicKey(keys2.publicKey);
+    cachedRsaPublicKey(keys3.publicKey);
+    EXPECT_EQ(rsaKeyCacheSize(), 2u);
+    EXPECT_EQ(cachedRsaPublicKey(keys2.publicKey).get(), second.get());
+    EXPECT_NE(cachedRsaPublicKey(rsaKeys.publicKey).get(), first.get());
+
+    // 被淘汰的密钥仍被外部句柄持有，可以继续使用
+    EXPECT_EQ(rsaDecrypt(rsaKeys.privateKey, rsaEncrypt(first, plainText)), plainText);
+    EXPECT_EQ(rsaKeyCacheSize(), 3u); // 2 个公钥 + 1 个私钥
+
+    // 无效 PEM 不进入缓存
+    EXPECT_THROW(cachedRsaPrivateKey("not a key"), std::exception);
+    EXPECT_EQ(rsaKeyCacheSize(), 3u);
+
+    setRsaKeyCacheCapacity(0);
+    EXPECT_EQ(rsaKeyCacheSize(), 0u);
+    EXPECT_EQ(rsaDecrypt(rsaKeys.privateKey, rsaEncrypt(rsaKeys.publicKey, plainText)), plainText);
+    EXPECT_EQ(rsaKeyCacheSize(), 0u);
+
+    setRsaKeyCacheCapacity(oldCapacity);
 }
 
 // 测试密钥序列化和反序列化
@@ -565,6 +521,69 @@ TEST_F(RsaTest, KeyReuse)
     }
 }
 
+// 测试批量解密：结果与逐条解密一致，停止的线程池退回串行，失败时报告出错的下标
+TEST_F(RsaTest, DecryptBatch)
+{
+    RsaPublicKey publicKey = RsaPublicKey::fromPem(rsaKeys.publicKey);
+    RsaPrivateKey privateKey = RsaPrivateKey::fromPem(rsaKeys.privateKey);
+
+    std::vector<std::string> messages;
+    std::vector<std::string> ciphertexts;
+    for (int i = 0; i < 24; ++i) {
+        messages.push_back("Message " + std::to_string(i) + std::string(i * 8, 'x'));
+        ciphertexts.push_back(rsaEncrypt(publicKey, messages.back()));
+    }
+
+    ThreadPool pool(3);
+    EXPECT_EQ(rsaDecryptBatch(privateKey, ciphertexts, pool), messages);
+    EXPECT_TRUE(rsaDecryptBatch(privateKey, {}, pool).empty());
+
+    ThreadPool stopped(1);
+    stopped.shutdown();
+    EXPECT_EQ(rsaDecryptBatch(privateKey, ciphertexts, stopped), messages);
+
+    ciphertexts[7][100] ^= 0x01;
+    try {
+        rsaDecryptBatch(privateKey, ciphertexts, pool);
+        FAIL() << "expected std::runtime_error";
+    } catch (const std::runtime_error &e) {
+        EXPECT_NE(std::string(e.what()).find("ciphertext 7"), std::string::npos) << e.what();
+    }
+
+    // 用错误的私钥解密，每条都会失败
+    RsaPrivateKey wrongKey = RsaPrivateKey::fromPem(generateRsaKey().privateKey);
+    EXPECT_THROW(rsaDecryptBatch(wrongKey, std::span(ciphertexts).first(3), pool),
+                 std::runtime_error);
+}
+
+// 测试线程内缓存的上下文：多把密钥轮流使用（超过缓存容量）、解密失败之后、句柄副本之间都能正确复用
+TEST_F(RsaTest, HandleContextReuse)
+{
+    std::vector<RsaPublicKey> publicKeys;
+    std::vector<RsaPrivateKey> privateKeys;
+    for (int i = 0; i < 5; ++i) {
+        const RsaKeyPair pair = i == 0 ? rsaKeys : generateRsaKey();
+        publicKeys.push_back(RsaPublicKey::fromPem(pair.publicKey));
+        privateKeys.push_back(RsaPrivateKey::fromPem(pair.privateKey));
+    }
+
+    for (int round = 0; round < 3; ++round) {
+        for (size_t i = 0; i < publicKeys.size(); ++i) {
+            const std::string message = "round " + std::to_string(round) + " key "
+                                        + std::to_string(i);
+            const std::string encrypted = rsaEncrypt(publicKeys[i], message);
+            EXPECT_EQ(rsaDecrypt(privateKeys[i], encrypted), message);
+
+            // 用另一把私钥解密失败后，同一线程缓存的上下文仍然可用
+            EXPECT_THROW(rsaDecrypt(privateKeys[(i + 1) % privateKeys.size()], encrypted),
+                         std::runtime_error);
+            ERR_clear_error();
+            const RsaPrivateKey copy = privateKeys[i];
+            EXPECT_EQ(rsaDecrypt(copy, encrypted), message);
+        }
+    }
+}
+
 int main(int argc, char **argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
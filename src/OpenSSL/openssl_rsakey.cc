@@ -0,0 +1,386 @@
+#include "openssl_rsakey.hpp"
+#include "openssl_hasher.hpp"
+#include "openssl_parallel.hpp"
+
+#include <algorithm>
+#include <list>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+
+namespace {
+
+struct PkeyDeleter
+{
+    void operator()(EVP_PKEY *key) const { EVP_PKEY_free(key); }
+};
+
+using ReadPem = EVP_PKEY *(*) (BIO *, EVP_PKEY **, pem_password_cb *, void *);
+
+auto parsePem(std::string_view pem, ReadPem read) -> std::shared_ptr<EVP_PKEY>
+{
+    BIO *bio = BIO_new_mem_buf(pem.data(), static_cast<int>(pem.size()));
+    if (!bio)
+        handleOpenSSLError();
+
+    EVP_PKEY *pkey = read(bio, nullptr, nullptr, nullptr);
+    BIO_free(bio);
+
+    if (!pkey)
+        handleOpenSSLError();
+
+    return std::shared_ptr<EVP_PKEY>(pkey, PkeyDeleter());
+}
+
+struct PkeyCtxDeleter
+{
+    void operator()(EVP_PKEY_CTX *ctx) const { EVP_PKEY_CTX_free(ctx); }
+};
+
+using PkeyCtxPtr = std::unique_ptr<EVP_PKEY_CTX, PkeyCtxDeleter>;
+
+auto newPkeyCtx(EVP_PKEY *pkey) -> PkeyCtxPtr
+{
+    PkeyCtxPtr ctx(EVP_PKEY_CTX_new(pkey, nullptr));
+    if (!ctx)
+        handleOpenSSLError();
+    return ctx;
+}
+
+auto newEncryptCtx(EVP_PKEY *pkey) -> PkeyCtxPtr
+{
+    PkeyCtxPtr ctx = newPkeyCtx(pkey);
+    if (EVP_PKEY_encrypt_init(ctx.get()) <= 0) {
+        throw std::runtime_error("EVP_PKEY_encrypt_init failed");
+    }
+    if (EVP_PKEY_CTX_set_rsa_padding(ctx.get(), RSA_PKCS1_OAEP_PADDING) <= 0) {
+        throw std::runtime_error("EVP_PKEY_CTX_set_rsa_padding failed");
+    }
+    return ctx;
+}
+
+auto newDecryptCtx(EVP_PKEY *pkey) -> PkeyCtxPtr
+{
+    PkeyCtxPtr ctx = newPkeyCtx(pkey);
+    if (EVP_PKEY_decrypt_init(ctx.get()) <= 0) {
+        throw std::runtime_error("EVP_PKEY_decrypt_init failed");
+    }
+    if (EVP_PKEY_CTX_set_rsa_padding(ctx.get(), RSA_PKCS1_OAEP_PADDING) <= 0) {
+        throw std::runtime_error("EVP_PKEY_CTX_set_rsa_padding failed");
+    }
+    return ctx;
+}
+
+enum class RsaOperation { Encrypt, Decrypt };
+
+// 每个线程为最近用过的几把密钥各保留一个已经 init 并设置好 OAEP 填充的上下文，
+// 同一把密钥（包括共享同一 EVP_PKEY 的句柄副本）的后续调用直接复用。
+// 上下文持有密钥的引用，缓存项存在期间密钥不会被释放、地址不会被复用，以指针为键不会误命中
+class RsaContextCache
+{
+public:
+    template<typename Create>
+    static EVP_PKEY_CTX *get(EVP_PKEY *pkey, RsaOperation operation, Create create)
+    {
+        auto &entries = threadEntries();
+        auto it = std::find_if(entries.begin(), entries.end(), [&](const Entry &entry) {
+            return entry.pkey == pkey && entry.operation == operation;
+        });
+        if (it != entries.end()) {
+            // 最近使用的放在末尾
+            std::rotate(it, it + 1, entries.end());
+            return entries.back().ctx.get();
+        }
+
+        PkeyCtxPtr ctx = create();
+        if (entries.size() >= kMaxEntriesPerThread) {
+            entries.erase(entries.begin());
+        }
+        entries.push_back({pkey, operation, std::move(ctx)});
+        return entries.back().ctx.get();
+    }
+
+private:
+    static constexpr size_t kMaxEntriesPerThread = 4;
+
+    struct Entry
+    {
+        EVP_PKEY *pkey;
+        RsaOperation operation;
+        PkeyCtxPtr ctx;
+    };
+
+    static std::vector<Entry> &threadEntries()
+    {
+        thread_local std::vector<Entry> entries;
+        return entries;
+    }
+};
+
+auto encryptCtx(const RsaPublicKey &key) -> EVP_PKEY_CTX *
+{
+    return RsaContextCache::get(key.get(), RsaOperation::Encrypt, [&key] {
+        return newEncryptCtx(key.get());
+    });
+}
+
+auto decryptCtx(const RsaPrivateKey &key) -> EVP_PKEY_CTX *
+{
+    return RsaContextCache::get(key.get(), RsaOperation::Decrypt, [&key] {
+        return newDecryptCtx(key.get());
+    });
+}
+
+// 解密失败时返回 false，错误留在当前线程的 OpenSSL 错误队列中
+auto decryptWith(EVP_PKEY_CTX *ctx, size_t keySize, const std::string &ciphertext, std::string &out)
+    -> bool
+{
+    out.resize(keySize);
+    size_t outlen = out.size();
+    if (EVP_PKEY_decrypt(ctx,
+                         reinterpret_cast<unsigned char *>(out.data()),
+                         &outlen,
+                         reinterpret_cast<const unsigned char *>(ciphertext.data()),
+                         ciphertext.size())
+        <= 0) {
+        return false;
+    }
+    out.resize(outlen);
+    return true;
+}
+
+// 以 PEM 的 SHA-256 为键的 LRU 缓存，最近使用的在链表头部
+template<typename Key>
+class KeyCache
+{
+public:
+    template<typename Parse>
+    Key get(const std::string &pem, Parse parse)
+    {
+        Hasher hasher(EVP_sha256());
+        hasher.update(pem);
+        const std::string fingerprint = hasher.final();
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (auto it = m_index.find(fingerprint); it != m_index.end()) {
+                m_entries.splice(m_entries.begin(), m_entries, it->second);
+                return it->second->second;
+            }
+        }
+
+        // 解析放在锁外，不阻塞其它线程的命中；并发解析同一个密钥时以先插入的为准
+        Key key = parse(pem);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_capacity == 0) {
+            return key;
+        }
+        if (auto it = m_index.find(fingerprint); it != m_index.end()) {
+            m_entries.splice(m_entries.begin(), m_entries, it->second);
+            return it->second->second;
+        }
+        m_entries.emplace_front(fingerprint, key);
+        m_index.emplace(fingerprint, m_entries.begin());
+        evict();
+        return key;
+    }
+
+    void setCapacity(size_t capacity)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_capacity = capacity;
+        evict();
+    }
+
+    size_t capacity() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_capacity;
+    }
+
+    size_t size() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_entries.size();
+    }
+
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_index.clear();
+        m_entries.clear();
+    }
+
+private:
+    // 调用方持有 m_mutex
+    void evict()
+    {
+        while (m_entries.size() > m_capacity) {
+            m_index.erase(m_entries.back().first);
+            m_entries.pop_back();
+        }
+    }
+
+    using Entry = std::pair<std::string, Key>;
+
+    mutable std::mutex m_mutex;
+    std::list<Entry> m_entries;
+    std::unordered_map<std::string, typename std::list<Entry>::iterator> m_index;
+    size_t m_capacity{kDefaultCapacity};
+
+    static constexpr size_t kDefaultCapacity = 16;
+};
+
+auto publicKeyCache() -> KeyCache<RsaPublicKey> &
+{
+    static KeyCache<RsaPublicKey> cache;
+    return cache;
+}
+
+auto privateKeyCache() -> KeyCache<RsaPrivateKey> &
+{
+    static KeyCache<RsaPrivateKey> cache;
+    return cache;
+}
+
+} // namespace
+
+RsaPublicKey RsaPublicKey::fromPem(std::string_view pem)
+{
+    return RsaPublicKey(parsePem(pem, PEM_read_bio_PUBKEY));
+}
+
+size_t RsaPublicKey::size() const
+{
+    return static_cast<size_t>(EVP_PKEY_get_size(m_key.get()));
+}
+
+RsaPrivateKey RsaPrivateKey::fromPem(std::string_view pem)
+{
+    return RsaPrivateKey(parsePem(pem, PEM_read_bio_PrivateKey));
+}
+
+size_t RsaPrivateKey::size() const
+{
+    return static_cast<size_t>(EVP_PKEY_get_size(m_key.get()));
+}
+
+std::string rsaEncrypt(const RsaPublicKey &key, const std::string &plaintext)
+{
+    const size_t maxRsaPlaintextLength = key.maxPlaintextSize();
+    if (plaintext.length() > maxRsaPlaintextLength) {
+        throw std::invalid_argument(
+            "Plaintext too long for RSA encryption: " + std::to_string(plaintext.length())
+            + " bytes (max: " + std::to_string(maxRsaPlaintextLength) + " bytes)");
+    }
+
+    EVP_PKEY_CTX *ctx = encryptCtx(key);
+
+    // 密文长度固定为模长，不需要先查询一次
+    std::string encrypted(key.size(), '\0');
+    size_t outlen = encrypted.size();
+    if (EVP_PKEY_encrypt(ctx,
+                         reinterpret_cast<unsigned char *>(encrypted.data()),
+                         &outlen,
+                         reinterpret_cast<const unsigned char *>(plaintext.data()),
+                         plaintext.size())
+        <= 0) {
+        throw std::runtime_error("EVP_PKEY_encrypt failed");
+    }
+    encrypted.resize(outlen);
+    return encrypted;
+}
+
+std::string rsaDecrypt(const RsaPrivateKey &key, const std::string &ciphertext)
+{
+    std::string decrypted;
+    if (!decryptWith(decryptCtx(key), key.size(), ciphertext, decrypted)) {
+        throw std::runtime_error("EVP_PKEY_decrypt failed");
+    }
+    return decrypted;
+}
+
+std::vector<std::string> rsaDecryptBatch(const RsaPrivateKey &key,
+                                         std::span<const std::string> ciphertexts,
+                                         ThreadPool &pool)
+{
+    // 在调用线程取得（或建立）上下文，密钥或参数有问题时直接抛出，不分派任务
+    EVP_PKEY_CTX *prototype = decryptCtx(key);
+    const size_t keySize = key.size();
+    std::vector<std::string> plaintexts(ciphertexts.size());
+
+    const auto decryptOne = [&](EVP_PKEY_CTX *ctx, size_t index) {
+        if (!decryptWith(ctx, keySize, ciphertexts[index], plaintexts[index])) {
+            // 工作线程的错误队列不会被其他调用读取，丢弃后再抛出
+            ERR_clear_error();
+            throw std::runtime_error("rsaDecryptBatch: EVP_PKEY_decrypt failed for ciphertext "
+                                     + std::to_string(index));
+        }
+    };
+
+    if (ciphertexts.size() < 2 || !pool.isRunning()) {
+        for (size_t i = 0; i < ciphertexts.size(); ++i) {
+            decryptOne(prototype, i);
+        }
+        return plaintexts;
+    }
+
+    const auto clone = [prototype] {
+        PkeyCtxPtr ctx(EVP_PKEY_CTX_dup(prototype));
+        if (!ctx) {
+            handleOpenSSLError();
+        }
+        return ctx;
+    };
+
+    // 单条私钥运算在毫秒级，逐条领取即可均衡负载。工作线程使用本线程缓存的上下文，
+    // 没有时复制一份模板放入缓存。模板是调用线程缓存的上下文，解密时会修改其内部状态，
+    // 不能一边解密一边被复制，因此整批期间调用线程改用自己的副本，模板只被读取
+    const PkeyCtxPtr callerCtx = clone();
+    const auto caller = std::this_thread::get_id();
+    parallelFor(
+        pool,
+        ciphertexts.size(),
+        [&key, &clone, &callerCtx, caller] {
+            if (std::this_thread::get_id() == caller) {
+                return callerCtx.get();
+            }
+            return RsaContextCache::get(key.get(), RsaOperation::Decrypt, clone);
+        },
+        [&](EVP_PKEY_CTX *ctx, size_t index) { decryptOne(ctx, index); });
+    return plaintexts;
+}
+
+RsaPublicKey cachedRsaPublicKey(const std::string &pem)
+{
+    return publicKeyCache().get(pem, RsaPublicKey::fromPem);
+}
+
+RsaPrivateKey cachedRsaPrivateKey(const std::string &pem)
+{
+    return privateKeyCache().get(pem, RsaPrivateKey::fromPem);
+}
+
+void setRsaKeyCacheCapacity(size_t capacity)
+{
+    publicKeyCache().setCapacity(capacity);
+    privateKeyCache().setCapacity(capacity);
+}
+
+size_t rsaKeyCacheCapacity()
+{
+    return publicKeyCache().capacity();
+}
+
+size_t rsaKeyCacheSize()
+{
+    return publicKeyCache().size() + privateKeyCache().size();
+}
+
+void clearRsaKeyCache()
+{
+    publicKeyCache().clear();
+    privateKeyCache().clear();
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "openssl_common.hpp"
+
+#include <memory>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+class ThreadPool;
+
+// 解析一次、反复使用的 RSA 密钥句柄。句柄之间共享同一个 EVP_PKEY（只读使用，可跨线程），
+// 复制开销只是一次引用计数。解析失败时通过 handleOpenSSLError 抛出 std::runtime_error
+class RsaPublicKey
+{
+public:
+    static RsaPublicKey fromPem(std::string_view pem);
+
+    [[nodiscard]] EVP_PKEY *get() const { return m_key.get(); }
+    // 模长字节数，即密文长度
+    [[nodiscard]] size_t size() const;
+    // OAEP（SHA-1）填充下单次可加密的最大明文长度
+    [[nodiscard]] size_t maxPlaintextSize() const { return size() - 42; }
+
+private:
+    explicit RsaPublicKey(std::shared_ptr<EVP_PKEY> key)
+        : m_key(std::move(key))
+    {}
+
+    std::shared_ptr<EVP_PKEY> m_key;
+};
+
+class RsaPrivateKey
+{
+public:
+    static RsaPrivateKey fromPem(std::string_view pem);
+
+    [[nodiscard]] EVP_PKEY *get() const { return m_key.get(); }
+    [[nodiscard]] size_t size() const;
+
+private:
+    explicit RsaPrivateKey(std::shared_ptr<EVP_PKEY> key)
+        : m_key(std::move(key))
+    {}
+
+    std::shared_ptr<EVP_PKEY> m_key;
+};
+
+// RSA-OAEP 加解密，直接使用已解析的密钥。每个线程为最近用过的 4 把密钥缓存已初始化的上下文，
+// 同一把密钥的重复调用不再 new + init + 设置填充；缓存的上下文持有密钥的引用
+std::string rsaEncrypt(const RsaPublicKey &key, const std::string &plaintext);
+std::string rsaDecrypt(const RsaPrivateKey &key, const std::string &ciphertext);
+
+// 批量 RSA-OAEP 解密：调用线程先取得设置了填充的解密上下文，pool 的工作线程复用各自线程缓存的
+// 上下文（没有时用 EVP_PKEY_CTX_dup 复制一份）后逐条领取密文，整批不再重复 init 与参数设置。
+// 返回的明文与 ciphertexts 一一对应；任何一条解密失败时抛出 std::runtime_error（带上下标）。
+// 只有一条密文或 pool 已停止时在调用线程串行解密
+std::vector<std::string> rsaDecryptBatch(const RsaPrivateKey &key,
+                                         std::span<const std::string> ciphertexts,
+                                         ThreadPool &pool);
+
+// 只有 PEM 字符串的调用方使用的 LRU 缓存，以 PEM 的 SHA-256 作为指纹，
+// 命中时省去 PEM 解码与 ASN.1 解析。线程安全
+RsaPublicKey cachedRsaPublicKey(const std::string &pem);
+RsaPrivateKey cachedRsaPrivateKey(const std::string &pem);
+
+// 公钥、私钥缓存各自最多保留 capacity 个密钥，0 表示禁用缓存
+void setRsaKeyCacheCapacity(size_t capacity);
+size_t rsaKeyCacheCapacity();
+// 当前缓存的公钥与私钥总数
+size_t rsaKeyCacheSize();
+void clearRsaKeyCache();
@@ -0,0 +1,184 @@
+#include "openssl_treehash.hpp"
+#include "openssl_hasher.hpp"
+#include "openssl_parallel.hpp"
+#include "openssl_utils.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#endif
+
+namespace {
+
+constexpr unsigned char kLeafPrefix = 0x00;
+constexpr unsigned char kNodePrefix = 0x01;
+constexpr unsigned char kRootPrefix = 0x02;
+
+// 每个任务合并的节点对数，层内节点较少时串行合并
+constexpr size_t kPairsPerTask = 512;
+
+void appendLe64(Hasher &hasher, uint64_t value)
+{
+    unsigned char bytes[8];
+    for (int i = 0; i < 8; ++i) {
+        bytes[i] = static_cast<unsigned char>(value >> (8 * i));
+    }
+    hasher.update(bytes, sizeof(bytes));
+}
+
+void hashLeaf(Hasher &hasher, std::span<const std::byte> leaf, unsigned char *out)
+{
+    hasher.update(&kLeafPrefix, 1);
+    hasher.update(leaf);
+    hasher.final(out);
+}
+
+// 从叶子摘要逐层合并到根，nodes 中每 digestSize 字节一个节点，合并结果原地写回
+std::string combine(std::vector<unsigned char> nodes,
+                    size_t digestSize,
+                    const EVP_MD *md,
+                    ThreadPool &pool,
+                    uint64_t leafSize,
+                    uint64_t totalLength)
+{
+    Hasher hasher(md);
+    size_t count = nodes.size() / digestSize;
+
+    // 第 pair 对（from 中第 2 * pair、2 * pair + 1 个节点）合并后写入 to 的第 pair 个位置
+    auto mergePair = [digestSize](Hasher &worker,
+                                  const unsigned char *from,
+                                  unsigned char *to,
+                                  size_t pair) {
+        worker.update(&kNodePrefix, 1);
+        worker.update(from + 2 * pair * digestSize, 2 * digestSize);
+        worker.final(to + pair * digestSize);
+    };
+
+    while (count > 1) {
+        const size_t pairs = count / 2;
+        if (pairs < 2 * kPairsPerTask) {
+            // 串行时原地写回：第 pair 个位置在它被写入之前已经读完
+            for (size_t pair = 0; pair < pairs; ++pair) {
+                mergePair(hasher, nodes.data(), nodes.data(), pair);
+            }
+        } else {
+            // 并行时其它组可能还在读，写到新数组；落单的节点一并带过去
+            std::vector<unsigned char> next(count * digestSize);
+            const size_t tasks = (pairs + kPairsPerTask - 1) / kPairsPerTask;
+            parallelFor(
+                pool,
+                tasks,
+                [md] { return Hasher(md); },
+                [&](Hasher &worker, size_t task) {
+                    const size_t end = std::min((task + 1) * kPairsPerTask, pairs);
+                    for (size_t pair = task * kPairsPerTask; pair < end; ++pair) {
+                        mergePair(worker, nodes.data(), next.data(), pair);
+                    }
+                });
+            if (count % 2 != 0) {
+                std::memcpy(next.data() + (count - 1) * digestSize,
+                            nodes.data() + (count - 1) * digestSize,
+                            digestSize);
+            }
+            nodes.swap(next);
+        }
+        if (count % 2 != 0) {
+            // 落单的最后一个节点原样进入上一层
+            std::memmove(nodes.data() + pairs * digestSize,
+                         nodes.data() + (count - 1) * digestSize,
+                         digestSize);
+        }
+        count = (count + 1) / 2;
+    }
+
+    hasher.update(&kRootPrefix, 1);
+    appendLe64(hasher, leafSize);
+    appendLe64(hasher, totalLength);
+    hasher.update(nodes.data(), digestSize);
+    return hasher.final();
+}
+
+} // namespace
+
+std::string treeHash(std::span<const std::byte> data,
+                     const EVP_MD *md,
+                     ThreadPool &pool,
+                     size_t leafSize)
+{
+    if (leafSize == 0) {
+        throw std::invalid_argument("treeHash: leaf size must be positive");
+    }
+
+    Hasher hasher(md);
+    const size_t digestSize = hasher.digestSize();
+    const size_t leafCount = std::max<size_t>((data.size() + leafSize - 1) / leafSize, 1);
+    std::vector<unsigned char> nodes(leafCount * digestSize);
+
+    auto leaf = [&](Hasher &worker, size_t index) {
+        const size_t begin = index * leafSize;
+        const size_t length = std::min(leafSize, data.size() - begin);
+        hashLeaf(worker, data.subspan(begin, length), nodes.data() + index * digestSize);
+    };
+
+    if (leafCount == 1) {
+        leaf(hasher, 0);
+    } else {
+        parallelFor(pool, leafCount, [md] { return Hasher(md); }, leaf);
+    }
+    return combine(std::move(nodes), digestSize, md, pool, leafSize, data.size());
+}
+
+std::string treeHashFile(const std::string &path,
+                         const EVP_MD *md,
+                         ThreadPool &pool,
+                         size_t leafSize)
+{
+    if (leafSize == 0) {
+        throw std::invalid_argument("treeHash: leaf size must be positive");
+    }
+
+#ifndef _WIN32
+    OpenSSLUtils::FileDescriptor file{::open(path.c_str(), O_RDONLY | O_CLOEXEC)};
+    if (file.fd < 0) {
+        OpenSSLUtils::throwFileError("Failed to open", path);
+    }
+    OpenSSLUtils::Mapping input;
+    if (OpenSSLUtils::mapInput(file.fd, path, input)) {
+        return treeHash(input.bytes(), md, pool, leafSize);
+    }
+#endif
+
+    // 空文件、不能映射的文件以及没有 mmap 的平台逐个叶子读入并串行计算，内存占用为一个叶子
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        OpenSSLUtils::throwFileError("Failed to open", path);
+    }
+    Hasher hasher(md);
+    const size_t digestSize = hasher.digestSize();
+    std::vector<unsigned char> nodes;
+    uint64_t total = 0;
+    const auto leaf = [&](std::span<const std::byte> data) {
+        nodes.resize(nodes.size() + digestSize);
+        hashLeaf(hasher, data, nodes.data() + nodes.size() - digestSize);
+        total += data.size();
+    };
+    OpenSSLUtils::readStream(in, leafSize, [&leaf](std::span<const char> chunk) {
+        leaf(std::as_bytes(chunk));
+    });
+    if (nodes.empty()) {
+        leaf({});
+    }
+    return combine(std::move(nodes), digestSize, md, pool, leafSize, total);
+}
+
+#ifndef OPENSSL_NO_BLAKE2
+std::string treeHashBlake2(std::span<const std::byte> data, ThreadPool &pool, size_t leafSize)
+{
+    return treeHash(data, EVP_blake2b512(), pool, leafSize);
+}
+#endif
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "openssl_common.hpp"
+
+#include <cstddef>
+#include <span>
+#include <string>
+
+class ThreadPool;
+
+// 单个超大输入的树形（Merkle）哈希：定长叶子在 ThreadPool 上并行计算，再逐层合并。
+// 输出格式固定如下，H 为所选摘要算法，le64 为 8 字节小端整数：
+//
+//   叶子：输入按 leafSize 切分，最后一片可以更短；空输入视为一个空叶子
+//         leaf[i] = H(0x00 || data[i])
+//   内部节点：每层从左到右两两合并，落单的最后一个节点原样进入上一层
+//         node = H(0x01 || left || right)
+//   根：  root = H(0x02 || le64(leafSize) || le64(totalLength) || top)
+//
+// 0x00/0x01/0x02 前缀区分叶子、内部节点与根，根中带上叶子大小和总长度，
+// 不同参数或不同切分方式不会得到相同结果。结果与普通的 H(data) 不同，不能混用
+constexpr size_t kTreeHashLeafSize = 1 << 20;
+
+std::string treeHash(std::span<const std::byte> data,
+                     const EVP_MD *md,
+                     ThreadPool &pool,
+                     size_t leafSize = kTreeHashLeafSize);
+
+// 对文件计算同样格式的树形哈希：POSIX 下普通文件整体只读映射后并行计算叶子，
+// 页缓存中的页面可随时回收，常驻内存不随文件增长；管道等不能映射的文件逐个叶子读入串行计算
+std::string treeHashFile(const std::string &path,
+                         const EVP_MD *md,
+                         ThreadPool &pool,
+                         size_t leafSize = kTreeHashLeafSize);
+
+#ifndef OPENSSL_NO_BLAKE2
+// BLAKE3 风格的路径：OpenSSL 没有 BLAKE3，这里用 BLAKE2b-512 作为叶子与节点的哈希函数，
+// 配合上面的树形结构获得同样的多核并行能力。没有 SHA 扩展指令的 64 位 CPU 上通常比 SHA-256 快
+std::string treeHashBlake2(std::span<const std::byte> data,
+                           ThreadPool &pool,
+                           size_t leafSize = kTreeHashLeafSize);
+#endif
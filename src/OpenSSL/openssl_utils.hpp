@@ -0,0 +1,194 @@
+#pragma once
+
+#include "openssl_aesmodes.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <istream>
+#include <new>
+#include <ostream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// 各实现文件共用的内部工具：指针转换、密钥长度检查、流与文件的分块读取。不属于对外接口
+namespace OpenSSLUtils {
+
+// EVP_*Update 的长度参数是 int，超大输入按块送入
+constexpr size_t kMaxUpdate = size_t{1} << 30;
+
+inline auto toUChar(const std::byte *p) -> const unsigned char *
+{
+    return reinterpret_cast<const unsigned char *>(p);
+}
+
+inline auto toUChar(std::byte *p) -> unsigned char *
+{
+    return reinterpret_cast<unsigned char *>(p);
+}
+
+inline void checkKeySize(size_t size)
+{
+    if (size != kAesKeySize) {
+        throw std::invalid_argument("AES key must be 32 bytes (256-bit), got: "
+                                    + std::to_string(size));
+    }
+}
+
+[[noreturn]] inline void throwFileError(const std::string &what, const std::string &path)
+{
+    throw std::runtime_error(what + " '" + path + "': " + std::strerror(errno));
+}
+
+inline void writeStream(std::ostream &out, const void *data, size_t size)
+{
+    out.write(static_cast<const char *>(data), static_cast<std::streamsize>(size));
+    if (!out) {
+        throw std::runtime_error("Failed to write to stream");
+    }
+}
+
+// 从 in 读取到 EOF，每凑满 chunkSize 字节（最后一块可以不满，空块跳过）调用一次 consume(std::span<const char>)
+template<typename Consume>
+void readStream(std::istream &in, size_t chunkSize, Consume consume)
+{
+    std::vector<char> buffer(std::max<size_t>(chunkSize, 1));
+    while (in) {
+        in.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        if (const auto n = static_cast<size_t>(in.gcount()); n > 0) {
+            consume(std::span<const char>(buffer.data(), n));
+        }
+    }
+    if (in.bad()) {
+        throw std::runtime_error("Failed to read from stream");
+    }
+}
+
+#ifndef _WIN32
+struct FileDescriptor
+{
+    int fd;
+    ~FileDescriptor()
+    {
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+};
+
+struct Mapping
+{
+    void *data = nullptr;
+    size_t size = 0;
+
+    ~Mapping()
+    {
+        if (data) {
+            ::munmap(data, size);
+        }
+    }
+
+    auto bytes() const -> std::span<std::byte> { return {static_cast<std::byte *>(data), size}; }
+};
+
+// 普通非空文件整体只读映射；返回 false 时由调用方退回逐块读取
+inline auto mapInput(int fd, const std::string &path, Mapping &mapping) -> bool
+{
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        throwFileError("Failed to stat", path);
+    }
+    if (!S_ISREG(st.st_mode) || st.st_size <= 0) {
+        return false;
+    }
+    const auto size = static_cast<size_t>(st.st_size);
+    void *map = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (map == MAP_FAILED) {
+        return false;
+    }
+    mapping.data = map;
+    mapping.size = size;
+    // 各线程按顺序推进，整体接近顺序读
+    ::madvise(map, size, MADV_SEQUENTIAL);
+    return true;
+}
+
+// 页对齐的读缓冲区，避免内核拷贝时跨页
+struct AlignedBuffer
+{
+    explicit AlignedBuffer(size_t size)
+        : data(static_cast<std::byte *>(::operator new(size, std::align_val_t{4096})))
+    {}
+    ~AlignedBuffer() { ::operator delete(data, std::align_val_t{4096}); }
+
+    std::byte *data;
+};
+
+// 逐块读取整个文件，每块调用 consume(std::span<const std::byte>)。普通文件每次只映射一块，
+// 处理完立即解除映射，常驻内存不随文件增长；管道、/proc 等不能映射的文件退回 read，
+// 每次最多 1 MiB，块的边界取决于 read 的返回值。chunkSize 向下取整到整页
+template<typename Consume>
+void readFile(int fd, const std::string &path, size_t chunkSize, Consume consume)
+{
+    const auto pageSize = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    chunkSize = std::max(chunkSize, pageSize) / pageSize * pageSize;
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        throwFileError("Failed to stat", path);
+    }
+    const auto fileSize = static_cast<size_t>(st.st_size);
+    size_t offset = 0;
+    if (S_ISREG(st.st_mode)) {
+        for (; offset < fileSize; offset += chunkSize) {
+            Mapping chunk;
+            chunk.size = std::min(chunkSize, fileSize - offset);
+            void *map = ::mmap(nullptr, chunk.size, PROT_READ, MAP_PRIVATE, fd, off_t(offset));
+            if (map == MAP_FAILED) {
+                if (offset == 0) {
+                    break; // 不支持映射的文件系统，交给 read
+                }
+                throwFileError("Failed to map", path);
+            }
+            chunk.data = map;
+            ::madvise(map, chunk.size, MADV_SEQUENTIAL);
+            consume(std::span<const std::byte>(chunk.bytes()));
+        }
+    }
+    if (offset > 0) {
+        return;
+    }
+
+    // /proc 等 st_size 为 0 但可以读出内容的文件同样走 read
+#if defined(POSIX_FADV_SEQUENTIAL)
+    ::posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+    const size_t bufferSize = std::min<size_t>(chunkSize, 1 << 20);
+    AlignedBuffer buffer(bufferSize);
+    while (true) {
+        const ssize_t n = ::read(fd, buffer.data, bufferSize);
+        if (n == 0) {
+            break;
+        }
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throwFileError("Failed to read", path);
+        }
+        consume(std::span<const std::byte>(buffer.data, static_cast<size_t>(n)));
+    }
+}
+#endif
+
+} // namespace OpenSSLUtils
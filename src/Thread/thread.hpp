@@ -1,12 +1,17 @@
 #pragma once
 
+#include "threadcache.hpp"
+
 #include <utils/object.hpp>
 
+#include <atomic>
 #include <chrono>
 #include <condition_variable>
 #include <functional>
 #include <iostream>
 #include <mutex>
+#include <stop_token>
+#include <string>
 #include <thread>
 #include <type_traits>
 
@@ -29,7 +34,11 @@ public:
         : m_task(std::move(task))
     {}
 
-    ~Thread() { stop(); }
+    ~Thread()
+    {
+        stop();
+        joinThread();
+    }
 
     void setTask(Task task)
     {
@@ -40,22 +49,83 @@ public:
         m_task = std::move(task);
     }
 
+    // 设置线程栈大小（字节），0 表示使用系统默认值
+    void setStackSize(size_t stackSize)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_state != State::Idle && m_state != State::Stopped) {
+            throw std::runtime_error("Cannot set stack size while thread is not idle");
+        }
+        m_stackSize = stackSize;
+    }
+
+    [[nodiscard]] size_t stackSize() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_stackSize;
+    }
+
+    // 设置操作系统可见的线程名称，便于调试器和性能分析工具识别
+    void setName(std::string name)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_state != State::Idle && m_state != State::Stopped) {
+            throw std::runtime_error("Cannot set name while thread is not idle");
+        }
+        m_name = std::move(name);
+    }
+
+    [[nodiscard]] std::string name() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_name;
+    }
+
+    // 启动时复用 ThreadCache 中挂起的线程，而不是创建新线程
+    void setUseThreadCache(bool enable)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_state != State::Idle && m_state != State::Stopped) {
+            throw std::runtime_error("Cannot change thread cache usage while thread is not idle");
+        }
+        m_useThreadCache = enable;
+    }
+
+    [[nodiscard]] bool useThreadCache() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_useThreadCache;
+    }
+
     bool start()
     {
-        std::unique_lock<std::mutex> lock(m_mutex);
+        std::lock_guard<std::mutex> lock(m_mutex);
 
-        if (m_state != State::Idle || !m_task) {
+        State expected = State::Idle;
+        if (!m_task
+            || !m_state.compare_exchange_strong(expected,
+                                                State::Starting,
+                                                std::memory_order_acq_rel)) {
             return false;
         }
 
-        m_state = State::Starting;
+        m_stopSource = std::stop_source();
 
         try {
-            m_jthread = std::jthread([this](std::stop_token token) { threadMain(token); });
+            auto entry = [this, token = m_stopSource.get_token()] { threadMain(token); };
+            bool started = false;
+            if (m_useThreadCache) {
+                m_job = ThreadCache::instance().run(entry, m_stackSize);
+                started = m_job != nullptr;
+            } else {
+                started = m_thread.start(entry, m_stackSize);
+            }
+            if (!started) {
+                throw std::runtime_error("Failed to start thread");
+            }
             return true;
         } catch (...) {
-            m_state = State::Stopped;
-            m_condState.notify_all();
+            setState(State::Stopped);
             return false;
         }
     }
@@ -64,60 +134,64 @@ public:
 
     void stop(std::chrono::milliseconds timeout) { stopInternal(true, timeout); }
 
-    void requestStop()
-    {
-        if (m_jthread.joinable()) {
-            m_jthread.request_stop();
-        }
-    }
+    void requestStop() { stopSource().request_stop(); }
 
     bool waitForFinished(std::chrono::milliseconds timeout = std::chrono::milliseconds::max())
     {
-        std::unique_lock<std::mutex> lock(m_mutex);
+        State state = m_state.load(std::memory_order_acquire);
 
         // 如果已经是停止状态或空闲状态，直接返回
-        if (m_state == State::Stopped || m_state == State::Idle) {
+        if (state == State::Stopped || state == State::Idle) {
             return true;
         }
 
-        // 等待状态变为 Stopped
+        // 无限等待：直接在原子变量上等待状态变为 Stopped
         if (timeout == std::chrono::milliseconds::max()) {
-            m_condState.wait(lock, [this] { return m_state == State::Stopped; });
+            while (state != State::Stopped) {
+                m_state.wait(state, std::memory_order_acquire);
+                state = m_state.load(std::memory_order_acquire);
+            }
             return true;
-        } else {
-            return m_condState.wait_for(lock, timeout, [this] { return m_state == State::Stopped; });
         }
+
+        // atomic::wait 不支持超时，带超时的等待仍使用条件变量
+        std::unique_lock<std::mutex> lock(m_waitMutex);
+        return m_condState.wait_for(lock, timeout, [this] {
+            return m_state.load(std::memory_order_acquire) == State::Stopped;
+        });
     }
 
     [[nodiscard]] bool isRunning() const
     {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        return m_state == State::Running || m_state == State::Starting;
+        const State state = m_state.load(std::memory_order_acquire);
+        return state == State::Running || state == State::Starting;
     }
 
     [[nodiscard]] bool isStopped() const
     {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        return m_state == State::Stopped;
+        return m_state.load(std::memory_order_acquire) == State::Stopped;
     }
 
     [[nodiscard]] bool isIdle() const
     {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        return m_state == State::Idle;
+        return m_state.load(std::memory_order_acquire) == State::Idle;
     }
 
-    [[nodiscard]] State getState() const
+    [[nodiscard]] State getState() const { return m_state.load(std::memory_order_acquire); }
+
+    [[nodiscard]] bool isJoinable() const
     {
         std::lock_guard<std::mutex> lock(m_mutex);
-        return m_state;
+        return m_thread.joinable() || m_job != nullptr;
     }
 
-    [[nodiscard]] bool isJoinable() const { return m_jthread.joinable(); }
-
-    [[nodiscard]] std::thread::id getThreadId() const { return m_jthread.get_id(); }
+    [[nodiscard]] std::thread::id getThreadId() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_threadId;
+    }
 
-    [[nodiscard]] std::stop_token getStopToken() const { return m_jthread.get_stop_token(); }
+    [[nodiscard]] std::stop_token getStopToken() const { return stopSource().get_token(); }
 
     // 静态工具方法
     static void yield() { std::this_thread::yield(); }
@@ -153,13 +227,26 @@ public:
     }
 
 private:
+    // start() 会替换 m_stopSource，在锁内复制一份，副本与原对象共享停止状态
+    [[nodiscard]] std::stop_source stopSource() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_stopSource;
+    }
+
     void threadMain(std::stop_token token)
     {
+        std::string name;
         {
             std::lock_guard<std::mutex> lock(m_mutex);
-            m_state = State::Running;
+            m_threadId = std::this_thread::get_id();
+            name = m_name;
         }
-        m_condState.notify_all();
+        if (!name.empty()) {
+            NativeThread::setCurrentName(name);
+        }
+
+        setState(State::Running);
 
         try {
             if (m_task) {
@@ -171,21 +258,25 @@ private:
             std::cerr << "Unknown thread exception" << std::endl;
         }
 
-        {
-            std::lock_guard<std::mutex> lock(m_mutex);
-            m_state = State::Stopped;
-        }
+        setState(State::Stopped);
+    }
+
+    void setState(State state)
+    {
+        m_state.store(state, std::memory_order_release);
+        m_state.notify_all();
+
+        // 带超时的等待方使用条件变量，先获取一次锁以避免丢失唤醒
+        { std::lock_guard<std::mutex> lock(m_waitMutex); }
         m_condState.notify_all();
     }
 
     void stopInternal(bool useTimeout,
                       std::chrono::milliseconds timeout = std::chrono::milliseconds(0))
     {
-        {
-            std::lock_guard<std::mutex> lock(m_mutex);
-            if (m_state == State::Stopped || m_state == State::Idle) {
-                return;
-            }
+        const State state = m_state.load(std::memory_order_acquire);
+        if (state == State::Stopped || state == State::Idle) {
+            return;
         }
 
         requestStop();
@@ -196,15 +287,35 @@ private:
             waitForFinished();
         }
 
-        if (!useTimeout && m_jthread.joinable()) {
-            m_jthread.join();
+        if (!useTimeout) {
+            joinThread();
+        }
+    }
+
+    // 只在线程函数已经返回（Stopped）或从未启动时调用，此时线程不会再获取 m_mutex，
+    // 持锁等待不会死锁，isJoinable 也不会读到 join 到一半的状态
+    void joinThread()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_job) {
+            m_job->wait();
+            m_job.reset();
         }
+        m_thread.join();
+        m_threadId = std::thread::id();
     }
 
 private:
-    std::jthread m_jthread;
-    mutable std::mutex m_mutex;
+    NativeThread m_thread;
+    ThreadCache::JobPtr m_job;
+    std::stop_source m_stopSource{std::nostopstate};
+    mutable std::mutex m_mutex; // 保护任务、名称等配置
+    std::mutex m_waitMutex;     // 仅用于带超时的等待
     std::condition_variable m_condState;
-    State m_state{State::Idle};
+    std::atomic<State> m_state{State::Idle};
     Task m_task;
+    std::thread::id m_threadId;
+    std::string m_name;
+    size_t m_stackSize{0};
+    bool m_useThreadCache{false};
 };
@@ -0,0 +1,172 @@
+#include "queue.hpp"
+#include "threadpool.hpp"
+
+#include <utils/benchmarkmain.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+// 运行方式：
+//   thread_bench                                  # 默认输出 JSON 到 thread_bench.json
+//   thread_bench --benchmark_out=result.json      # 指定输出文件
+//   thread_bench --benchmark_filter=Queue         # 只运行部分用例
+
+namespace {
+
+// 模拟 CPU 计算量，避免被编译器优化掉
+void spinWork(int64_t iterations)
+{
+    uint64_t value = 0;
+    for (int64_t i = 0; i < iterations; ++i) {
+        value += static_cast<uint64_t>(i) * 2654435761u;
+        benchmark::DoNotOptimize(value);
+    }
+}
+
+auto workerCount() -> size_t
+{
+    return std::max(2U, std::thread::hardware_concurrency());
+}
+
+} // namespace
+
+// 单个任务提交到执行完成的往返延迟
+static void BM_ThreadPool_SubmitLatency(benchmark::State &state)
+{
+    ThreadPool pool(static_cast<size_t>(state.range(0)));
+
+    for (auto _ : state) {
+        auto future = pool.submitFuture([](std::stop_token) { return 1; });
+        benchmark::DoNotOptimize(future.get());
+    }
+}
+BENCHMARK(BM_ThreadPool_SubmitLatency)->Arg(1)->Arg(4)->UseRealTime();
+
+// 吞吐量与任务大小的关系，range(0) 为每个任务的计算量
+static void BM_ThreadPool_Throughput(benchmark::State &state)
+{
+    const int64_t taskSize = state.range(0);
+    const int batch = 1000;
+    ThreadPool pool(workerCount(), batch);
+
+    for (auto _ : state) {
+        for (int i = 0; i < batch; ++i) {
+            pool.submit([taskSize](std::stop_token) { spinWork(taskSize); });
+        }
+        pool.waitAll();
+    }
+    state.SetItemsProcessed(state.iterations() * batch);
+}
+BENCHMARK(BM_ThreadPool_Throughput)->RangeMultiplier(8)->Range(1, 1 << 15)->UseRealTime();
+
+// 扇出/扇入：一次提交 range(0) 个返回值任务并等待全部结果
+static void BM_ThreadPool_FanOutFanIn(benchmark::State &state)
+{
+    const auto fanOut = static_cast<size_t>(state.range(0));
+    ThreadPool pool(workerCount(), fanOut);
+    std::vector<std::future<int>> futures;
+    futures.reserve(fanOut);
+
+    for (auto _ : state) {
+        futures.clear();
+        for (size_t i = 0; i < fanOut; ++i) {
+            futures.push_back(pool.submitFuture([i](std::stop_token) {
+                spinWork(64);
+                return static_cast<int>(i);
+            }));
+        }
+        int sum = 0;
+        for (auto &future : futures) {
+            sum += future.get();
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ThreadPool_FanOutFanIn)->RangeMultiplier(4)->Range(4, 1024)->UseRealTime();
+
+// 多生产者竞争：range(0) 个线程同时向同一个线程池提交任务
+static void BM_ThreadPool_ProducerContention(benchmark::State &state)
+{
+    const auto producers = static_cast<int>(state.range(0));
+    const int tasksPerProducer = 2000;
+    ThreadPool pool(workerCount(), 4096);
+    std::atomic<int64_t> executed{0};
+
+    for (auto _ : state) {
+        std::vector<std::thread> threads;
+        threads.reserve(producers);
+        for (int p = 0; p < producers; ++p) {
+            threads.emplace_back([&pool, &executed] {
+                for (int i = 0; i < tasksPerProducer; ++i) {
+                    pool.submit([&executed](std::stop_token) {
+                        executed.fetch_add(1, std::memory_order_relaxed);
+                    });
+                }
+            });
+        }
+        for (auto &thread : threads) {
+            thread.join();
+        }
+        pool.waitAll();
+    }
+    state.SetItemsProcessed(state.iterations() * producers * tasksPerProducer);
+}
+BENCHMARK(BM_ThreadPool_ProducerContention)
+    ->DenseRange(1, 2)
+    ->RangeMultiplier(2)
+    ->Range(4, 16)
+    ->UseRealTime();
+
+// Queue<T> 乒乓：两个线程通过一对队列来回传递一个整数
+static void BM_Queue_PingPong(benchmark::State &state)
+{
+    Queue<int> ping;
+    Queue<int> pong;
+
+    std::thread echo([&ping, &pong] {
+        while (auto value = ping.pop()) {
+            if (!pong.push(*value)) {
+                break;
+            }
+        }
+    });
+
+    int value = 0;
+    for (auto _ : state) {
+        if (!ping.push(value)) {
+            state.SkipWithError("push failed");
+            break;
+        }
+        auto result = pong.pop();
+        benchmark::DoNotOptimize(result);
+        ++value;
+    }
+
+    ping.stop();
+    pong.stop();
+    echo.join();
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Queue_PingPong)->UseRealTime();
+
+// 线程启动开销：新建线程 vs 复用 ThreadCache 中挂起的线程
+static void BM_Thread_StartStop(benchmark::State &state)
+{
+    const bool useCache = state.range(0) != 0;
+
+    for (auto _ : state) {
+        Thread thread([](std::stop_token) {});
+        thread.setUseThreadCache(useCache);
+        thread.start();
+        thread.stop();
+    }
+    state.SetLabel(useCache ? "cached" : "spawn");
+}
+BENCHMARK(BM_Thread_StartStop)->Arg(0)->Arg(1)->UseRealTime();
+
+int main(int argc, char **argv)
+{
+    return Utils::runBenchmarks(argc, argv, "thread_bench.json");
+}
@@ -669,6 +669,183 @@ TEST_F(ThreadTest, ExtremeTimeoutValues)
     EXPECT_TRUE(thread.isStopped());
 }
 
+// 测试多个线程同时等待和轮询状态
+TEST_F(ThreadTest, ConcurrentWaitersAndPolling)
+{
+    std::promise<void> release;
+    auto releaseFuture = release.get_future().share();
+
+    Thread thread([releaseFuture](std::stop_token) { releaseFuture.wait(); });
+    EXPECT_TRUE(thread.start());
+
+    std::atomic<int> finishedWaiters{0};
+    std::atomic<bool> polling{true};
+    std::vector<std::thread> waiters;
+    for (int i = 0; i < 4; ++i) {
+        waiters.emplace_back([&thread, &finishedWaiters, i] {
+            bool finished = (i % 2 == 0) ? thread.waitForFinished()
+                                         : thread.waitForFinished(std::chrono::seconds(5));
+            if (finished) {
+                ++finishedWaiters;
+            }
+        });
+    }
+    std::thread poller([&thread, &polling] {
+        while (polling) {
+            (void) thread.isRunning();
+            (void) thread.getState();
+        }
+    });
+
+    std::this_thread::sleep_for(20ms);
+    EXPECT_EQ(finishedWaiters.load(), 0);
+    EXPECT_TRUE(thread.isRunning());
+
+    release.set_value();
+    for (auto &waiter : waiters) {
+        waiter.join();
+    }
+    polling = false;
+    poller.join();
+
+    EXPECT_EQ(finishedWaiters.load(), 4);
+    EXPECT_TRUE(thread.isStopped());
+}
+
+// 测试自定义栈大小
+TEST_F(ThreadTest, CustomStackSize)
+{
+    const size_t requested = 256 * 1024;
+    std::atomic<size_t> actual{0};
+
+    Thread thread([&actual](std::stop_token) {
+#ifdef __linux__
+        pthread_attr_t attr;
+        if (pthread_getattr_np(pthread_self(), &attr) == 0) {
+            size_t size = 0;
+            pthread_attr_getstacksize(&attr, &size);
+            actual = size;
+            pthread_attr_destroy(&attr);
+        }
+#endif
+    });
+
+    thread.setStackSize(requested);
+    EXPECT_EQ(thread.stackSize(), requested);
+
+    EXPECT_TRUE(thread.start());
+    EXPECT_THROW(thread.setStackSize(0), std::runtime_error);
+    thread.stop();
+
+#ifdef __linux__
+    EXPECT_GE(actual.load(), requested);
+    EXPECT_LT(actual.load(), 8 * 1024 * 1024u); // 不应再是默认的 8MB
+#endif
+}
+
+// 测试线程名称
+TEST_F(ThreadTest, ThreadName)
+{
+    std::string osName;
+
+    Thread thread([&osName](std::stop_token) {
+#ifdef __linux__
+        char buffer[16] = {0};
+        pthread_getname_np(pthread_self(), buffer, sizeof(buffer));
+        osName = buffer;
+#endif
+    });
+
+    thread.setName("worker-thread-with-long-name");
+    EXPECT_EQ(thread.name(), "worker-thread-with-long-name");
+
+    EXPECT_TRUE(thread.start());
+    thread.stop();
+
+#ifdef __linux__
+    EXPECT_EQ(osName, "worker-thread-w"); // Linux 截断为 15 个字符
+#endif
+}
+
+// 测试线程缓存复用
+TEST_F(ThreadTest, ThreadCacheReuse)
+{
+    std::thread::id firstId;
+    std::thread::id secondId;
+
+    {
+        Thread thread([&firstId](std::stop_token) { firstId = std::this_thread::get_id(); });
+        thread.setUseThreadCache(true);
+        EXPECT_TRUE(thread.useThreadCache());
+        EXPECT_TRUE(thread.start());
+        EXPECT_TRUE(thread.isJoinable());
+        thread.stop();
+        EXPECT_TRUE(thread.isStopped());
+        EXPECT_FALSE(thread.isJoinable());
+    }
+
+    EXPECT_GE(ThreadCache::instance().idleThreads(), 1u);
+
+    {
+        Thread thread([&secondId](std::stop_token) { secondId = std::this_thread::get_id(); });
+        thread.setUseThreadCache(true);
+        EXPECT_TRUE(thread.start());
+        thread.stop();
+    }
+
+    EXPECT_NE(firstId, std::thread::id());
+    EXPECT_EQ(firstId, secondId); // 第二次启动应复用第一次的线程
+}
+
+// 测试线程缓存中的停止请求
+TEST_F(ThreadTest, ThreadCacheStopRequest)
+{
+    std::atomic<bool> stopped{false};
+    std::promise<void> started;
+
+    Thread thread([&stopped, &started](std::stop_token token) {
+        started.set_value();
+        while (!token.stop_requested()) {
+            std::this_thread::sleep_for(1ms);
+        }
+        stopped = true;
+    });
+    thread.setUseThreadCache(true);
+    thread.setStackSize(512 * 1024);
+
+    EXPECT_TRUE(thread.start());
+    started.get_future().wait();
+    EXPECT_TRUE(thread.isRunning());
+
+    thread.stop();
+    EXPECT_TRUE(stopped);
+    EXPECT_TRUE(thread.isStopped());
+}
+
+// 测试线程缓存空闲线程数限制
+TEST_F(ThreadTest, ThreadCacheTrim)
+{
+    auto &cache = ThreadCache::instance();
+    const size_t oldMax = cache.maxIdleThreads();
+
+    std::vector<std::unique_ptr<Thread>> threads;
+    for (int i = 0; i < 4; ++i) {
+        auto thread = std::make_unique<Thread>([](std::stop_token) {});
+        thread->setUseThreadCache(true);
+        EXPECT_TRUE(thread->start());
+        threads.push_back(std::move(thread));
+    }
+    threads.clear();
+
+    cache.setMaxIdleThreads(1);
+    EXPECT_LE(cache.idleThreads(), 1u);
+
+    cache.clear();
+    EXPECT_EQ(cache.idleThreads(), 0u);
+
+    cache.setMaxIdleThreads(oldMax);
+}
+
 int main(int argc, char **argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
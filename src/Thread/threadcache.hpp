@@ -0,0 +1,374 @@
+#pragma once
+
+#include <utils/object.hpp>
+
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+// 原生线程封装：支持自定义栈大小，析构时自动 join（行为类似 std::jthread）
+class NativeThread : noncopyable
+{
+public:
+    using Function = std::function<void()>;
+
+    NativeThread() = default;
+
+    ~NativeThread() { join(); }
+
+    bool start(Function func, size_t stackSize = 0)
+    {
+        if (joinable() || !func) {
+            return false;
+        }
+
+#ifdef _WIN32
+        // Windows 下退化为 std::thread，使用默认栈大小
+        try {
+            m_thread = std::thread(std::move(func));
+        } catch (...) {
+            return false;
+        }
+        return true;
+#else
+        auto *payload = new Function(std::move(func));
+
+        pthread_attr_t attr;
+        if (pthread_attr_init(&attr) != 0) {
+            delete payload;
+            return false;
+        }
+        if (stackSize > 0) {
+            pthread_attr_setstacksize(&attr, normalizeStackSize(stackSize));
+        }
+
+        int rc = pthread_create(&m_handle, &attr, &NativeThread::entry, payload);
+        pthread_attr_destroy(&attr);
+        if (rc != 0) {
+            delete payload;
+            return false;
+        }
+
+        m_joinable = true;
+        return true;
+#endif
+    }
+
+    void join()
+    {
+#ifdef _WIN32
+        if (m_thread.joinable() && m_thread.get_id() != std::this_thread::get_id()) {
+            m_thread.join();
+        }
+#else
+        if (m_joinable && !pthread_equal(m_handle, pthread_self())) {
+            pthread_join(m_handle, nullptr);
+            m_joinable = false;
+        }
+#endif
+    }
+
+    [[nodiscard]] bool joinable() const
+    {
+#ifdef _WIN32
+        return m_thread.joinable();
+#else
+        return m_joinable;
+#endif
+    }
+
+    // 设置当前线程在操作系统中可见的名称（Linux 限制为 15 个字符）
+    static void setCurrentName(const std::string &name)
+    {
+#if defined(__APPLE__)
+        pthread_setname_np(name.substr(0, 63).c_str());
+#elif defined(__linux__)
+        pthread_setname_np(pthread_self(), name.substr(0, 15).c_str());
+#else
+        (void) name;
+#endif
+    }
+
+    // 栈大小至少为 PTHREAD_STACK_MIN，并向上对齐到页大小
+    static size_t normalizeStackSize(size_t stackSize)
+    {
+        if (stackSize == 0) {
+            return 0;
+        }
+#ifdef _WIN32
+        return stackSize;
+#else
+        const auto pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        stackSize = std::max<size_t>(stackSize, PTHREAD_STACK_MIN);
+        return (stackSize + pageSize - 1) / pageSize * pageSize;
+#endif
+    }
+
+private:
+#ifdef _WIN32
+    std::thread m_thread;
+#else
+    static void *entry(void *arg)
+    {
+        std::unique_ptr<Function> func(static_cast<Function *>(arg));
+        try {
+            (*func)();
+        } catch (...) {
+            // 异常不能跨越 pthread 边界传播
+        }
+        return nullptr;
+    }
+
+    pthread_t m_handle{};
+    bool m_joinable{false};
+#endif
+};
+
+// 进程级线程缓存：任务结束后线程不退出，而是挂起等待下一次复用，
+// 避免反复 clone/mmap 线程栈的开销
+class ThreadCache : noncopyable
+{
+public:
+    // 一次提交对应的句柄，wait() 相当于 join
+    class Job : noncopyable
+    {
+    public:
+        void wait()
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cond.wait(lock, [this] { return m_done; });
+        }
+
+        [[nodiscard]] bool isDone() const
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_done;
+        }
+
+    private:
+        friend class ThreadCache;
+
+        void finish()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_done = true;
+            }
+            m_cond.notify_all();
+        }
+
+        mutable std::mutex m_mutex;
+        std::condition_variable m_cond;
+        bool m_done{false};
+    };
+
+    using JobPtr = std::shared_ptr<Job>;
+
+    static ThreadCache &instance()
+    {
+        static ThreadCache cache;
+        return cache;
+    }
+
+    ~ThreadCache()
+    {
+        std::vector<std::unique_ptr<Worker>> workers;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+            for (auto *worker : m_idle) {
+                worker->exit = true;
+                worker->cond.notify_one();
+            }
+            m_idle.clear();
+            workers = std::move(m_workers);
+            for (auto &worker : m_retired) {
+                workers.push_back(std::move(worker));
+            }
+            m_retired.clear();
+        }
+
+        // 正在执行任务的线程完成后会自行退出
+        for (auto &worker : workers) {
+            worker->thread.join();
+        }
+    }
+
+    // 在缓存线程上执行 func；没有栈大小匹配的空闲线程时创建新线程，失败返回 nullptr
+    JobPtr run(NativeThread::Function func, size_t stackSize = 0)
+    {
+        reapRetired();
+
+        auto job = std::make_shared<Job>();
+        stackSize = NativeThread::normalizeStackSize(stackSize);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_stopping || !func) {
+            return nullptr;
+        }
+
+        auto it = std::find_if(m_idle.rbegin(), m_idle.rend(), [stackSize](const Worker *worker) {
+            return worker->stackSize == stackSize;
+        });
+        if (it != m_idle.rend()) {
+            Worker *worker = *it;
+            m_idle.erase(std::next(it).base());
+            worker->func = std::move(func);
+            worker->job = job;
+            worker->cond.notify_one();
+            return job;
+        }
+
+        auto worker = std::make_unique<Worker>();
+        worker->stackSize = stackSize;
+        worker->func = std::move(func);
+        worker->job = job;
+
+        Worker *raw = worker.get();
+        if (!raw->thread.start([this, raw] { workerLoop(raw); }, stackSize)) {
+            return nullptr;
+        }
+        m_workers.push_back(std::move(worker));
+        return job;
+    }
+
+    // 设置最多保留的空闲线程数，超出的线程执行完任务后直接退出
+    void setMaxIdleThreads(size_t maxIdle)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_maxIdle = maxIdle;
+        }
+        trimIdle(maxIdle);
+    }
+
+    [[nodiscard]] size_t maxIdleThreads() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_maxIdle;
+    }
+
+    [[nodiscard]] size_t idleThreads() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_idle.size();
+    }
+
+    // 结束所有空闲线程
+    void clear() { trimIdle(0); }
+
+private:
+    ThreadCache() = default;
+
+    struct Worker
+    {
+        NativeThread thread;
+        size_t stackSize{0};
+        std::condition_variable cond;
+        NativeThread::Function func;
+        JobPtr job;
+        bool exit{false};
+    };
+
+    void workerLoop(Worker *worker)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true) {
+            worker->cond.wait(lock, [worker] { return worker->func || worker->exit; });
+            if (!worker->func) {
+                return; // 由 trimIdle / 析构函数负责 join
+            }
+
+            auto func = std::move(worker->func);
+            worker->func = nullptr;
+            auto job = std::move(worker->job);
+            lock.unlock();
+
+            try {
+                func();
+            } catch (...) {
+            }
+            NativeThread::setCurrentName("ThreadCache");
+
+            lock.lock();
+            // 先挂回空闲列表再通知完成，保证 wait() 返回后线程已可复用
+            bool park = !m_stopping && m_idle.size() < m_maxIdle;
+            if (park) {
+                m_idle.push_back(worker);
+            }
+            job->finish();
+
+            if (!park) {
+                retire(worker);
+                return;
+            }
+        }
+    }
+
+    // 调用方持有 m_mutex
+    void retire(Worker *worker)
+    {
+        auto it = std::find_if(m_workers.begin(), m_workers.end(), [worker](const auto &ptr) {
+            return ptr.get() == worker;
+        });
+        if (it != m_workers.end()) {
+            m_retired.push_back(std::move(*it));
+            m_workers.erase(it);
+        }
+    }
+
+    void reapRetired()
+    {
+        std::vector<std::unique_ptr<Worker>> retired;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            retired.swap(m_retired);
+        }
+        for (auto &worker : retired) {
+            worker->thread.join();
+        }
+    }
+
+    void trimIdle(size_t keep)
+    {
+        std::vector<std::unique_ptr<Worker>> exiting;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            while (m_idle.size() > keep) {
+                Worker *worker = m_idle.front();
+                m_idle.erase(m_idle.begin());
+                worker->exit = true;
+                worker->cond.notify_one();
+
+                auto it = std::find_if(m_workers.begin(),
+                                       m_workers.end(),
+                                       [worker](const auto &ptr) { return ptr.get() == worker; });
+                if (it != m_workers.end()) {
+                    exiting.push_back(std::move(*it));
+                    m_workers.erase(it);
+                }
+            }
+        }
+        for (auto &worker : exiting) {
+            worker->thread.join();
+        }
+        reapRetired();
+    }
+
+    mutable std::mutex m_mutex;
+    std::vector<std::unique_ptr<Worker>> m_workers; // 所有存活线程
+    std::vector<Worker *> m_idle;                   // 挂起等待复用的线程
+    std::vector<std::unique_ptr<Worker>> m_retired; // 已退出、等待 join 的线程
+    size_t m_maxIdle{std::max(1U, std::thread::hardware_concurrency())};
+    bool m_stopping{false};
+};
@@ -2,14 +2,50 @@
 
 #include "thread.hpp"
 
+#include <algorithm>
 #include <future>
+#include <iterator>
+#include <memory>
 #include <queue>
+#include <vector>
 
 class ThreadPool : noncopyable
 {
 public:
     using Task = Thread::Task; // 统一使用 Thread::Task 类型
 
+    // 阻塞区域守卫：工作线程即将阻塞（IO、等待 future 等）时创建，
+    // 线程池会临时补充一个工作线程，保证可运行的线程数不低于核心线程数。
+    // 在非本线程池的线程中创建时不做任何事；同一线程内嵌套时只有最外层生效
+    class BlockingRegion : noncopyable
+    {
+    public:
+        explicit BlockingRegion(ThreadPool &pool)
+            : m_inWorker(t_currentPool == &pool)
+        {
+            if (m_inWorker && t_blockingDepth++ == 0) {
+                m_pool = &pool;
+                m_pool->beginBlocking();
+            }
+        }
+
+        ~BlockingRegion()
+        {
+            if (m_inWorker) {
+                --t_blockingDepth;
+            }
+            if (m_pool) {
+                m_pool->endBlocking();
+            }
+        }
+
+        [[nodiscard]] bool isActive() const { return m_pool != nullptr; }
+
+    private:
+        ThreadPool *m_pool{nullptr};
+        bool m_inWorker;
+    };
+
     explicit ThreadPool(size_t threadCount = std::thread::hardware_concurrency(),
                         size_t maxQueueSize = 1000)
         : m_maxQueueSize(maxQueueSize == 0 ? 1 : maxQueueSize)
@@ -21,6 +57,7 @@ public:
         initializeWorkers(threadCount);
     }
 
+    // shutdownNow 总会回收剩余的工作线程，包括 drain/shutdown 超时后仍在执行任务的线程
     ~ThreadPool() { shutdownNow(); }
 
     // 提交任务（无返回值）
@@ -46,6 +83,19 @@ public:
                               std::chrono::duration_cast<std::chrono::milliseconds>(timeout));
     }
 
+    // 提交会阻塞的任务，整个任务都运行在阻塞区域内
+    template<typename F>
+    auto submitBlocking(F &&task) -> bool
+    {
+        return submit([this, func = std::forward<F>(task)](std::stop_token token) mutable {
+            BlockingRegion region(*this);
+            func(token);
+        });
+    }
+
+    // 在任务内部即将阻塞时调用：auto region = pool.blockingRegion();
+    [[nodiscard]] auto blockingRegion() -> BlockingRegion { return BlockingRegion(*this); }
+
     // 提交接受 stop_token 的任务并返回 future
     template<typename F, typename... Args>
     auto submitFuture(F &&f, Args &&...args)
@@ -105,44 +155,39 @@ public:
         m_condEmpty.notify_all();
         m_condFull.notify_all();
 
-        // 停止所有工作线程
-        for (auto &worker : m_workers) {
-            if (worker->isJoinable()) {
-                worker->requestStop();
-            }
-        }
-
-        // 等待所有工作线程结束
-        for (auto &worker : m_workers) {
-            if (worker->isJoinable()) {
-                worker->waitForFinished(std::chrono::seconds(5));
-            }
-        }
+        // 停止所有工作线程，总共最多等待 5 秒
+        stopWorkers(std::chrono::steady_clock::now() + std::chrono::seconds(5));
 
-        // 清空任务队列
+        // 清空任务队列，超时后仍在执行的任务结束时还会各自减一次计数
         {
             std::lock_guard<std::mutex> lock(m_mutex);
             std::queue<Task>().swap(m_taskQueue);
-            m_totalTasks = 0;
-            m_runningTasks = 0;
+            m_totalTasks = m_runningTasks;
         }
 
         m_condAllDone.notify_all();
     }
 
     // 立即关闭 - 丢弃未执行的任务
+    // 已经 shutdown/drain 过也会继续执行：取走剩下的工作线程并等待它们全部退出，
+    // 返回后不再有线程引用本线程池
     void shutdownNow()
     {
+        Workers workers;
         {
             std::lock_guard<std::mutex> lock(m_mutex);
-            if (m_stop) {
-                return;
-            }
             m_stop = true;
 
             // 清空任务队列
             std::queue<Task>().swap(m_taskQueue);
-            m_totalTasks = 0;
+            m_totalTasks = m_runningTasks;
+
+            workers = std::move(m_workers);
+            workers.insert(workers.end(),
+                           std::make_move_iterator(m_spareWorkers.begin()),
+                           std::make_move_iterator(m_spareWorkers.end()));
+            m_workers.clear();
+            m_spareWorkers.clear();
         }
 
         // 通知所有条件变量
@@ -150,38 +195,74 @@ public:
         m_condFull.notify_all();
         m_condAllDone.notify_all();
 
-        // 停止所有工作线程
-        for (auto &worker : m_workers) {
-            if (worker->isJoinable()) {
-                worker->requestStop();
+        // 总共最多等待 3 秒，之后继续等待不响应停止请求的任务结束
+        if (!stopWorkers(workers, std::chrono::steady_clock::now() + std::chrono::seconds(3))) {
+            for (auto &worker : workers) {
+                worker->stop();
             }
         }
+    }
 
-        // 等待工作线程结束（带超时）
-        for (auto &worker : m_workers) {
-            if (worker->isJoinable()) {
-                if (!worker->waitForFinished(std::chrono::seconds(3))) {
-                    // 超时，强制停止
-                    worker->stop();
-                }
+    // 结构化关闭：停止接收新任务，在截止时间前继续执行队列中的任务，
+    // 截止时间到达后取消剩余任务并返回给调用方。
+    // 仍在执行的任务会收到停止请求；不响应 stop_token 的任务不会阻塞 drain 返回，
+    // 其工作线程在析构或 restart 时回收。
+    auto drain(std::chrono::steady_clock::time_point deadline) -> std::vector<Task>
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (m_stop || m_draining) {
+                return {};
             }
+            m_draining = true;
         }
 
-        m_workers.clear();
+        // 唤醒阻塞在队列已满上的提交者，让它们返回 false
+        m_condFull.notify_all();
+
+        std::vector<Task> unexecuted;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condAllDone.wait_until(lock, deadline, [this]() {
+                return m_stop || (m_taskQueue.empty() && m_runningTasks == 0);
+            });
+
+            m_stop = true;
+            unexecuted.reserve(m_taskQueue.size());
+            while (!m_taskQueue.empty()) {
+                unexecuted.push_back(std::move(m_taskQueue.front()));
+                m_taskQueue.pop();
+            }
+            m_totalTasks = m_runningTasks;
+        }
+
+        m_condEmpty.notify_all();
+        m_condFull.notify_all();
+        m_condAllDone.notify_all();
+
+        stopWorkers(deadline);
+
+        return unexecuted;
+    }
+
+    template<typename Rep, typename Period>
+    auto drain(const std::chrono::duration<Rep, Period> &timeout) -> std::vector<Task>
+    {
+        return drain(std::chrono::steady_clock::now()
+                     + std::chrono::duration_cast<std::chrono::steady_clock::duration>(timeout));
     }
 
     // 重启线程池
     bool restart(size_t threadCount = std::thread::hardware_concurrency())
     {
-        // 先关闭
+        // 先关闭，旧的工作线程全部退出后计数自然回到 0，不需要再手动清零
         shutdownNow();
 
         // 重置状态
         {
             std::lock_guard<std::mutex> lock(m_mutex);
             m_stop = false;
-            m_runningTasks = 0;
-            m_totalTasks = 0;
+            m_draining = false;
         }
 
         // 创建新的工作线程
@@ -201,7 +282,17 @@ public:
         return m_stop;
     }
 
-    [[nodiscard]] auto size() const -> size_t { return m_workers.size(); }
+    [[nodiscard]] auto isDraining() const -> bool
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_draining && !m_stop;
+    }
+
+    [[nodiscard]] auto size() const -> size_t
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_workers.size();
+    }
 
     [[nodiscard]] auto queueSize() const -> size_t
     {
@@ -233,6 +324,30 @@ public:
         return m_totalTasks;
     }
 
+    // 当前处于阻塞区域内的工作线程数
+    [[nodiscard]] auto getBlockedWorkers() const -> size_t
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_blockedWorkers;
+    }
+
+    // 当前存活的补偿线程数
+    [[nodiscard]] auto getCompensationThreads() const -> size_t
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_spareThreads;
+    }
+
+    // 设置补偿线程数上限，0 表示禁用补偿
+    void setMaxCompensationThreads(size_t maxThreads)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_maxSpareThreads = maxThreads;
+        }
+        m_condEmpty.notify_all();
+    }
+
     // 设置最大队列大小
     void setMaxQueueSize(size_t maxSize)
     {
@@ -244,12 +359,14 @@ public:
     }
 
 private:
+    // 工作线程可能同时被 shutdownNow 取走、被 stopWorkers 等待，用 shared_ptr 保证等待期间对象存活
+    using Workers = std::vector<std::shared_ptr<Thread>>;
+
     bool initializeWorkers(size_t threadCount)
     {
         try {
-            m_workers.clear();
             for (size_t i = 0; i < threadCount; ++i) {
-                auto worker = std::make_unique<Thread>(
+                auto worker = std::make_shared<Thread>(
                     [this](std::stop_token token) { workerThread(token); });
 
                 if (!worker->start()) {
@@ -257,6 +374,7 @@ private:
                     return false;
                 }
 
+                std::lock_guard<std::mutex> lock(m_mutex);
                 m_workers.push_back(std::move(worker));
             }
             return true;
@@ -266,13 +384,104 @@ private:
         }
     }
 
+    // 等待当前所有工作线程（含补偿线程）；调用前 m_stop 已置位，不会再创建补偿线程
+    bool stopWorkers(std::chrono::steady_clock::time_point deadline)
+    {
+        Workers workers;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            workers = m_workers;
+            workers.insert(workers.end(), m_spareWorkers.begin(), m_spareWorkers.end());
+        }
+        return stopWorkers(workers, deadline);
+    }
+
+    // 先向所有工作线程发出停止请求，再以同一个截止时间并行等待，
+    // 总耗时不随线程数线性增长。返回是否全部在截止时间前结束
+    static bool stopWorkers(const Workers &workers, std::chrono::steady_clock::time_point deadline)
+    {
+        for (const auto &worker : workers) {
+            if (worker->isJoinable()) {
+                worker->requestStop();
+            }
+        }
+
+        bool allStopped = true;
+        for (const auto &worker : workers) {
+            if (!worker->isJoinable()) {
+                continue;
+            }
+            auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+                deadline - std::chrono::steady_clock::now());
+            if (!worker->waitForFinished(std::max(remaining, std::chrono::milliseconds(0)))) {
+                allStopped = false;
+            }
+        }
+        return allStopped;
+    }
+
+    // 可运行线程数 = 核心线程 + 补偿线程 - 阻塞线程，低于核心线程数时补充
+    // join 与创建线程都在锁外进行，不让其他工作线程在 m_mutex 上等待
+    void beginBlocking()
+    {
+        Workers exited; // 析构时 join，必须在释放 m_mutex 之后
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            ++m_blockedWorkers;
+            if (m_stop) {
+                return;
+            }
+
+            // 取出已经退出的补偿线程
+            auto running = std::partition(m_spareWorkers.begin(),
+                                          m_spareWorkers.end(),
+                                          [](const auto &worker) { return !worker->isStopped(); });
+            exited.assign(std::make_move_iterator(running),
+                          std::make_move_iterator(m_spareWorkers.end()));
+            m_spareWorkers.erase(running, m_spareWorkers.end());
+
+            if (m_spareThreads >= m_blockedWorkers || m_spareThreads >= m_maxSpareThreads) {
+                return;
+            }
+            // 先占住名额，避免并发的 beginBlocking 超额创建
+            ++m_spareThreads;
+        }
+
+        // 补偿线程从 ThreadCache 中唤醒挂起的线程，避免反复创建
+        auto worker = std::make_shared<Thread>(
+            [this](std::stop_token token) { workerThread(token, true); });
+        worker->setUseThreadCache(true);
+        const bool started = worker->start();
+
+        // 启动后的线程退出时自行归还名额；在此期间关闭的线程池会在析构或 restart 时回收它
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (started) {
+            m_spareWorkers.push_back(std::move(worker));
+        } else {
+            --m_spareThreads;
+        }
+    }
+
+    void endBlocking()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            --m_blockedWorkers;
+        }
+        // 唤醒空闲的补偿线程，让多余的线程退出
+        m_condEmpty.notify_all();
+    }
+
+    // 调用方持有 m_mutex
+    [[nodiscard]] bool hasSurplusSpare() const { return m_spareThreads > m_blockedWorkers; }
+
     template<typename F>
     bool submitInternal(F &&task, bool nonBlocking, std::chrono::milliseconds timeout)
     {
         // 快速检查是否已停止
         {
             std::lock_guard<std::mutex> lock(m_mutex);
-            if (m_stop) {
+            if (m_stop || m_draining) {
                 return false;
             }
         }
@@ -288,19 +497,19 @@ private:
                 if (timeout.count() > 0) {
                     // 带超时等待
                     if (!m_condFull.wait_for(lock, timeout, [this]() {
-                            return m_stop || m_taskQueue.size() < m_maxQueueSize;
+                            return m_stop || m_draining || m_taskQueue.size() < m_maxQueueSize;
                         })) {
                         return false; // 超时
                     }
                 } else {
                     // 无限等待
                     m_condFull.wait(lock, [this]() {
-                        return m_stop || m_taskQueue.size() < m_maxQueueSize;
+                        return m_stop || m_draining || m_taskQueue.size() < m_maxQueueSize;
                     });
                 }
             }
 
-            if (m_stop) {
+            if (m_stop || m_draining) {
                 return false;
             }
 
@@ -311,8 +520,10 @@ private:
         return true;
     }
 
-    void workerThread(std::stop_token token)
+    void workerThread(std::stop_token token, bool spare = false)
     {
+        t_currentPool = this;
+
         while (true) {
             Task task;
 
@@ -320,12 +531,17 @@ private:
                 std::unique_lock<std::mutex> lock(m_mutex);
 
                 // 等待任务或停止信号
-                m_condEmpty.wait(lock, [this, &token]() {
-                    return !m_taskQueue.empty() || m_stop || token.stop_requested();
+                m_condEmpty.wait(lock, [this, &token, spare]() {
+                    return !m_taskQueue.empty() || m_stop || token.stop_requested()
+                           || (spare && hasSurplusSpare());
                 });
 
-                // 检查停止条件
-                if (m_stop || token.stop_requested()) {
+                // 检查停止条件；阻塞的线程已恢复时，多余的补偿线程退出。
+                // 补偿线程无论因何退出都在这里归还计数，restart 时不需要手动清零
+                if (m_stop || token.stop_requested() || (spare && hasSurplusSpare())) {
+                    if (spare) {
+                        --m_spareThreads;
+                    }
                     break;
                 }
 
@@ -365,20 +581,33 @@ private:
                 }
             }
         }
+
+        t_currentPool = nullptr;
     }
 
 private:
-    std::vector<std::unique_ptr<Thread>> m_workers;
-    std::queue<Task> m_taskQueue;
+    // 当前线程所属的线程池及阻塞区域嵌套深度
+    static inline thread_local ThreadPool *t_currentPool = nullptr;
+    static inline thread_local int t_blockingDepth = 0;
 
     // 所有状态变量都用 mutex 保护
     mutable std::mutex m_mutex;
     bool m_stop{false};
+    bool m_draining{false}; // drain 期间不再接收新任务，但继续执行队列中的任务
     size_t m_maxQueueSize;
     size_t m_runningTasks{0};
     size_t m_totalTasks{0};
+    size_t m_blockedWorkers{0};
+    size_t m_spareThreads{0};
+    size_t m_maxSpareThreads{256};
 
     std::condition_variable m_condEmpty;
     std::condition_variable m_condFull;
     std::condition_variable m_condAllDone;
+
+    // 成员按声明的逆序析构，工作线程必须声明在 mutex 与条件变量之后，
+    // 保证万一还有线程存活时，它们先于同步对象被 join
+    std::queue<Task> m_taskQueue;
+    Workers m_workers;
+    Workers m_spareWorkers; // 补偿线程
 };
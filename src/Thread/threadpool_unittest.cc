@@ -2,6 +2,8 @@
 
 #include <gtest/gtest.h>
 
+#include <latch>
+
 using namespace std::chrono_literals;
 
 class ThreadPoolTest : public ::testing::Test
@@ -703,6 +705,272 @@ TEST_F(ThreadPoolTest, TaskArgumentPassing)
     EXPECT_EQ(future.get(), "test42");
 }
 
+// 测试 drain：截止时间内完成所有排队任务
+TEST_F(ThreadPoolTest, DrainCompletesQueuedTasks)
+{
+    pool = std::make_unique<ThreadPool>(2);
+    std::atomic<int> completedTasks{0};
+    const int taskCount = 10;
+
+    for (int i = 0; i < taskCount; ++i) {
+        pool->submit([&completedTasks](std::stop_token) {
+            std::this_thread::sleep_for(10ms);
+            completedTasks++;
+        });
+    }
+
+    auto unexecuted = pool->drain(2s);
+
+    EXPECT_TRUE(unexecuted.empty());
+    EXPECT_EQ(completedTasks, taskCount);
+    EXPECT_TRUE(pool->isStopped());
+    EXPECT_EQ(pool->getTotalTasks(), 0u);
+}
+
+// 测试 drain：超过截止时间后返回未执行的任务
+TEST_F(ThreadPoolTest, DrainReturnsUnexecutedTasks)
+{
+    pool = std::make_unique<ThreadPool>(1);
+    std::atomic<int> completedTasks{0};
+    std::atomic<bool> cancelled{false};
+
+    // 第一个任务占住唯一的工作线程，直到收到停止请求
+    pool->submit([&cancelled](std::stop_token token) {
+        while (!token.stop_requested()) {
+            std::this_thread::sleep_for(1ms);
+        }
+        cancelled = true;
+    });
+    for (int i = 0; i < 5; ++i) {
+        pool->submit([&completedTasks](std::stop_token) { completedTasks++; });
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    auto unexecuted = pool->drain(100ms);
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start);
+
+    EXPECT_EQ(unexecuted.size(), 5u);
+    EXPECT_EQ(completedTasks, 0);
+    EXPECT_LE(duration.count(), 500);
+
+    // 返回的任务可由调用方自行执行
+    for (auto &task : unexecuted) {
+        task(std::stop_token());
+    }
+    EXPECT_EQ(completedTasks, 5);
+
+    // 正在执行的任务已收到停止请求，销毁线程池时回收其工作线程
+    pool.reset();
+    EXPECT_TRUE(cancelled);
+}
+
+// 测试 drain 期间拒绝新任务
+TEST_F(ThreadPoolTest, DrainRejectsNewTasks)
+{
+    pool = std::make_unique<ThreadPool>(1);
+    std::promise<void> started;
+    std::promise<void> release;
+    auto releaseFuture = release.get_future();
+
+    pool->submit([&started, &releaseFuture](std::stop_token) {
+        started.set_value();
+        releaseFuture.wait();
+    });
+    started.get_future().wait();
+
+    auto drained = std::async(std::launch::async, [this] { return pool->drain(2s); });
+
+    // 等待进入 drain 状态
+    while (!pool->isDraining() && !pool->isStopped()) {
+        std::this_thread::sleep_for(1ms);
+    }
+    EXPECT_FALSE(pool->submit([](std::stop_token) {}));
+
+    release.set_value();
+    EXPECT_TRUE(drained.get().empty());
+    EXPECT_TRUE(pool->isStopped());
+
+    // drain 之后可以重启
+    EXPECT_TRUE(pool->restart(2));
+    std::atomic<int> counter{0};
+    pool->submit([&counter](std::stop_token) { counter++; });
+    pool->waitAll();
+    EXPECT_EQ(counter, 1);
+}
+
+// 测试 drain 后遗留的任务不响应停止请求：restart 先等它结束再重置计数，计数不会下溢
+TEST_F(ThreadPoolTest, RestartAfterDrainJoinsStubbornTask)
+{
+    pool = std::make_unique<ThreadPool>(1);
+    std::promise<void> started;
+    std::promise<void> release;
+    auto releaseFuture = release.get_future().share();
+    std::atomic<bool> finished{false};
+
+    pool->submit([&started, releaseFuture, &finished](std::stop_token) {
+        started.set_value();
+        releaseFuture.wait();
+        finished = true;
+    });
+    started.get_future().wait();
+
+    EXPECT_TRUE(pool->drain(20ms).empty());
+    EXPECT_TRUE(pool->isStopped());
+    EXPECT_EQ(pool->getRunningTasks(), 1u);
+
+    auto releaser = std::async(std::launch::async, [&release] {
+        std::this_thread::sleep_for(50ms);
+        release.set_value();
+    });
+    EXPECT_TRUE(pool->restart(2));
+    EXPECT_TRUE(finished);
+    EXPECT_EQ(pool->getRunningTasks(), 0u);
+    EXPECT_EQ(pool->getTotalTasks(), 0u);
+    releaser.get();
+
+    std::atomic<int> counter{0};
+    for (int i = 0; i < 4; ++i) {
+        pool->submit([&counter](std::stop_token) { counter++; });
+    }
+    pool->waitAll();
+    EXPECT_EQ(counter, 4);
+    EXPECT_EQ(pool->getTotalTasks(), 0u);
+}
+
+// 测试析构时等待 drain 后仍在执行、且不响应停止请求的任务
+TEST_F(ThreadPoolTest, DestructorJoinsWorkersAfterDrain)
+{
+    pool = std::make_unique<ThreadPool>(2);
+    std::promise<void> started;
+    std::atomic<bool> finished{false};
+
+    pool->submit([&started, &finished](std::stop_token) {
+        started.set_value();
+        std::this_thread::sleep_for(100ms);
+        finished = true;
+    });
+    started.get_future().wait();
+
+    EXPECT_TRUE(pool->drain(10ms).empty());
+    pool.reset();
+    EXPECT_TRUE(finished);
+}
+
+// 测试多线程关闭时并行等待，总时间不随线程数增长
+TEST_F(ThreadPoolTest, ShutdownWaitsInParallel)
+{
+    pool = std::make_unique<ThreadPool>(8);
+    for (int i = 0; i < 8; ++i) {
+        pool->submit([](std::stop_token token) {
+            for (int j = 0; j < 20 && !token.stop_requested(); ++j) {
+                std::this_thread::sleep_for(5ms);
+            }
+            std::this_thread::sleep_for(50ms);
+        });
+    }
+    std::this_thread::sleep_for(20ms);
+
+    auto start = std::chrono::steady_clock::now();
+    pool->shutdownNow();
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start);
+
+    EXPECT_TRUE(pool->isStopped());
+    EXPECT_LE(duration.count(), 300); // 串行等待需要 8 * 50ms 以上
+}
+
+// 测试阻塞区域：唯一的工作线程阻塞时补偿线程继续执行队列中的任务
+TEST_F(ThreadPoolTest, BlockingRegionCompensates)
+{
+    pool = std::make_unique<ThreadPool>(1);
+    std::promise<int> producer;
+    auto consumerResult = std::make_shared<std::atomic<int>>(0);
+
+    // 任务 A 等待任务 B 的结果；没有补偿时单线程线程池会饿死
+    pool->submit([this, &producer, consumerResult](std::stop_token) {
+        auto future = producer.get_future();
+        auto region = pool->blockingRegion();
+        EXPECT_TRUE(region.isActive());
+        if (future.wait_for(2s) == std::future_status::ready) {
+            *consumerResult = future.get();
+        }
+    });
+    pool->submit([&producer](std::stop_token) { producer.set_value(42); });
+
+    EXPECT_TRUE(pool->waitAllFor(3s));
+    EXPECT_EQ(consumerResult->load(), 42);
+    EXPECT_EQ(pool->getBlockedWorkers(), 0u);
+
+    // 阻塞结束后多余的补偿线程会退出
+    for (int i = 0; i < 100 && pool->getCompensationThreads() > 0; ++i) {
+        std::this_thread::sleep_for(5ms);
+    }
+    EXPECT_EQ(pool->getCompensationThreads(), 0u);
+}
+
+// 测试 submitBlocking 与嵌套阻塞区域
+TEST_F(ThreadPoolTest, SubmitBlocking)
+{
+    pool = std::make_unique<ThreadPool>(2);
+    std::latch allBlocked(2);
+    std::promise<void> release;
+    auto releaseFuture = release.get_future().share();
+    std::atomic<int> quickTasks{0};
+
+    for (int i = 0; i < 2; ++i) {
+        pool->submitBlocking([this, &allBlocked, releaseFuture](std::stop_token) {
+            auto nested = pool->blockingRegion(); // 嵌套区域不重复计数
+            EXPECT_FALSE(nested.isActive());
+            allBlocked.count_down();
+            releaseFuture.wait();
+        });
+    }
+    allBlocked.wait();
+    EXPECT_EQ(pool->getBlockedWorkers(), 2u);
+
+    for (int i = 0; i < 10; ++i) {
+        pool->submit([&quickTasks](std::stop_token) { quickTasks++; });
+    }
+    for (int i = 0; i < 200 && quickTasks < 10; ++i) {
+        std::this_thread::sleep_for(5ms);
+    }
+    EXPECT_EQ(quickTasks, 10); // 两个核心线程都阻塞时仍能执行新任务
+    EXPECT_GE(pool->getCompensationThreads(), 1u);
+    EXPECT_LE(pool->getCompensationThreads(), 2u);
+
+    release.set_value();
+    pool->waitAll();
+    EXPECT_EQ(pool->getBlockedWorkers(), 0u);
+}
+
+// 测试在非工作线程中创建阻塞区域不产生补偿
+TEST_F(ThreadPoolTest, BlockingRegionOutsidePool)
+{
+    pool = std::make_unique<ThreadPool>(1);
+    {
+        auto region = pool->blockingRegion();
+        EXPECT_FALSE(region.isActive());
+        EXPECT_EQ(pool->getBlockedWorkers(), 0u);
+    }
+    EXPECT_EQ(pool->getCompensationThreads(), 0u);
+
+    // 禁用补偿后阻塞区域只计数，不创建线程
+    pool->setMaxCompensationThreads(0);
+    std::promise<void> release;
+    auto releaseFuture = release.get_future();
+    std::promise<void> blocked;
+    pool->submitBlocking([&blocked, &releaseFuture](std::stop_token) {
+        blocked.set_value();
+        releaseFuture.wait();
+    });
+    blocked.get_future().wait();
+    EXPECT_EQ(pool->getBlockedWorkers(), 1u);
+    EXPECT_EQ(pool->getCompensationThreads(), 0u);
+    release.set_value();
+    pool->waitAll();
+}
+
 int main(int argc, char **argv)
 {
     ::testing::InitGoogleTest(&argc, argv);
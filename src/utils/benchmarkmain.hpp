@@ -0,0 +1,50 @@
+#pragma once
+
+#include <benchmark/benchmark.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace Utils {
+
+// 运行所有 benchmark；未指定 --benchmark_out 时默认以 JSON 格式输出到 defaultOut，
+// 便于用 benchmark 自带的 tools/compare.py 跨提交对比性能。
+// 指定的输出文件以 .csv 结尾且未指定格式时改用 CSV，方便直接导入表格或绘图工具
+inline int runBenchmarks(int argc, char **argv, const std::string &defaultOut)
+{
+    std::vector<char *> args(argv, argv + argc);
+    std::string outArg = "--benchmark_out=" + defaultOut;
+    std::string formatArg = "--benchmark_out_format=json";
+
+    const char *out = nullptr;
+    bool hasFormat = false;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], "--benchmark_out=", 16) == 0) {
+            out = argv[i] + 16;
+        } else if (std::strncmp(argv[i], "--benchmark_out_format=", 23) == 0) {
+            hasFormat = true;
+        }
+    }
+    if (out == nullptr) {
+        args.push_back(outArg.data());
+        args.push_back(formatArg.data());
+    } else if (!hasFormat) {
+        const size_t length = std::strlen(out);
+        if (length >= 4 && std::strcmp(out + length - 4, ".csv") == 0) {
+            formatArg = "--benchmark_out_format=csv";
+        }
+        args.push_back(formatArg.data());
+    }
+
+    int count = static_cast<int>(args.size());
+    benchmark::Initialize(&count, args.data());
+    if (benchmark::ReportUnrecognizedArguments(count, args.data())) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
+
+} // namespace Utils